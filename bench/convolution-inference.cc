@@ -47,8 +47,9 @@ BENCHMARK_DEFINE_F(NNPACK, conv1x1)(benchmark::State& state) {
 			algorithm, nnp_convolution_transform_strategy_precompute,
 			inputChannels, outputChannels,
 			imageSize2D, imagePadding, kernelSize2D, outputStride2D,
-			NULL, kernel.data(), NULL, NULL, transformedKernel.data(), &transformedKernelSize,
+			NULL, kernel.data(), NULL, NULL, NULL, transformedKernel.data(), &transformedKernelSize,
 			nnp_activation_identity, NULL,
+			nnp_convolution_pooling_none,
 			NULL);
 		assert(status == nnp_status_success);
 
@@ -58,8 +59,9 @@ BENCHMARK_DEFINE_F(NNPACK, conv1x1)(benchmark::State& state) {
 				algorithm, nnp_convolution_transform_strategy_precompute,
 				inputChannels, outputChannels,
 				imageSize2D, imagePadding, kernelSize2D, outputStride2D,
-				NULL, kernel.data(), NULL, NULL, transformedKernel.data(), &transformedKernelSize,
+				NULL, kernel.data(), NULL, NULL, NULL, transformedKernel.data(), &transformedKernelSize,
 				nnp_activation_identity, NULL,
+				nnp_convolution_pooling_none,
 				NULL);
 			assert(status == nnp_status_success);
 			strategy = nnp_convolution_transform_strategy_reuse;
@@ -75,8 +77,9 @@ BENCHMARK_DEFINE_F(NNPACK, conv1x1)(benchmark::State& state) {
 		algorithm, strategy,
 		inputChannels, outputChannels,
 		imageSize2D, imagePadding, kernelSize2D, outputStride2D,
-		NULL, NULL, NULL, NULL, NULL, &workspaceSize,
+		NULL, NULL, NULL, NULL, NULL, NULL, &workspaceSize,
 		nnp_activation_identity, NULL,
+		nnp_convolution_pooling_none,
 		NULL);
 	assert(status == nnp_status_success);
 	workspaceBuffer.resize(workspaceSize);
@@ -90,9 +93,10 @@ BENCHMARK_DEFINE_F(NNPACK, conv1x1)(benchmark::State& state) {
 			imageSize2D, imagePadding, kernelSize2D, outputStride2D,
 			input.data(),
 			transformedKernel.empty() ? kernel.data() : static_cast<float*>(static_cast<void*>(transformedKernel.data())), 
-			bias.data(), output.data(),
+			bias.data(), NULL, output.data(),
 			workspaceBuffer.data(), &workspaceSize,
 			nnp_activation_identity, NULL,
+			nnp_convolution_pooling_none,
 			&profile);
 		assert(status == nnp_status_success);
 
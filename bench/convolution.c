@@ -58,14 +58,15 @@ struct nnp_profile benchmark_convolution(
 	enum nnp_status status = nnp_status_success;
 	void* memory_block = NULL;
 	void* transformed_kernel = NULL;
-	size_t memory_size = 0, transformed_kernel_size = 0;
+	void* transformed_input = NULL;
+	size_t memory_size = 0, transformed_kernel_size = 0, transformed_input_size = 0;
 	switch (mode) {
 		case mode_output:
 			status = nnp_convolution_output(
 				algorithm,
 				batch_size, input_channels, output_channels,
-				input_size, input_padding, kernel_size,
-				NULL, NULL, NULL, NULL, NULL, &memory_size,
+				input_size, input_padding, kernel_size, output_subsampling,
+				NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, &memory_size,
 				nnp_activation_identity, NULL,
 				NULL);
 			break;
@@ -73,17 +74,63 @@ struct nnp_profile benchmark_convolution(
 			status = nnp_convolution_input_gradient(
 				algorithm,
 				batch_size, input_channels, output_channels,
-				input_size, input_padding, kernel_size,
-				NULL, NULL, NULL, NULL, &memory_size,
+				input_size, input_padding, kernel_size, output_subsampling,
+				NULL, NULL, NULL, NULL, NULL, &memory_size,
 				nnp_activation_identity, NULL,
 				NULL);
 			break;
 		case mode_kernel_gradient:
+			if (transform_strategy == nnp_convolution_transform_strategy_precompute) {
+				status = nnp_convolution_output(
+					algorithm,
+					batch_size, input_channels, output_channels,
+					input_size, input_padding, kernel_size, output_subsampling,
+					NULL, NULL, NULL, NULL, NULL, NULL, &transformed_input_size, NULL, NULL,
+					nnp_activation_identity, NULL,
+					NULL);
+				switch (status) {
+					case nnp_status_success:
+						break;
+					case nnp_status_invalid_algorithm:
+					case nnp_status_unsupported_algorithm:
+						return (struct nnp_profile) { nanf("") };
+						break;
+					case nnp_status_unsupported_transform_strategy:
+						/* Fall back to compute strategy */
+						transform_strategy = nnp_convolution_transform_strategy_compute;
+						break;
+					default:
+						fprintf(stderr, "Error: failed to detect transformed input size: status %d\n", status);
+						exit(EXIT_FAILURE);
+				}
+			}
+			if (transform_strategy == nnp_convolution_transform_strategy_precompute) {
+				transformed_input = malloc_with_alignment(transformed_input_size, 64);
+				if (transformed_input == NULL) {
+					fprintf(stderr, "Error: failed to allocate %zu bytes for transformed input\n", transformed_input_size);
+					exit(EXIT_FAILURE);
+				}
+
+				/* Forward pass saves the input transform for the kernel gradient */
+				status = nnp_convolution_output(
+					algorithm,
+					batch_size, input_channels, output_channels,
+					input_size, input_padding, kernel_size, output_subsampling,
+					input, kernel, bias, NULL, output, transformed_input, &transformed_input_size, NULL, NULL,
+					nnp_activation_identity, NULL,
+					NULL);
+				if (status != nnp_status_success) {
+					fprintf(stderr, "Error: failed to pre-compute input transform: status %d\n", status);
+					exit(EXIT_FAILURE);
+				}
+				transform_strategy = nnp_convolution_transform_strategy_reuse;
+			}
+
 			status = nnp_convolution_kernel_gradient(
-				algorithm,
+				algorithm, transform_strategy,
 				batch_size, input_channels, output_channels,
-				input_size, input_padding, kernel_size,
-				NULL, NULL, NULL, NULL, &memory_size,
+				input_size, input_padding, kernel_size, output_subsampling,
+				NULL, NULL, NULL, NULL, false, NULL, &memory_size,
 				nnp_activation_identity, NULL,
 				NULL);
 			break;
@@ -93,8 +140,9 @@ struct nnp_profile benchmark_convolution(
 					algorithm, transform_strategy,
 					input_channels, output_channels,
 					input_size, input_padding, kernel_size, output_subsampling,
-					NULL, NULL, NULL, NULL, NULL, &transformed_kernel_size,
+					NULL, NULL, NULL, NULL, NULL, NULL, &transformed_kernel_size,
 					nnp_activation_identity, NULL,
+					nnp_convolution_pooling_none,
 					NULL);
 				switch (status) {
 					case nnp_status_success:
@@ -123,8 +171,9 @@ struct nnp_profile benchmark_convolution(
 					algorithm, transform_strategy,
 					input_channels, output_channels,
 					input_size, input_padding, kernel_size, output_subsampling,
-					NULL, kernel, NULL, NULL, transformed_kernel, &transformed_kernel_size,
+					NULL, kernel, NULL, NULL, NULL, transformed_kernel, &transformed_kernel_size,
 					nnp_activation_identity, NULL,
+					nnp_convolution_pooling_none,
 					NULL);
 				if (status != nnp_status_success) {
 					fprintf(stderr, "Error: failed to pre-compute kernel transform: status %d\n", status);
@@ -137,8 +186,9 @@ struct nnp_profile benchmark_convolution(
 				algorithm, transform_strategy,
 				input_channels, output_channels,
 				input_size, input_padding, kernel_size, output_subsampling,
-				NULL, NULL, NULL, NULL, NULL, &memory_size,
+				NULL, NULL, NULL, NULL, NULL, NULL, &memory_size,
 				nnp_activation_identity, NULL,
+				nnp_convolution_pooling_none,
 				NULL);
 			break;
 	}
@@ -168,8 +218,8 @@ struct nnp_profile benchmark_convolution(
 				nnp_convolution_output(
 					algorithm,
 					batch_size, input_channels, output_channels,
-					input_size, input_padding, kernel_size,
-					input, kernel, bias, output,
+					input_size, input_padding, kernel_size, output_subsampling,
+					input, kernel, bias, NULL, output, NULL, NULL,
 					memory_block, memory_size == 0 ? NULL : &memory_size,
 					nnp_activation_identity, NULL,
 					&computation_profile[iteration]);
@@ -178,18 +228,18 @@ struct nnp_profile benchmark_convolution(
 				nnp_convolution_input_gradient(
 					algorithm,
 					batch_size, input_channels, output_channels,
-					input_size, input_padding, kernel_size,
-					output, kernel, input,
+					input_size, input_padding, kernel_size, output_subsampling,
+					output, NULL, kernel, input,
 					memory_block, memory_size == 0 ? NULL : &memory_size,
 					nnp_activation_identity, NULL,
 					&computation_profile[iteration]);
 				break;
 			case mode_kernel_gradient:
 				nnp_convolution_kernel_gradient(
-					algorithm,
+					algorithm, transform_strategy,
 					batch_size, input_channels, output_channels,
-					input_size, input_padding, kernel_size,
-					input, output, kernel,
+					input_size, input_padding, kernel_size, output_subsampling,
+					transformed_input == NULL ? input : transformed_input, output, kernel, NULL, false,
 					memory_block, memory_size == 0 ? NULL : &memory_size,
 					nnp_activation_identity, NULL,
 					&computation_profile[iteration]);
@@ -199,9 +249,10 @@ struct nnp_profile benchmark_convolution(
 					algorithm, transform_strategy,
 					input_channels, output_channels,
 					input_size, input_padding, kernel_size, output_subsampling,
-					input, transformed_kernel == NULL ? kernel : transformed_kernel, bias, output,
+					input, transformed_kernel == NULL ? kernel : transformed_kernel, bias, NULL, output,
 					memory_block, memory_size == 0 ? NULL : &memory_size,
 					nnp_activation_identity, NULL,
+					nnp_convolution_pooling_none,
 					&computation_profile[iteration]);
 				break;
 		}
@@ -209,8 +260,10 @@ struct nnp_profile benchmark_convolution(
 
 #ifdef _MSC_VER
 	_aligned_free(memory_block);
+	_aligned_free(transformed_input);
 #else
 	free(memory_block);
+	free(transformed_input);
 #endif // _MSC_VER
 	
 	return median_profile(computation_profile, max_iterations);
@@ -243,8 +296,9 @@ static void print_options_help(const char* program_name) {
 "  -ks  --kernel-size        Kernel height and width\n"
 "Optional parameters:\n"
 "  -m   --mode               The convolution mode (output, inference, input-gradient, kernel-gradient)\n"
-"  -a   --algorithm          The algorithm (auto, ft8x8, ft16x16, wt8x8, implicit-gemm, or direct) for computing convolution (default: auto)\n"
-"  -ts  --transform-strategy The transformation strategy (compute, or precompute) for kernel transformation (default: compute)\n"
+"  -a   --algorithm          The algorithm (auto, ft8x8, ft16x16, ft32x32, wt8x8, implicit-gemm, or direct) for computing convolution (default: auto)\n"
+"  -ts  --transform-strategy The transformation strategy (compute, or precompute) for kernel transformation in inference mode,\n"
+"                            or input transformation (saved by the forward pass) in kernel-gradient mode (default: compute)\n"
 "  -b   --batch              The size of a minibatch (default: 1)\n"
 "  -s   --output-subsampling The size of a output subsampling region, AKA stride (default: 1x1)\n"
 "  -ip  --input-padding      Implicit input padding (default: 0)\n"
@@ -399,6 +453,8 @@ static struct options parse_options(int argc, char** argv) {
 				options.algorithm = nnp_convolution_algorithm_ft8x8;
 			} else if (strcmp(argv[argi + 1], "ft16x16") == 0) {
 				options.algorithm = nnp_convolution_algorithm_ft16x16;
+			} else if (strcmp(argv[argi + 1], "ft32x32") == 0) {
+				options.algorithm = nnp_convolution_algorithm_ft32x32;
 			} else if (strcmp(argv[argi + 1], "wt8x8") == 0) {
 				options.algorithm = nnp_convolution_algorithm_wt8x8;
 			} else if (strcmp(argv[argi + 1], "implicit-gemm") == 0) {
@@ -482,8 +538,8 @@ static struct options parse_options(int argc, char** argv) {
 		fprintf(stderr, "Error: inference requires unit batch size\n");
 		exit(EXIT_FAILURE);
 	}
-	if (options.transform_strategy == nnp_convolution_transform_strategy_precompute && options.mode != mode_inference) {
-		fprintf(stderr, "Error: \"precompute\" transform strategy requires inference mode\n");
+	if (options.transform_strategy == nnp_convolution_transform_strategy_precompute && options.mode != mode_inference && options.mode != mode_kernel_gradient) {
+		fprintf(stderr, "Error: \"precompute\" transform strategy requires inference or kernel-gradient mode\n");
 		exit(EXIT_FAILURE);
 	}
 	if (options.input_channels == 0) {
@@ -554,6 +610,11 @@ int main(int argc, char** argv) {
 			flops_per_element = 4.0;
 			printf("Algorithm: FT16x16\n");
 			break;
+		case nnp_convolution_algorithm_ft32x32:
+			tile_size = (struct nnp_size) { 32, 32 };
+			flops_per_element = 4.0;
+			printf("Algorithm: FT32x32\n");
+			break;
 		case nnp_convolution_algorithm_wt8x8:
 			tile_size = (struct nnp_size) { 8, 8 };
 			flops_per_element = 2.0;
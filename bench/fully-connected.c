@@ -50,17 +50,21 @@ struct nnp_profile benchmark_fully_connected(
 							output_channels,
 							input,
 							kernel,
-							output);
+							NULL,
+							output,
+							nnp_activation_identity,
+							NULL);
 						break;
 					case mode_inference_mixed:
-						/*
 						nnp_fully_connected_inference_f16f32(
 							input_channels,
 							output_channels,
 							input,
 							kernel,
-							output);
-						*/
+							NULL,
+							output,
+							nnp_activation_identity,
+							NULL);
 						break;
 					case mode_output:
 						break;
@@ -84,12 +88,16 @@ struct nnp_profile benchmark_fully_connected(
 			for (size_t iteration = 0; iteration < max_iterations; iteration++) {
 				read_memory(memory, cache_size);
 				nnp_fully_connected_output(
+					nnp_convolution_transform_strategy_compute,
 					batch_size,
 					input_channels,
 					output_channels,
 					input,
 					kernel,
+					NULL,
 					output,
+					nnp_activation_identity,
+					NULL,
 					&computation_profile[iteration]);
 			}
 			return median_profile(computation_profile, max_iterations);
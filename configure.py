@@ -54,6 +54,8 @@ def main(args):
         nnpack_objects = [
             build.cc("init.c"),
             build.cc("convolution-inference.c"),
+            build.cc("convolution-kernel-file.c"),
+            build.cc("convolution-inference-q8.c"),
             build.cxx("pthreadpool.cpp")
         ]
         if not options.convolution_only:
@@ -77,6 +79,7 @@ def main(args):
                 build.cc("convolution-output.c"),
                 build.cc("convolution-input-gradient.c"),
                 build.cc("convolution-kernel-gradient.c"),
+                build.cc("convolution-backward.c"),
             ]
 
         if backend == "x86_64":
@@ -93,6 +96,8 @@ def main(args):
                 build.peachpy("x86_64-fma/blas/conv1x1.py"),
                 # BLAS microkernels
                 build.peachpy("x86_64-fma/blas/sgemm.py"),
+                build.peachpy("x86_64-fma/blas/q8gemm.py"),
+                build.peachpy("x86_64-fma/blas/sgemm-indirect.py"),
             ]
             if not options.convolution_only:
                 arch_nnpack_objects += [
@@ -111,6 +116,7 @@ def main(args):
                 # Transformations
                 build.cc("scalar/2d-fourier-8x8.c"),
                 build.cc("scalar/2d-fourier-16x16.c"),
+                build.cc("scalar/2d-fourier-32x32.c"),
                 build.cc("scalar/2d-winograd-8x8-3x3.c"),
                 # Tuple GEMM
                 build.cc("scalar/blas/s2gemm.c"),
@@ -119,6 +125,8 @@ def main(args):
                 build.cc("scalar/blas/conv1x1.c"),
                 # BLAS microkernels
                 build.cc("scalar/blas/sgemm.c"),
+                build.cc("scalar/blas/q8gemm.c"),
+                build.cc("scalar/blas/sgemm-indirect.c"),
             ]
             if not options.inference_only:
                 arch_nnpack_objects += [
@@ -143,6 +151,7 @@ def main(args):
                     # Transformations
                     build.cc("psimd/2d-fourier-8x8.c"),
                     build.cc("psimd/2d-fourier-16x16.c"),
+                    build.cxx("psimd/2d-fourier-32x32.cpp"),
                     build.cc("neon/2d-winograd-8x8-3x3.c"),
                     build.cc("neon/2d-winograd-8x8-3x3-fp16.c"),
                     # Tuple GEMM
@@ -154,6 +163,8 @@ def main(args):
                     build.cc("neon/blas/conv1x1.c"),
                     # BLAS microkernels
                     build.cc("neon/blas/sgemm.c"),
+                    build.cc("scalar/blas/q8gemm.c"),
+                    build.cc("scalar/blas/sgemm-indirect.c"),
                 ]
                 if not options.inference_only:
                     arch_nnpack_objects += [
@@ -186,6 +197,7 @@ def main(args):
                 # Transformations
                 build.cxx("psimd/2d-fourier-8x8.cpp"),
                 build.cxx("psimd/2d-fourier-16x16.cpp"),
+                build.cxx("psimd/2d-fourier-32x32.cpp"),
                 build.cxx("psimd/2d-winograd-8x8-3x3.cpp"),
                 # Tuple GEMM
                 build.cxx("psimd/blas/s4gemm.cpp"),
@@ -195,6 +207,8 @@ def main(args):
                 build.cxx("psimd/blas/conv1x1.cpp"),
                 # BLAS microkernels
                 build.cxx("psimd/blas/sgemm.cpp"),
+                build.cc("scalar/blas/q8gemm.c"),
+                build.cc("scalar/blas/sgemm-indirect.c"),
             ]
             if not options.inference_only:
                 arch_nnpack_objects += [
@@ -368,6 +382,9 @@ def main(args):
             build.unittest("convolution-kernel-gradient-overfeat-fast-test",
                 reference_layer_objects + [build.cxx("convolution-kernel-gradient/overfeat-fast.cc")])
 
+            build.smoketest("convolution-backward-smoketest",
+                reference_layer_objects + [build.cxx("convolution-backward/smoke.cc")])
+
         build.smoketest("convolution-inference-smoketest",
             reference_layer_objects + [build.cxx("convolution-inference/smoke.cc")])
         build.unittest("convolution-inference-alexnet-test",
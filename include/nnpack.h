@@ -30,6 +30,8 @@ enum nnp_status
 	nnp_status_invalid_input_channels = 4,
 	/** NNPACK function was called with output_channels == 0. */
 	nnp_status_invalid_output_channels = 5,
+	/** NNPACK function was called with non-positive or non-finite requantization scale, or empty output range */
+	nnp_status_invalid_quantization_parameters = 6,
 	/** NNPACK function was called with input_size.height == 0 or input_size.width == 0 */
 	nnp_status_invalid_input_size = 10,
 	/** NNPACK function was called with input_stride.height == 0 or input_stride.width == 0 */
@@ -58,6 +60,10 @@ enum nnp_status
 	nnp_status_invalid_activation = 14,
 	/** NNPACK function was called with invalid activation parameters */
 	nnp_status_invalid_activation_parameters = 15,
+	/** NNPACK function was called with negative or non-finite batch normalization epsilon */
+	nnp_status_invalid_batch_norm_parameters = 18,
+	/** NNPACK function was called with a serialized kernel file of unknown format or version, or for different layer parameters */
+	nnp_status_invalid_kernel_file = 19,
 
 	/** NNPACK does not support the particular input size for the function */
 	nnp_status_unsupported_input_size = 20,
@@ -89,7 +95,9 @@ enum nnp_status
 	/** Scratch space buffer is too small */
 	nnp_status_insufficient_buffer = 53,
 	/** Scratch space buffer is not properly aligned */
-	nnp_status_misaligned_buffer = 54
+	nnp_status_misaligned_buffer = 54,
+	/** NNPACK failed to open, read, write, or map a file */
+	nnp_status_io_error = 55
 };
 
 
@@ -125,6 +133,21 @@ enum nnp_convolution_algorithm {
 	* on non-supported processors falls back to nnp_convolution_algorithm_wt8x8.
 	*/
 	nnp_convolution_algorithm_wt8x8_fp16 = 6,
+	/**
+	* Tiled convolution based on 2D Fourier transform with 32x32 blocks. Supports kernels up to 32x32.
+	* Implemented for the scalar, psimd and NEON backends; not available on x86-64 (nnp_status_unsupported_algorithm).
+	*/
+	nnp_convolution_algorithm_ft32x32 = 7,
+};
+
+/**
+* @brief Pooling fused into the output transform of a convolutional layer.
+*/
+enum nnp_convolution_pooling {
+	/** No pooling, the convolution output is stored at full resolution */
+	nnp_convolution_pooling_none = 0,
+	/** Max-pooling with 2x2 window and 2x2 stride. Output is ceil(height / 2) x ceil(width / 2), as in nnp_max_pooling_output. */
+	nnp_convolution_pooling_max_2x2 = 1,
 };
 
 enum nnp_convolution_transform_strategy {
@@ -178,10 +201,55 @@ struct nnp_profile {
 	double block_multiplication;
 };
 
+/**
+* @brief Execution plan and cost estimate of a convolution inference call, as reported by nnp_convolution_inference_query.
+*/
+struct nnp_convolution_info {
+	/** Algorithm the call uses. nnp_convolution_algorithm_auto is resolved to the algorithm it selects. */
+	enum nnp_convolution_algorithm algorithm;
+	/**
+	 * Size of the workspace buffer the call needs, in bytes. For high-resolution layers, where transforms are fused per
+	 * block of tiles, nnp_convolution_transform_strategy_compute keeps the transformed kernel for all input and output
+	 * channels in the workspace, next to the per-thread transform buffers; pre-computing the kernel transform avoids it.
+	 */
+	size_t workspace_size;
+	/** Size of transform tiles, or zero for algorithms without tiled transforms. */
+	struct nnp_size tile_size;
+	/** Number of tiles per channel, or zero for algorithms without tiled transforms. */
+	size_t tiles_count;
+	/** Maximum number of input channels in a cache block. For implicit GEMM, the number of input channels times kernel elements. */
+	size_t input_channels_block_max;
+	/** Maximum number of tiles in a cache block. For implicit GEMM and direct convolution, the number of output pixels. */
+	size_t tiles_block_max;
+	/** Maximum number of output channels in a cache block. */
+	size_t output_channels_block_max;
+	/** Estimated number of floating-point operations in input, kernel and output transforms. */
+	double transform_flops;
+	/** Estimated number of floating-point operations in matrix multiplication of transformed data. */
+	double gemm_flops;
+	/** Estimated memory traffic, in bytes. */
+	double memory_bytes;
+};
+
 enum nnp_status nnp_initialize();
 
 enum nnp_status nnp_deinitialize();
 
+/**
+* @brief Computes output of a 2D convolutional layer for a batch of images.
+* @details Output subsampling (stride) other than 1x1 is computed image by image with the implicit GEMM or
+*          strided Winograd implementations of nnp_convolution_inference; Fourier algorithms need 1x1 subsampling.
+*          nnp_convolution_algorithm_direct (1x1 kernels only) and nnp_convolution_algorithm_implicit_gemm run the
+*          corresponding nnp_convolution_inference implementation image by image; auto picks direct for 1x1 kernels.
+*          If input_transform_size is not NULL, the Fourier transform of input is also stored in input_transform for
+*          nnp_convolution_kernel_gradient with nnp_convolution_transform_strategy_reuse, so the backward pass skips it.
+*          If input_transform is NULL, the function only stores the required size in input_transform_size.
+*          Saving needs 1x1 subsampling and nnp_convolution_algorithm_ft8x8 or nnp_convolution_algorithm_ft16x16; with
+*          nnp_convolution_algorithm_auto, one of them is picked as in nnp_convolution_kernel_gradient.
+*          On multi-socket x86 machines, a large batch with Fourier or Winograd transforms is split across processor
+*          packages when workspace_buffer and workspace_size are both NULL. Builds with MSVC do not discover packages
+*          and always process the batch as a whole.
+*/
 enum nnp_status nnp_convolution_output(
 	enum nnp_convolution_algorithm algorithm,
 	const size_t batch_size,
@@ -190,16 +258,33 @@ enum nnp_status nnp_convolution_output(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
+	void* input_transform,
+	size_t* input_transform_size,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
 	const void* activation_parameters,
 	struct nnp_profile* profile);
 
+/**
+* @brief Computes gradient of input of a 2D convolutional layer from gradient of output and kernel tensors.
+* @details With output subsampling (stride) other than 1x1, transform-based algorithms expand grad_output with zeros
+*          to the unit-stride output size, which is then processed by the unit-stride algorithm.
+*          nnp_convolution_algorithm_direct (1x1 kernels only) and nnp_convolution_algorithm_implicit_gemm compute the
+*          gradient as a convolution of grad_output with the flipped kernel; with subsampling, they instead multiply
+*          grad_output by the kernel and add the products into grad_input at the strided positions, without zeros.
+*          auto picks direct for 1x1 kernels and implicit GEMM for subsampled layers.
+*          With activation == nnp_activation_relu, grad_output is first back-propagated through the activation, i.e.
+*          masked where the forward output of the layer is not positive. The mask is applied while grad_output tiles
+*          are loaded for the transform, so no separate pass is needed. output is read only in this case, and
+*          must not be NULL then, unless only the workspace size is queried (nnp_status_invalid_activation).
+*/
 enum nnp_status nnp_convolution_input_gradient(
 	enum nnp_convolution_algorithm algorithm,
 	const size_t batch_size,
@@ -208,7 +293,9 @@ enum nnp_status nnp_convolution_input_gradient(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* grad_output,
+	const float* output,
 	const float* kernel,
 	float* grad_input,
 	void* workspace_buffer,
@@ -217,17 +304,59 @@ enum nnp_status nnp_convolution_input_gradient(
 	const void* activation_parameters,
 	struct nnp_profile* profile);
 
+/**
+* @brief Computes gradient of kernel of a 2D convolutional layer from gradient of output and input tensors.
+* @details With accumulate == true, the kernel gradient is added to the contents of grad_kernel instead of
+*          overwriting it, e.g. to sum gradients over micro-batches.
+*          If grad_bias is not NULL, the bias gradient (sum of grad_output over batch and spatial positions,
+*          one value per output channel) is computed in the same pass, and follows the same accumulate mode.
+*          Output subsampling (stride) is handled as in nnp_convolution_input_gradient, except for
+*          nnp_convolution_algorithm_direct (1x1 kernels only) and nnp_convolution_algorithm_implicit_gemm, which
+*          compute a GEMM of grad_output with the unfolded input and skip subsampled positions. auto picks them for
+*          1x1 kernels and subsampled layers respectively.
+*          With input_transform_strategy == nnp_convolution_transform_strategy_reuse, input is the input transform
+*          saved by nnp_convolution_output for the same layer, batch and algorithm.
+*/
 enum nnp_status nnp_convolution_kernel_gradient(
 	const enum nnp_convolution_algorithm algorithm,
+	const enum nnp_convolution_transform_strategy input_transform_strategy,
 	const size_t batch_size,
 	const size_t input_channels,
 	const size_t output_channels,
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* grad_output,
 	float* grad_kernel,
+	float* grad_bias,
+	const bool accumulate,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
+	const void* activation_parameters,
+	struct nnp_profile* profile);
+
+/**
+* @brief Computes both the input gradient and the kernel gradient of a 2D convolutional layer in one pass.
+* @details Equivalent to nnp_convolution_input_gradient followed by nnp_convolution_kernel_gradient, but transforms
+*          grad_output only once and uses it for both tuple GEMMs. Supports nnp_convolution_algorithm_ft8x8 and
+*          nnp_convolution_algorithm_ft16x16; nnp_convolution_algorithm_auto picks between them.
+*/
+enum nnp_status nnp_convolution_backward(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const float* input,
+	const float* grad_output,
+	const float* kernel,
+	float* grad_input,
+	float* grad_kernel,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
@@ -246,28 +375,232 @@ enum nnp_status nnp_convolution_inference(
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
 	const void* activation_parameters,
+	const enum nnp_convolution_pooling pooling,
+	struct nnp_profile* profile);
+
+/**
+* @brief Describes how nnp_convolution_inference would compute a layer, without running it.
+* @details Reports the algorithm (resolving nnp_convolution_algorithm_auto), the exact workspace size, tiling and cache
+*          blocking parameters, and the cost model estimates used by automatic algorithm selection. Cache blocking
+*          and the estimates reflect the schedule the call would use with the current thread pool. Returns the same
+*          status as nnp_convolution_inference for unsupported parameters. info may be NULL to only validate them.
+*          nnp_convolution_algorithm_auto resolves from the layer parameters, activation, pooling, and whether the
+*          kernel transform is computed in the call, with a single-threaded cost estimate. It does not depend on the
+*          workspace, the residual, or the thread pool, so precompute, reuse and workspace size queries of a layer
+*          pick the same algorithm. A caller-provided workspace that is too small for it is rejected with
+*          nnp_status_insufficient_buffer rather than switching algorithms.
+*/
+enum nnp_status nnp_convolution_inference_query(
+	enum nnp_convolution_algorithm algorithm,
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const enum nnp_activation activation,
+	const enum nnp_convolution_pooling pooling,
+	struct nnp_convolution_info* info);
+
+/**
+* @brief Pre-computes the kernel transform for nnp_convolution_transform_strategy_reuse with inference batch normalization folded in.
+* @details Output channel c is scaled by gamma[c] / sqrt(variance[c] + epsilon) inside the transformed kernel, and
+*          folded_bias[c] receives (bias[c] - mean[c]) * scale + beta[c]; pass it as bias to nnp_convolution_inference.
+*          bias, gamma and beta may be NULL (treated as 0, 1 and 0). With transformed_kernel == NULL, only reports the size.
+*          Returns nnp_status_invalid_batch_norm_parameters if any variance[c] + epsilon is not positive and finite.
+*          Neither transformed_kernel nor folded_bias is modified unless the call succeeds.
+*/
+enum nnp_status nnp_convolution_inference_fold_batch_norm(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	const float* mean,
+	const float* variance,
+	const float* gamma,
+	const float* beta,
+	const float epsilon,
+	void* transformed_kernel,
+	size_t* transformed_kernel_size,
+	float* folded_bias,
+	struct nnp_profile* profile);
+
+/**
+* @brief Computes output of a 2D convolutional layer on 8-bit quantized data for a single input image.
+* @details Input elements represent (input - input_zero_point) * input_scale. Kernel elements are symmetric int8 with a
+*          per-output-channel kernel_scale[c], and bias (may be NULL) is int32 with scale input_scale * kernel_scale[c].
+*          Each output element of channel c is round((accumulator + bias[c]) * requantization_scale[c]) + output_zero_point,
+*          clamped to [output_min, output_max], where requantization_scale[c] = input_scale * kernel_scale[c] / output_scale.
+*          The product is computed in double precision, so it is rounded correctly for any int32 accumulator.
+*          ReLU activation additionally clamps from below at output_zero_point.
+*          Supports nnp_convolution_algorithm_implicit_gemm, and nnp_convolution_algorithm_direct for unpadded 1x1
+*          kernels with unit stride; nnp_convolution_algorithm_auto picks between them.
+*/
+enum nnp_status nnp_convolution_inference_q8(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const uint8_t* input,
+	const uint8_t input_zero_point,
+	const int8_t* kernel,
+	const int32_t* bias,
+	const float* requantization_scale,
+	const uint8_t output_zero_point,
+	const uint8_t output_min,
+	const uint8_t output_max,
+	uint8_t* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
 	struct nnp_profile* profile);
 
+/**
+* @brief Writes a transformed kernel from nnp_convolution_transform_strategy_precompute to a file.
+* @details The file header records the algorithm, tile size, layer parameters, and the host backend, ISA (including F16C),
+*          transformed element type, SIMD width, cache blocking and GEMM tiling the transform layout depends on.
+*          The algorithm must not be auto.
+*/
+enum nnp_status nnp_convolution_inference_save_kernel(
+	const char* path,
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const void* transformed_kernel,
+	const size_t transformed_kernel_size);
+
+/**
+* @brief Maps a file written by nnp_convolution_inference_save_kernel into memory.
+* @details On success, transformed_kernel points into the read-only mapping and can be passed as kernel to
+*          nnp_convolution_inference with nnp_convolution_transform_strategy_reuse. A file produced for a different
+*          backend or CPU configuration, including an fp16 transform on a host which stores it in fp32, is rejected with
+*          nnp_status_unsupported_hardware, and a file for different
+*          layer parameters with nnp_status_invalid_kernel_file. Release the mapping with nnp_convolution_inference_unload_kernel.
+*/
+enum nnp_status nnp_convolution_inference_load_kernel(
+	const char* path,
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const void** transformed_kernel,
+	size_t* transformed_kernel_size);
+
+enum nnp_status nnp_convolution_inference_unload_kernel(
+	const void* transformed_kernel,
+	const size_t transformed_kernel_size);
+
+/**
+ * @brief Computes output of a fully connected layer for a mini-batch of input vectors.
+ * @details bias (output_channels values) may be NULL. When present it is added to the output, and the activation is
+ *          applied after it, in the same pass that stores the output. activation_parameters must be NULL.
+ *          With transform_strategy == nnp_convolution_transform_strategy_reuse, kernel is the packed kernel produced by
+ *          nnp_fully_connected_pack_kernel, and per-call kernel packing is skipped. nnp_convolution_transform_strategy_precompute
+ *          is not supported: pack the kernel with nnp_fully_connected_pack_kernel instead.
+ */
 enum nnp_status nnp_fully_connected_output(
+	const enum nnp_convolution_transform_strategy transform_strategy,
 	const size_t batch_size,
 	const size_t input_channels,
 	const size_t output_channels,
 	const float* input,
 	const float* kernel,
+	const float* bias,
 	float* output,
+	const enum nnp_activation activation,
+	const void* activation_parameters,
 	struct nnp_profile* profile);
 
+/**
+ * @brief Computes gradient of input of a fully connected layer from gradient of output and the kernel.
+ * @details grad_input (batch_size x input_channels) is grad_output (batch_size x output_channels) multiplied by kernel.
+ */
+enum nnp_status nnp_fully_connected_input_gradient(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* grad_output,
+	const float* kernel,
+	float* grad_input,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes gradient of kernel of a fully connected layer from gradient of output and the input.
+ * @details grad_kernel (output_channels x input_channels) is overwritten with the sum over the mini-batch of the outer
+ *          products of grad_output and input vectors. If grad_bias is not NULL, it receives the sum of grad_output over
+ *          the mini-batch.
+ */
+enum nnp_status nnp_fully_connected_kernel_gradient(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* input,
+	const float* grad_output,
+	float* grad_kernel,
+	float* grad_bias,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Packs a fully connected layer kernel for nnp_fully_connected_output with nnp_convolution_transform_strategy_reuse.
+ * @details The packed layout depends on the layer channels and on the cache blocking and micro-kernel of the host, so a
+ *          packed kernel is only valid for the same layer in the same process configuration. With packed_kernel == NULL,
+ *          only reports the required size in packed_kernel_size.
+ */
+enum nnp_status nnp_fully_connected_pack_kernel(
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* kernel,
+	void* packed_kernel,
+	size_t* packed_kernel_size);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector.
+ * @details bias and activation are handled as in nnp_fully_connected_output.
+ */
 enum nnp_status nnp_fully_connected_inference(
 	const size_t input_channels,
 	const size_t output_channels,
 	const float* input,
 	const float* kernel,
-	float* output);
+	const float* bias,
+	float* output,
+	const enum nnp_activation activation,
+	const void* activation_parameters);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector with half-precision weights.
+ * @details Same as nnp_fully_connected_inference, but kernel holds output_channels x input_channels 16-bit
+ *          floating-point values in the alternative half-precision format (IEEE layout without infinities and NaNs),
+ *          which halves the weight bandwidth of memory-bound layers. Input and output remain single-precision,
+ *          and accumulation is done in single precision.
+ */
+enum nnp_status nnp_fully_connected_inference_f16f32(
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* input,
+	const void* kernel,
+	const float* bias,
+	float* output,
+	const enum nnp_activation activation,
+	const void* activation_parameters);
 
 enum nnp_status nnp_max_pooling_output(
 	const size_t batch_size,
@@ -321,8 +654,8 @@ inline nnp_status nnp_convolution_output(
 	return nnp_convolution_output(
 		algorithm,
 		batch_size, input_channels, output_channels,
-		input_size, input_padding, kernel_size,
-		input, kernel, bias, output,
+		input_size, input_padding, kernel_size, nnp_size{ 1, 1 },
+		input, kernel, bias, NULL, output, NULL, NULL,
 		NULL, NULL, nnp_activation_identity, NULL, profile);
 }
 
@@ -342,8 +675,8 @@ inline nnp_status nnp_convolution_input_gradient(
 	return nnp_convolution_input_gradient(
 		algorithm,
 		batch_size, input_channels, output_channels,
-		input_size, input_padding, kernel_size,
-		grad_output, kernel, grad_input,
+		input_size, input_padding, kernel_size, nnp_size{ 1, 1 },
+		grad_output, NULL, kernel, grad_input,
 		NULL, NULL, nnp_activation_identity, NULL, profile);
 }
 
@@ -361,10 +694,10 @@ inline nnp_status nnp_convolution_kernel_gradient(
 	nnp_profile* profile)
 {
 	return nnp_convolution_kernel_gradient(
-		algorithm,
+		algorithm, nnp_convolution_transform_strategy_compute,
 		batch_size, input_channels, output_channels,
-		input_size, input_padding, kernel_size,
-		input, grad_output, grad_kernel,
+		input_size, input_padding, kernel_size, nnp_size{ 1, 1 },
+		input, grad_output, grad_kernel, NULL, false,
 		NULL, NULL, nnp_activation_identity, NULL, profile);
 }
 
@@ -387,7 +720,7 @@ inline nnp_status nnp_convolution_inference(
 		algorithm, transform_strategy,
 		input_channels, output_channels,
 		input_size, input_padding, kernel_size, output_subsampling,
-		input, kernel, bias, output, NULL, NULL,
-		nnp_activation_identity, NULL, profile);
+		input, kernel, bias, NULL, output, NULL, NULL,
+		nnp_activation_identity, NULL, nnp_convolution_pooling_none, profile);
 }
 #endif // __cplusplus
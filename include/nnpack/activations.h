@@ -2,11 +2,57 @@
 
 #include <math.h>
 
+#include <nnpack.h>
+
 
 static inline float relu(float data, float negative_slope) {
 	return signbit(data) ? data * negative_slope : data;
 }
 
+/* Adds a per-column bias (if not NULL) to a rows x columns block of a row-major matrix, then applies the activation */
+static inline void add_bias_with_activation(
+	float* data, const float* bias,
+	size_t rows, size_t columns, size_t stride,
+	enum nnp_activation activation)
+{
+	if (bias == NULL && activation == nnp_activation_identity) {
+		return;
+	}
+	for (size_t row = 0; row < rows; row++) {
+		for (size_t column = 0; column < columns; column++) {
+			float value = data[row * stride + column];
+			if (bias != NULL) {
+				value += bias[column];
+			}
+			if (activation == nnp_activation_relu) {
+				value = relu(value, 0.0f);
+			}
+			data[row * stride + column] = value;
+		}
+	}
+}
+
+/*
+ * Adds a residual block and a scalar bias to a rows x columns block of data, then applies the activation to the sum.
+ * Output transforms skip the activation when a residual is present, so that ReLU is applied after the addition.
+ */
+static inline void add_residual_with_activation(
+	float* data, size_t data_stride,
+	const float* residual, size_t residual_stride,
+	float bias, size_t rows, size_t columns,
+	enum nnp_activation activation)
+{
+	for (size_t row = 0; row < rows; row++) {
+		for (size_t column = 0; column < columns; column++) {
+			float value = data[row * data_stride + column] + residual[row * residual_stride + column] + bias;
+			if (activation == nnp_activation_relu) {
+				value = relu(value, 0.0f);
+			}
+			data[row * data_stride + column] = value;
+		}
+	}
+}
+
 static inline float grad_relu(float grad_output_data, float input_data, float negative_slope) {
 	return signbit(input_data) ? grad_output_data * negative_slope : grad_output_data;
 }
@@ -21,6 +21,12 @@ extern "C" {
 	void nnp_sgemm_only_4x3__scalar(size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 	void nnp_sgemm_upto_4x3__scalar(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 
+	void nnp_sgemm_indirect_only_4x16__fma3(size_t k, size_t update, const float* a, const float* b, const int32_t* indirection, size_t kernel_elements, size_t channel_stride, float* c, size_t row_stride_c);
+	void nnp_sgemm_indirect_only_4x4__scalar(size_t k, size_t update, const float* a, const float* b, const int32_t* indirection, size_t kernel_elements, size_t channel_stride, float* c, size_t row_stride_c);
+
+	void nnp_q8gemm_only_4x16__avx2(size_t k, size_t update, const int16_t* a, const int16_t* b, int32_t* c, size_t row_stride_c);
+	void nnp_q8gemm_only_4x4__scalar(size_t k, size_t update, const int16_t* a, const int16_t* b, int32_t* c, size_t row_stride_c);
+
 	void nnp_conv1x1_only_2x4__fma3(size_t input_channels, size_t image_size, const float* input, const float* kernel, float* output);
 	void nnp_conv1x1_upto_2x4__fma3(uint32_t mr, uint32_t nr, size_t input_channels, size_t image_size, const float* input, const float* kernel, float* output);
 
@@ -53,6 +59,8 @@ extern "C" {
 
 	void nnp_s8gemm_only_3x4__fma3(size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 	void nnp_s8gemm_upto_3x4__fma3(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
+	void nnp_s8gemm_fp16b_only_3x4__fma3(size_t k, size_t update, const float* a, const void* b, float* c, size_t row_stride_c);
+	void nnp_s8gemm_fp16b_upto_3x4__fma3(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const void* b, float* c, size_t row_stride_c);
 
 	void nnp_s4gemm_only_3x4__psimd(size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 	void nnp_s4gemm_upto_3x4__psimd(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
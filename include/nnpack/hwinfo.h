@@ -17,6 +17,7 @@ struct isa_info {
 	bool has_avx;
 	bool has_fma3;
 	bool has_avx2;
+	bool has_f16c;
 };
 
 struct cache_info {
@@ -40,6 +41,20 @@ struct cache_blocking_info {
 	size_t l4;
 };
 
+/*
+ * Maximum number of processor packages (sockets) work is partitioned across.
+ * Packages are discovered only on x86 outside Android and MSVC builds; elsewhere packages_count is 1.
+ */
+#define NNP_MAX_PACKAGES 8
+
+struct package_info {
+	/* Range of cpuinfo logical processor indices on the package */
+	uint32_t processor_start;
+	uint32_t processor_count;
+	/* Cache blocking parameters with the last-level cache of this package */
+	struct cache_blocking_info blocking;
+};
+
 #if NNP_BACKEND_SCALAR
 	#define NNP_COMPLEX_TUPLE_INDEX 2
 #else
@@ -53,6 +68,10 @@ typedef void(*nnp_transform_2d_with_offset)(const void*, void*, size_t, size_t,
 typedef void(*nnp_fast_sgemm_function)(size_t, size_t, const float*, const float*, float*, size_t);
 typedef void(*nnp_full_sgemm_function)(uint32_t, uint32_t, size_t, size_t, const float*, const float*, float*, size_t);
 
+typedef void(*nnp_fast_indirect_sgemm_function)(size_t, size_t, const float*, const float*, const int32_t*, size_t, size_t, float*, size_t);
+
+typedef void(*nnp_fast_q8gemm_function)(size_t, size_t, const int16_t*, const int16_t*, int32_t*, size_t);
+
 typedef void(*nnp_fast_conv_function)(size_t, size_t, const float*, const float*, float*);
 typedef void(*nnp_full_conv_function)(uint32_t, uint32_t, size_t, size_t, const float*, const float*, float*);
 
@@ -84,6 +103,9 @@ struct transforms {
 #endif
 	nnp_transform_2d_with_bias ifft16x16_with_bias;
 	nnp_transform_2d_with_bias ifft16x16_with_bias_with_relu;
+	nnp_transform_2d_with_offset fft32x32_with_offset_and_stream;
+	nnp_transform_2d_with_bias ifft32x32_with_bias;
+	nnp_transform_2d_with_bias ifft32x32_with_bias_with_relu;
 	nnp_transform_2d_with_offset iwt_f6x6_3x3_with_offset_and_store;
 	nnp_transform_2d_with_offset iwt_f6x6_3x3_with_offset_and_stream;
 	nnp_transform_2d_with_offset kwt_f6x6_3x3;
@@ -95,9 +117,11 @@ struct transforms {
 	nnp_transform_2d_with_bias owt_f6x6_3x3s2_with_bias;
 	nnp_transform_2d_with_bias owt_f6x6_3x3_with_bias_with_relu;
 	nnp_transform_2d_with_bias owt_f6x6_3x3s2_with_bias_with_relu;
+#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
+	nnp_transform_2d_with_offset kwt_f6x6_3x3_fp16;
+#endif /* NNP_BACKEND_ARM || NNP_BACKEND_X86_64 */
 #if NNP_BACKEND_ARM
 	nnp_transform_2d_with_offset iwt_f6x6_3x3_fp16_with_offset;
-	nnp_transform_2d_with_offset kwt_f6x6_3x3_fp16;
 	nnp_transform_2d_with_bias owt_f6x6_3x3_fp16_with_bias;
 	nnp_transform_2d_with_bias owt_f6x6_3x3_fp16_with_bias_with_relu;
 #endif /* NNP_BACKEND_ARM */
@@ -127,6 +151,20 @@ struct sgemm {
 	uint32_t nr;
 };
 
+/* GEMM which reads B from the input image through an indirection buffer. Edge tiles are handled by padding operands to full tiles. */
+struct sgemm_indirect {
+	nnp_fast_indirect_sgemm_function only_mr_x_nr;
+	uint32_t mr;
+	uint32_t nr;
+};
+
+/* Quantized GEMM on int16 pairs with int32 accumulation. Operands are zero-padded to full tiles, so there is no upto variant. */
+struct q8gemm {
+	nnp_fast_q8gemm_function only_mr_x_nr;
+	uint32_t mr;
+	uint32_t nr;
+};
+
 struct sxgemm {
 	nnp_fast_tuple_gemm_function only_mr_x_nr;
 	nnp_full_tuple_gemm_function upto_mr_x_nr;
@@ -182,12 +220,17 @@ struct hardware_info {
 	struct cache_hierarchy_info cache;
 	struct cache_blocking_info blocking;
 
+	uint32_t packages_count;
+	struct package_info packages[NNP_MAX_PACKAGES];
+
 	struct transforms transforms;
 #if !NNP_CONVOLUTION_ONLY
 	struct activations activations;
 #endif
 	struct convolution conv1x1;
 	struct sgemm sgemm;
+	struct sgemm_indirect sgemm_indirect;
+	struct q8gemm q8gemm;
 	struct sxgemm sxgemm;
 #ifdef _WIN64
 	struct sgemm sgemm_psimd;
@@ -196,6 +239,10 @@ struct hardware_info {
 #if NNP_BACKEND_ARM
 	struct hxgemm hxgemm;
 #endif /* NNP_BACKEND_ARM */
+#if NNP_BACKEND_X86_64
+	/* Single-precision tuple GEMM with half-precision B (kernel transform), widened in registers */
+	struct sxgemm sxgemm_fp16b;
+#endif /* NNP_BACKEND_X86_64 */
 	struct cxgemm cxgemm;
 #ifdef _WIN64
 	struct cxgemm cxgemm_psimd;
@@ -58,6 +58,25 @@ struct compute_3d_tiled_context {
 	size_t tile_k;
 };
 
+/* Number of workers which may run concurrently in pthreadpool_compute_* calls */
+size_t pthreadpool_get_threads_count(void);
+
+/*
+ * Sets the number of workers for subsequent pthreadpool_compute_* calls, or restores the default of one worker per
+ * available logical processor if threads_count is 0. Must not be called concurrently with computations.
+ */
+void pthreadpool_set_threads_count(const size_t threads_count);
+
+/*
+ * Calls function(argument, package) for each of packages_count processor packages in nnp_hwinfo, concurrently, each on
+ * a thread bound to the logical processors of its package (on Linux). pthreadpool_compute_* calls made by function then
+ * run on that package only, and memory function allocates is first touched there, i.e. local to the package's NUMA node.
+ */
+void pthreadpool_compute_packages(
+	pthreadpool_function_1d_t function,
+	void* argument,
+	const size_t packages_count);
+
 void pthreadpool_compute_1d(
 	pthreadpool_function_1d_t function,
 	void* argument,
@@ -24,6 +24,7 @@ void nnp_convolution_input_gradient__reference(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* grad_output,
 	const float* kernel,
 	float* grad_input);
@@ -35,6 +36,7 @@ void nnp_convolution_kernel_gradient__reference(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* grad_output,
 	float* grad_kernel);
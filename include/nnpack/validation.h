@@ -74,7 +74,8 @@ static inline enum nnp_status validate_convolution_arguments(
 }
 
 static inline enum nnp_status validate_fully_connected_arguments(
-	size_t batch_size, size_t input_channels, size_t output_channels)
+	size_t batch_size, size_t input_channels, size_t output_channels,
+	enum nnp_activation activation, const void* activation_parameters)
 {
 	if (!nnp_hwinfo.initialized) {
 		return nnp_status_uninitialized;
@@ -96,6 +97,24 @@ static inline enum nnp_status validate_fully_connected_arguments(
 		return nnp_status_invalid_output_channels;
 	}
 
+	switch (activation) {
+	case nnp_activation_identity:
+		if (activation_parameters != NULL) {
+			return nnp_status_invalid_activation_parameters;
+		}
+		break;
+	case nnp_activation_relu:
+		if (activation_parameters != NULL) {
+			const float negative_slope = *((const float*)activation_parameters);
+			if (!isfinite(negative_slope) || negative_slope < 0.0f) {
+				return nnp_status_invalid_activation_parameters;
+			}
+		}
+		break;
+	default:
+		return nnp_status_invalid_activation;
+	}
+
 	return nnp_status_success;
 }
 
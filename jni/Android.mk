@@ -21,8 +21,11 @@ ifeq ($(TARGET_ARCH_ABI),$(filter $(TARGET_ARCH_ABI),x86 x86_64 armeabi-v7a arm6
 LOCAL_SRC_FILES := \
 	$(LOCAL_PATH)/src/psimd/2d-fourier-8x8.c \
 	$(LOCAL_PATH)/src/psimd/2d-fourier-16x16.c \
+	$(LOCAL_PATH)/src/psimd/2d-fourier-32x32.cpp \
 	$(LOCAL_PATH)/src/psimd/softmax.c \
-	$(LOCAL_PATH)/src/psimd/blas/shdotxf.c
+	$(LOCAL_PATH)/src/psimd/blas/shdotxf.c \
+	$(LOCAL_PATH)/src/scalar/blas/q8gemm.c \
+	$(LOCAL_PATH)/src/scalar/blas/sgemm-indirect.c
 ifeq ($(TARGET_ARCH_ABI),$(filter $(TARGET_ARCH_ABI),armeabi-v7a arm64-v8a))
 LOCAL_SRC_FILES += \
 	$(LOCAL_PATH)/src/neon/relu.c \
@@ -50,6 +53,7 @@ else
 LOCAL_SRC_FILES := \
 	$(LOCAL_PATH)/src/scalar/2d-fourier-8x8.c \
 	$(LOCAL_PATH)/src/scalar/2d-fourier-16x16.c \
+	$(LOCAL_PATH)/src/scalar/2d-fourier-32x32.c \
 	$(LOCAL_PATH)/src/scalar/2d-winograd-8x8-3x3.c \
 	$(LOCAL_PATH)/src/scalar/relu.c \
 	$(LOCAL_PATH)/src/scalar/softmax.c \
@@ -58,6 +62,8 @@ LOCAL_SRC_FILES := \
 	$(LOCAL_PATH)/src/scalar/blas/s2gemm.c \
 	$(LOCAL_PATH)/src/scalar/blas/cgemm-conjb.c \
 	$(LOCAL_PATH)/src/scalar/blas/sgemm.c \
+	$(LOCAL_PATH)/src/scalar/blas/q8gemm.c \
+	$(LOCAL_PATH)/src/scalar/blas/sgemm-indirect.c \
 	$(LOCAL_PATH)/src/scalar/blas/sdotxf.c
 endif
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/include $(LOCAL_PATH)/src $(LOCAL_PATH)/deps/fp16/include $(LOCAL_PATH)/deps/psimd/include
@@ -104,6 +110,8 @@ LOCAL_MODULE := nnpack
 LOCAL_SRC_FILES := \
 	$(LOCAL_PATH)/src/init.c \
 	$(LOCAL_PATH)/src/convolution-inference.c \
+	$(LOCAL_PATH)/src/convolution-kernel-file.c \
+	$(LOCAL_PATH)/src/convolution-inference-q8.c \
 	$(LOCAL_PATH)/src/fully-connected-inference.c \
 	$(LOCAL_PATH)/src/pooling-output.c \
 	$(LOCAL_PATH)/src/softmax-output.c \
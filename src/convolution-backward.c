@@ -0,0 +1,902 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/hwinfo.h>
+#include <nnpack/validation.h>
+
+/*
+ * Backward pass of a convolutional layer which transforms grad_output once per tile and uses it for both gradients.
+ *
+ * Tiles follow the kernel gradient: every tile covers an (tile - kernel + 1)-sized block of grad_output at offset 0
+ * and a full tile of input. The same grad_output transform then gives the input gradient by overlap-add: the product
+ * with the kernel transform is the linear convolution of the block with the kernel, which fits into the tile without
+ * wrap-around, and overlapping tile results are accumulated into grad_input.
+ *
+ * The two tuple GEMMs reduce over different dimensions (samples for the kernel gradient, output channels for the input
+ * gradient), so the grad_output transform is repacked into input gradient panels between them. Repacking only moves
+ * tuples and is much cheaper than a second Fourier transform of grad_output.
+ */
+
+/* Largest tile supported by this implementation */
+#define BACKWARD_TILE_ELEMENTS_MAX (16 * 16)
+
+struct NNP_CACHE_ALIGN kernel_transform_context
+{
+	const nnp_transform_2d_with_offset transform_function;
+	const float* kernel;
+	float* kernel_transform;
+
+	const size_t tuple_elements;
+	const size_t input_channels;
+	const size_t output_channels;
+	const size_t output_channels_block_max;
+	const struct nnp_size kernel_size;
+};
+
+static void compute_kernel_transform(
+	const struct kernel_transform_context* context,
+	const size_t output_channel,
+	const size_t input_channels_subblock_start,
+	const size_t output_channel_range,
+	const size_t input_channels_subblock_size)
+{
+	const size_t tuple_elements                           = context->tuple_elements;
+	const size_t input_channels                           = context->input_channels;
+	const size_t output_channels                          = context->output_channels;
+	const size_t output_channels_block_max                = context->output_channels_block_max;
+	const struct nnp_size kernel_size                     = context->kernel_size;
+
+	const float* kernel                                   = context->kernel;
+	float* kernel_transform                               = context->kernel_transform;
+	const nnp_transform_2d_with_offset transform_function = context->transform_function;
+
+	const size_t output_channels_block_start  = round_down(output_channel, output_channels_block_max);
+	const size_t output_channels_block_size   = min(output_channels - output_channels_block_start, output_channels_block_max);
+	const size_t output_channels_block_offset = output_channel - output_channels_block_start;
+
+	for (size_t input_channels_subblock_offset = 0; input_channels_subblock_offset < input_channels_subblock_size; input_channels_subblock_offset++)
+	{
+		const size_t input_channel = input_channels_subblock_start + input_channels_subblock_offset;
+		transform_function(
+			kernel + (output_channel * input_channels + input_channel) * kernel_size.width * kernel_size.height,
+			kernel_transform + (output_channels_block_start * input_channels + input_channels_subblock_start * output_channels_block_size + output_channels_block_offset * input_channels_subblock_size + input_channels_subblock_offset) * tuple_elements,
+			kernel_size.width,
+			output_channels * input_channels * tuple_elements * sizeof(float),
+			kernel_size.height, kernel_size.width,
+			0, 0);
+	}
+}
+
+struct NNP_CACHE_ALIGN input_transform_context
+{
+	const size_t tuple_elements;
+	const size_t input_elements;
+	const size_t batch_block_size;
+	const size_t input_channels;
+	const size_t input_stride;
+	const uint32_t row_offset;
+	const uint32_t column_offset;
+	const uint32_t row_count;
+	const uint32_t column_count;
+	const float* input;
+	float* input_transform;
+	const nnp_transform_2d_with_offset transform_function;
+};
+
+static void compute_input_transform(
+	const struct input_transform_context* context,
+	const size_t batch_block_offset,
+	const size_t input_channels_subblock_start,
+	const size_t batch_block_offset_range,
+	const size_t input_channels_subblock_size)
+{
+	const size_t tuple_elements                  = context->tuple_elements;
+	const size_t input_elements                  = context->input_elements;
+	const size_t batch_block_size                = context->batch_block_size;
+	const size_t input_channels                  = context->input_channels;
+	const size_t input_stride                    = context->input_stride;
+	const uint32_t row_offset                    = context->row_offset;
+	const uint32_t column_offset                 = context->column_offset;
+	const uint32_t row_count                     = context->row_count;
+	const uint32_t column_count                  = context->column_count;
+	const float* input                           = context->input;
+	float* input_transform                       = context->input_transform;
+	const nnp_transform_2d_with_offset transform = context->transform_function;
+
+	for (size_t input_channels_subblock_offset = 0; input_channels_subblock_offset < input_channels_subblock_size; input_channels_subblock_offset++)
+	{
+		const size_t input_channel = input_channels_subblock_start + input_channels_subblock_offset;
+		transform(
+			input + (batch_block_offset * input_channels + input_channel) * input_elements,
+			input_transform + (input_channels_subblock_start * batch_block_size + batch_block_offset * input_channels_subblock_size + input_channels_subblock_offset) * tuple_elements,
+			input_stride, batch_block_size * input_channels * tuple_elements * sizeof(float),
+			row_count, column_count,
+			row_offset, column_offset);
+	}
+}
+
+struct NNP_CACHE_ALIGN grad_output_transform_context
+{
+	const size_t tuple_elements;
+	const size_t output_elements;
+	const size_t batch_block_size;
+	const size_t output_channels;
+	const size_t grad_output_stride;
+	const uint32_t row_count;
+	const uint32_t column_count;
+	const float* grad_output;
+	float* grad_output_transform;
+	const nnp_transform_2d_with_offset transform_function;
+};
+
+static void compute_grad_output_transform(
+	const struct grad_output_transform_context* context,
+	const size_t batch_block_offset,
+	const size_t output_channels_subblock_start,
+	const size_t batch_block_offset_range,
+	const size_t output_channels_subblock_size)
+{
+	const size_t tuple_elements                  = context->tuple_elements;
+	const size_t output_elements                 = context->output_elements;
+	const size_t batch_block_size                = context->batch_block_size;
+	const size_t output_channels                 = context->output_channels;
+	const size_t grad_output_stride              = context->grad_output_stride;
+	const uint32_t row_count                     = context->row_count;
+	const uint32_t column_count                  = context->column_count;
+	const float* grad_output                     = context->grad_output;
+	float* grad_output_transform                 = context->grad_output_transform;
+	const nnp_transform_2d_with_offset transform = context->transform_function;
+
+	for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++)
+	{
+		const size_t output_channel = output_channels_subblock_start + output_channels_subblock_offset;
+		transform(
+			grad_output + (batch_block_offset * output_channels + output_channel) * output_elements,
+			grad_output_transform + (output_channels_subblock_start * batch_block_size + batch_block_offset * output_channels_subblock_size + output_channels_subblock_offset) * tuple_elements,
+			grad_output_stride,
+			batch_block_size * output_channels * tuple_elements * sizeof(float),
+			row_count, column_count,
+			0, 0);
+	}
+}
+
+struct NNP_CACHE_ALIGN grad_output_packing_context
+{
+	const size_t tuple_elements;
+	const size_t tuple_count;
+	const size_t batch_block_size;
+	const size_t output_channels;
+	const size_t output_channels_subblock_max;
+	const size_t output_channels_block_max;
+	const size_t batch_subblock_max;
+	const float* grad_output_transform;
+	float* grad_output_panels;
+};
+
+/* Moves the tuples of one output channel from kernel gradient panels to input gradient panels */
+static void compute_grad_output_packing(
+	const struct grad_output_packing_context* context,
+	const size_t output_channel)
+{
+	const size_t tuple_elements               = context->tuple_elements;
+	const size_t tuple_count                  = context->tuple_count;
+	const size_t batch_block_size             = context->batch_block_size;
+	const size_t output_channels              = context->output_channels;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const size_t output_channels_block_max    = context->output_channels_block_max;
+	const size_t batch_subblock_max           = context->batch_subblock_max;
+	const float* grad_output_transform        = context->grad_output_transform;
+	float* grad_output_panels                 = context->grad_output_panels;
+
+	const size_t tuple_stride = batch_block_size * output_channels * tuple_elements;
+
+	const size_t output_channels_subblock_start  = round_down(output_channel, output_channels_subblock_max);
+	const size_t output_channels_subblock_size   = min(output_channels - output_channels_subblock_start, output_channels_subblock_max);
+	const size_t output_channels_subblock_offset = output_channel - output_channels_subblock_start;
+
+	const size_t output_channels_block_start  = round_down(output_channel, output_channels_block_max);
+	const size_t output_channels_block_size   = min(output_channels - output_channels_block_start, output_channels_block_max);
+	const size_t output_channels_block_offset = output_channel - output_channels_block_start;
+
+	for (size_t sample = 0; sample < batch_block_size; sample++)
+	{
+		const size_t batch_subblock_start = round_down(sample, batch_subblock_max);
+		const size_t batch_subblock_size  = min(batch_block_size - batch_subblock_start, batch_subblock_max);
+
+		const float* source = grad_output_transform +
+			(output_channels_subblock_start * batch_block_size + sample * output_channels_subblock_size + output_channels_subblock_offset) * tuple_elements;
+		float* destination = grad_output_panels +
+			(output_channels_block_start * batch_block_size + batch_subblock_start * output_channels_block_size + output_channels_block_offset * batch_subblock_size + (sample - batch_subblock_start)) * tuple_elements;
+		for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index++)
+		{
+			memcpy(destination, source, tuple_elements * sizeof(float));
+			source += tuple_stride;
+			destination += tuple_stride;
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN grad_kernel_transform_context
+{
+	const size_t tuple_elements;
+	const size_t input_channels;
+	const size_t output_channels;
+	const size_t output_channels_block_max;
+	const struct nnp_size kernel_size;
+	const float* grad_kernel_transform;
+	float* grad_kernel;
+	const nnp_transform_2d_with_offset transform_function;
+};
+
+static void compute_grad_kernel_transform(
+	const struct grad_kernel_transform_context* context,
+	const size_t output_channel,
+	const size_t input_channels_subblock_start,
+	const size_t output_channel_range,
+	const size_t input_channels_subblock_size)
+{
+	const size_t tuple_elements                  = context->tuple_elements;
+	const size_t input_channels                  = context->input_channels;
+	const size_t output_channels                 = context->output_channels;
+	const size_t output_channels_block_max       = context->output_channels_block_max;
+	const struct nnp_size kernel_size            = context->kernel_size;
+	const float* grad_kernel_transform           = context->grad_kernel_transform;
+	float* grad_kernel                           = context->grad_kernel;
+	const nnp_transform_2d_with_offset transform = context->transform_function;
+
+	const size_t output_channels_block_start  = round_down(output_channel, output_channels_block_max);
+	const size_t output_channels_block_size   = min(output_channels - output_channels_block_start, output_channels_block_max);
+	const size_t output_channels_block_offset = output_channel - output_channels_block_start;
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+
+	for (size_t input_channels_subblock_offset = 0; input_channels_subblock_offset < input_channels_subblock_size; input_channels_subblock_offset++)
+	{
+		const size_t input_channel = input_channels_subblock_start + input_channels_subblock_offset;
+		transform(
+			grad_kernel_transform + (output_channels_block_start * input_channels + input_channels_subblock_start * output_channels_block_size + output_channels_block_offset * input_channels_subblock_size + input_channels_subblock_offset) * tuple_elements,
+			grad_kernel + (output_channel * input_channels + input_channel) * kernel_elements,
+			output_channels * input_channels * tuple_elements * sizeof(float),
+			kernel_size.width,
+			kernel_size.height, kernel_size.width,
+			0, 0);
+	}
+}
+
+struct NNP_CACHE_ALIGN grad_kernel_multiplication_context
+{
+	const size_t tuple_elements;
+	const size_t batch_block_size;
+	const size_t batch_block_update;
+	const size_t input_channels;
+	const size_t input_channels_block_start;
+	const size_t input_channels_subblock_max;
+	const size_t output_channels_subblock_max;
+
+	const float* grad_output_transform;
+	const float* input_transform;
+	float* grad_kernel_transform;
+
+	nnp_fast_tuple_gemm_function fast_gemm;
+	nnp_full_tuple_gemm_function full_gemm;
+};
+
+static void compute_grad_kernel_multiplication(
+	const struct grad_kernel_multiplication_context* context,
+	const size_t output_channels_block_start,
+	const size_t input_channels_subblock_start,
+	size_t output_channels_block_size,
+	const size_t input_channels_subblock_size)
+{
+	const size_t tuple_elements                  = context->tuple_elements;
+	const size_t batch_block_size                = context->batch_block_size;
+	const size_t batch_block_update              = context->batch_block_update;
+	const size_t input_channels                  = context->input_channels;
+	const size_t input_channels_block_start      = context->input_channels_block_start;
+	const size_t input_channels_subblock_max     = context->input_channels_subblock_max;
+	const size_t output_channels_subblock_max    = context->output_channels_subblock_max;
+
+	const float* grad_output_transform           = context->grad_output_transform + output_channels_block_start * batch_block_size * tuple_elements;
+	const float* input_transform                 = context->input_transform + (input_channels_block_start + input_channels_subblock_start) * batch_block_size * tuple_elements;
+	float* grad_kernel_transform                 = context->grad_kernel_transform + (output_channels_block_start * input_channels + (input_channels_block_start + input_channels_subblock_start) * output_channels_block_size) * tuple_elements;
+
+	if (input_channels_subblock_size == input_channels_subblock_max)
+	{
+		const nnp_fast_tuple_gemm_function fast_gemm = context->fast_gemm;
+		while (output_channels_block_size >= output_channels_subblock_max)
+		{
+			output_channels_block_size -= output_channels_subblock_max;
+
+			fast_gemm(
+				batch_block_size, batch_block_update,
+				input_transform,
+				grad_output_transform,
+				grad_kernel_transform,
+				input_channels_subblock_size * tuple_elements);
+
+			grad_output_transform += output_channels_subblock_max * batch_block_size * tuple_elements;
+			grad_kernel_transform += output_channels_subblock_max * input_channels_subblock_size * tuple_elements;
+		}
+	}
+
+	const nnp_full_tuple_gemm_function full_gemm = context->full_gemm;
+	while (output_channels_block_size != 0)
+	{
+		const size_t output_channels_subblock_size = min(output_channels_block_size, output_channels_subblock_max);
+		output_channels_block_size -= output_channels_subblock_size;
+
+		full_gemm(
+			input_channels_subblock_size, output_channels_subblock_size,
+			batch_block_size, batch_block_update,
+			input_transform,
+			grad_output_transform,
+			grad_kernel_transform,
+			input_channels_subblock_size * tuple_elements);
+
+		grad_output_transform += output_channels_subblock_max * batch_block_size * tuple_elements;
+		grad_kernel_transform += output_channels_subblock_max * input_channels_subblock_size * tuple_elements;
+	}
+}
+
+struct NNP_CACHE_ALIGN grad_input_multiplication_context
+{
+	const size_t tuple_elements;
+	const size_t batch_block_size;
+	const size_t input_channels;
+	const size_t output_channels_block_start;
+	const size_t output_channels_block_size;
+	const size_t batch_subblock_max;
+	const size_t input_channels_subblock_max;
+
+	const float* grad_output_panels;
+	const float* kernel_transform;
+	float* grad_input_transform;
+
+	nnp_fast_tuple_gemm_function fast_gemm;
+	nnp_full_tuple_gemm_function full_gemm;
+};
+
+static void compute_grad_input_multiplication(
+	const struct grad_input_multiplication_context* context,
+	const size_t input_channels_block_start,
+	const size_t batch_subblock_start,
+	size_t input_channels_block_size,
+	const size_t batch_subblock_size)
+{
+	const size_t tuple_elements                  = context->tuple_elements;
+	const size_t batch_block_size                = context->batch_block_size;
+	const size_t input_channels                  = context->input_channels;
+	const size_t output_channels_block_start     = context->output_channels_block_start;
+	const size_t output_channels_block_size      = context->output_channels_block_size;
+	const size_t batch_subblock_max              = context->batch_subblock_max;
+	const size_t input_channels_subblock_max     = context->input_channels_subblock_max;
+
+	const float* grad_output_panels              = context->grad_output_panels + (output_channels_block_start * batch_block_size + batch_subblock_start * output_channels_block_size) * tuple_elements;
+	const float* kernel_transform                = context->kernel_transform + (output_channels_block_start * input_channels + input_channels_block_start * output_channels_block_size) * tuple_elements;
+	float* grad_input_transform                  = context->grad_input_transform + input_channels_block_start * batch_block_size * tuple_elements;
+
+	if (batch_subblock_size == batch_subblock_max)
+	{
+		const nnp_fast_tuple_gemm_function fast_gemm = context->fast_gemm;
+		while (input_channels_block_size >= input_channels_subblock_max)
+		{
+			input_channels_block_size -= input_channels_subblock_max;
+
+			fast_gemm(
+				output_channels_block_size,
+				output_channels_block_start,
+				grad_output_panels,
+				kernel_transform,
+				grad_input_transform + batch_subblock_start * input_channels_subblock_max * tuple_elements,
+				input_channels_subblock_max * tuple_elements);
+
+			kernel_transform += input_channels_subblock_max * output_channels_block_size * tuple_elements;
+			grad_input_transform += input_channels_subblock_max * batch_block_size * tuple_elements;
+		}
+	}
+
+	const nnp_full_tuple_gemm_function full_gemm = context->full_gemm;
+	while (input_channels_block_size != 0)
+	{
+		const size_t input_channels_subblock_size = min(input_channels_block_size, input_channels_subblock_max);
+		input_channels_block_size -= input_channels_subblock_size;
+
+		full_gemm(
+			batch_subblock_size,
+			input_channels_subblock_size,
+			output_channels_block_size,
+			output_channels_block_start,
+			grad_output_panels,
+			kernel_transform,
+			grad_input_transform + batch_subblock_start * input_channels_subblock_size * tuple_elements,
+			input_channels_subblock_size * tuple_elements);
+
+		kernel_transform += input_channels_subblock_max * output_channels_block_size * tuple_elements;
+		grad_input_transform += input_channels_subblock_max * batch_block_size * tuple_elements;
+	}
+}
+
+struct NNP_CACHE_ALIGN grad_input_accumulation_context
+{
+	const nnp_transform_2d_with_offset transform_function;
+	const float* grad_input_transform;
+	float* grad_input;
+
+	const size_t tuple_elements;
+	const size_t batch_block_size;
+	const size_t input_channels;
+	const size_t input_elements;
+	const size_t input_stride;
+	const uint32_t row_offset;
+	const uint32_t row_count;
+	const uint32_t column_offset;
+	const uint32_t column_count;
+};
+
+/* Inverse-transforms the part of a tile that falls inside grad_input and adds it to the contributions of other tiles */
+static void compute_grad_input_accumulation(
+	const struct grad_input_accumulation_context* context,
+	const size_t batch_block_offset,
+	const size_t input_channels_subblock_start,
+	const size_t batch_block_offset_range,
+	const size_t input_channels_subblock_size)
+{
+	const size_t tuple_elements                           = context->tuple_elements;
+	const size_t batch_block_size                         = context->batch_block_size;
+	const size_t input_channels                           = context->input_channels;
+	const size_t input_elements                           = context->input_elements;
+	const size_t input_stride                             = context->input_stride;
+	const uint32_t row_offset                             = context->row_offset;
+	const uint32_t row_count                              = context->row_count;
+	const uint32_t column_offset                          = context->column_offset;
+	const uint32_t column_count                           = context->column_count;
+	const float* grad_input_transform                     = context->grad_input_transform;
+	float* grad_input                                     = context->grad_input;
+	const nnp_transform_2d_with_offset transform_function = context->transform_function;
+
+	float block[BACKWARD_TILE_ELEMENTS_MAX];
+	for (size_t input_channels_subblock_offset = 0; input_channels_subblock_offset < input_channels_subblock_size; input_channels_subblock_offset++)
+	{
+		const size_t input_channel = input_channels_subblock_start + input_channels_subblock_offset;
+		transform_function(
+			grad_input_transform + (input_channels_subblock_start * batch_block_size + batch_block_offset * input_channels_subblock_size + input_channels_subblock_offset) * tuple_elements,
+			block,
+			batch_block_size * input_channels * tuple_elements * sizeof(float),
+			column_count,
+			row_count, column_count,
+			row_offset, column_offset);
+
+		float* grad_input_channel = grad_input + (batch_block_offset * input_channels + input_channel) * input_elements;
+		for (size_t row = 0; row < row_count; row++)
+		{
+			for (size_t column = 0; column < column_count; column++)
+				grad_input_channel[row * input_stride + column] += block[row * column_count + column];
+		}
+	}
+}
+
+static enum nnp_status compute_fast_convolution_backward(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size tile_size,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_size,
+	const float* input,
+	const float* grad_output,
+	const float* kernel,
+	float* grad_input,
+	float* grad_kernel,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const nnp_transform_2d_with_offset forward_transform_function,
+	const nnp_transform_2d_with_offset inverse_transform_function,
+	struct nnp_profile* profile)
+{
+	void* memory_block = NULL;
+
+#ifdef _WIN64
+	const bool bypass_fft16x16 = tile_size.width == 16 && nnp_hwinfo.simd_width == 8;
+	const size_t simd_width = bypass_fft16x16 ? 4 : nnp_hwinfo.simd_width;
+#else
+	const size_t simd_width = nnp_hwinfo.simd_width;
+#endif
+	const size_t tuple_elements = simd_width * 2;
+	const size_t tile_elements = tile_size.height * tile_size.width;
+	const size_t tuple_count = tile_elements / tuple_elements;
+
+	const struct nnp_size output_tile =
+	{
+		.width = tile_size.width - kernel_size.width + 1,
+		.height = tile_size.height - kernel_size.height + 1
+	};
+
+	/* Calculate cache blocking parameters */
+	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / (tuple_elements * sizeof(float));
+	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / (tuple_elements * sizeof(float));
+	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / (tuple_elements * sizeof(float));
+#ifdef _WIN64
+	const size_t mr = bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.mr : nnp_hwinfo.cxgemm.mr;
+	const size_t nr = bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.nr : nnp_hwinfo.cxgemm.nr;
+#else
+	const size_t mr = nnp_hwinfo.cxgemm.mr;
+	const size_t nr = nnp_hwinfo.cxgemm.nr;
+#endif
+
+	/* Kernel gradient GEMM: input channels x output channels, reduction over samples */
+	const size_t batch_block_max                       = round_down(cache_elements_l1 / (mr + nr), 2);
+	const size_t grad_kernel_input_channels_block_max  = round_down(cache_elements_l3 / batch_block_max, mr);
+	const size_t grad_kernel_output_channels_block_max = round_down(cache_elements_l2 / batch_block_max, nr);
+
+	/* Input gradient GEMM: samples x input channels, reduction over output channels */
+	const size_t grad_input_output_channels_block_max = round_down(cache_elements_l1 / (mr + nr), 2);
+	const size_t grad_input_input_channels_block_max  = round_down(cache_elements_l2 / grad_input_output_channels_block_max, nr);
+
+	/* Calculate memory footprint and allocate memory */
+	const size_t batch_block_size_max       = min(batch_size, batch_block_max);
+	const size_t input_transform_size       = batch_block_size_max * input_channels * tile_elements * sizeof(float);
+	const size_t grad_output_transform_size = batch_block_size_max * output_channels * tile_elements * sizeof(float);
+	const size_t kernel_transform_size      = output_channels * input_channels * tile_elements * sizeof(float);
+	const size_t memory_size = input_transform_size + 2 * grad_output_transform_size + 2 * kernel_transform_size;
+
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	/* Input transform is consumed by the kernel gradient GEMM before the input gradient GEMM overwrites it */
+	float* input_transform = (float*)memory_block;
+	float* grad_input_transform = input_transform;
+	float* grad_output_transform = (float*)((char*)memory_block + input_transform_size);
+	float* grad_output_panels = (float*)((char*)memory_block + input_transform_size + grad_output_transform_size);
+	float* kernel_transform = (float*)((char*)memory_block + input_transform_size + 2 * grad_output_transform_size);
+	float* grad_kernel_transform = (float*)((char*)memory_block + input_transform_size + 2 * grad_output_transform_size + kernel_transform_size);
+
+#ifdef _WIN64
+	const struct cxgemm* cxgemm = bypass_fft16x16 ? &nnp_hwinfo.cxgemm_psimd : &nnp_hwinfo.cxgemm;
+#else
+	const struct cxgemm* cxgemm = &nnp_hwinfo.cxgemm;
+#endif
+
+	NNP_KERNEL_TRANSFORM_START(profile)
+	struct kernel_transform_context kernel_transform_context =
+	{
+		.transform_function = forward_transform_function,
+		.kernel = kernel,
+		.kernel_transform = kernel_transform,
+		.tuple_elements = tuple_elements,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.output_channels_block_max = grad_input_output_channels_block_max,
+		.kernel_size = kernel_size
+	};
+	pthreadpool_compute_2d_tiled(
+		(pthreadpool_function_2d_tiled_t)compute_kernel_transform,
+		&kernel_transform_context,
+		output_channels, input_channels,
+		1, nr);
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	/* Tiles add their contributions to grad_input */
+	memset(grad_input, 0, batch_size * input_channels * input_size.height * input_size.width * sizeof(float));
+
+	for (size_t y = 0; y < output_size.height; y += output_tile.height)
+	{
+		const size_t input_y = min(doz(y, input_padding.top), input_size.height);
+		const uint32_t row_offset = doz(input_padding.top, y);
+		const uint32_t row_count = min(input_size.height - input_y, doz(tile_size.height, row_offset));
+
+		for (size_t x = 0; x < output_size.width; x += output_tile.width)
+		{
+			const size_t input_x = min(doz(x, input_padding.left), input_size.width);
+			const uint32_t column_offset = doz(input_padding.left, x);
+			const uint32_t column_count = min(input_size.width - input_x, doz(tile_size.width, column_offset));
+
+			for (size_t batch_block_start = 0; batch_block_start < batch_size; batch_block_start += batch_block_max)
+			{
+				const size_t batch_block_size = min(batch_size - batch_block_start, batch_block_max);
+
+				NNP_INPUT_TRANSFORM_START(profile)
+				struct input_transform_context input_transform_context =
+				{
+					.tuple_elements = tuple_elements,
+					.input_elements = input_size.height * input_size.width,
+					.batch_block_size = batch_block_size,
+					.input_channels = input_channels,
+					.input_stride = input_size.width,
+					.row_offset = row_offset,
+					.column_offset = column_offset,
+					.row_count = row_count,
+					.column_count = column_count,
+					.input = input + (batch_block_start * input_channels * input_size.height + input_y) * input_size.width + input_x,
+					.input_transform = input_transform,
+					.transform_function = forward_transform_function
+				};
+				pthreadpool_compute_2d_tiled(
+					(pthreadpool_function_2d_tiled_t)compute_input_transform,
+					&input_transform_context,
+					batch_block_size, input_channels,
+					1, mr);
+				NNP_INPUT_TRANSFORM_END(profile)
+
+				NNP_OUTPUT_TRANSFORM_START(profile)
+				struct grad_output_transform_context grad_output_transform_context =
+				{
+					.tuple_elements = tuple_elements,
+					.output_elements = output_size.height * output_size.width,
+					.batch_block_size = batch_block_size,
+					.output_channels = output_channels,
+					.grad_output_stride = output_size.width,
+					.row_count = min(output_tile.height, output_size.height - y),
+					.column_count = min(output_tile.width, output_size.width - x),
+					.grad_output = grad_output + (batch_block_start * output_channels * output_size.height + y) * output_size.width + x,
+					.grad_output_transform = grad_output_transform,
+					.transform_function = forward_transform_function
+				};
+				pthreadpool_compute_2d_tiled(
+					(pthreadpool_function_2d_tiled_t)compute_grad_output_transform,
+					&grad_output_transform_context,
+					batch_block_size, output_channels,
+					1, nr);
+
+				struct grad_output_packing_context grad_output_packing_context =
+				{
+					.tuple_elements = tuple_elements,
+					.tuple_count = tuple_count,
+					.batch_block_size = batch_block_size,
+					.output_channels = output_channels,
+					.output_channels_subblock_max = nr,
+					.output_channels_block_max = grad_input_output_channels_block_max,
+					.batch_subblock_max = mr,
+					.grad_output_transform = grad_output_transform,
+					.grad_output_panels = grad_output_panels
+				};
+				pthreadpool_compute_1d(
+					(pthreadpool_function_1d_t)compute_grad_output_packing,
+					&grad_output_packing_context,
+					output_channels);
+				NNP_OUTPUT_TRANSFORM_END(profile)
+
+				NNP_BLOCK_MULTIPLICATION_START(profile)
+				for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index++)
+				{
+					const bool real_tuple = tuple_index < NNP_COMPLEX_TUPLE_INDEX;
+					for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += grad_kernel_input_channels_block_max)
+					{
+						const size_t input_channels_block_size = min(input_channels - input_channels_block_start, grad_kernel_input_channels_block_max);
+
+						struct grad_kernel_multiplication_context grad_kernel_multiplication_context =
+						{
+							.tuple_elements = tuple_elements,
+							.batch_block_size = batch_block_size,
+							.batch_block_update = batch_block_start | x | y,
+							.input_channels = input_channels,
+							.input_channels_block_start = input_channels_block_start,
+							.input_channels_subblock_max = mr,
+							.output_channels_subblock_max = nr,
+							.grad_output_transform = grad_output_transform + tuple_index * tuple_elements * batch_block_size * output_channels,
+							.input_transform = input_transform + tuple_index * tuple_elements * batch_block_size * input_channels,
+							.grad_kernel_transform = grad_kernel_transform + tuple_index * tuple_elements * output_channels * input_channels,
+							.fast_gemm = real_tuple ? cxgemm->s4cX_conjb_transc_only_mr_x_nr : cxgemm->cX_conjb_transc_only_mr_x_nr,
+							.full_gemm = real_tuple ? cxgemm->s4cX_conjb_transc_upto_mr_x_nr : cxgemm->cX_conjb_transc_upto_mr_x_nr
+						};
+						pthreadpool_compute_2d_tiled(
+							(pthreadpool_function_2d_tiled_t)compute_grad_kernel_multiplication,
+							&grad_kernel_multiplication_context,
+							output_channels, input_channels_block_size,
+							grad_kernel_output_channels_block_max, mr);
+					}
+
+					for (size_t output_channels_block_start = 0; output_channels_block_start < output_channels; output_channels_block_start += grad_input_output_channels_block_max)
+					{
+						struct grad_input_multiplication_context grad_input_multiplication_context =
+						{
+							.tuple_elements = tuple_elements,
+							.batch_block_size = batch_block_size,
+							.input_channels = input_channels,
+							.output_channels_block_start = output_channels_block_start,
+							.output_channels_block_size = min(output_channels - output_channels_block_start, grad_input_output_channels_block_max),
+							.batch_subblock_max = mr,
+							.input_channels_subblock_max = nr,
+							.grad_output_panels = grad_output_panels + tuple_index * tuple_elements * batch_block_size * output_channels,
+							.kernel_transform = kernel_transform + tuple_index * tuple_elements * output_channels * input_channels,
+							.grad_input_transform = grad_input_transform + tuple_index * tuple_elements * batch_block_size * input_channels,
+							.fast_gemm = real_tuple ? cxgemm->s4cX_only_mr_x_nr : cxgemm->cX_only_mr_x_nr,
+							.full_gemm = real_tuple ? cxgemm->s4cX_upto_mr_x_nr : cxgemm->cX_upto_mr_x_nr
+						};
+						pthreadpool_compute_2d_tiled(
+							(pthreadpool_function_2d_tiled_t)compute_grad_input_multiplication,
+							&grad_input_multiplication_context,
+							input_channels, batch_block_size,
+							grad_input_input_channels_block_max, mr);
+					}
+				}
+				NNP_BLOCK_MULTIPLICATION_END(profile)
+
+				if (row_count != 0 && column_count != 0)
+				{
+					NNP_INPUT_TRANSFORM_START(profile)
+					struct grad_input_accumulation_context grad_input_accumulation_context =
+					{
+						.transform_function = inverse_transform_function,
+						.grad_input_transform = grad_input_transform,
+						.grad_input = grad_input + (batch_block_start * input_channels * input_size.height + input_y) * input_size.width + input_x,
+						.tuple_elements = tuple_elements,
+						.batch_block_size = batch_block_size,
+						.input_channels = input_channels,
+						.input_elements = input_size.height * input_size.width,
+						.input_stride = input_size.width,
+						.row_offset = row_offset,
+						.row_count = row_count,
+						.column_offset = column_offset,
+						.column_count = column_count
+					};
+					pthreadpool_compute_2d_tiled(
+						(pthreadpool_function_2d_tiled_t)compute_grad_input_accumulation,
+						&grad_input_accumulation_context,
+						batch_block_size, input_channels,
+						1, nr);
+					NNP_INPUT_TRANSFORM_END(profile)
+				}
+			}
+		}
+	}
+
+	/* Grad kernel transform */
+	{
+		NNP_KERNEL_TRANSFORM_START(profile)
+		struct grad_kernel_transform_context grad_kernel_transform_context =
+		{
+			.tuple_elements = tuple_elements,
+			.input_channels = input_channels,
+			.output_channels = output_channels,
+			.output_channels_block_max = grad_kernel_output_channels_block_max,
+			.kernel_size = kernel_size,
+			.grad_kernel_transform = grad_kernel_transform,
+			.grad_kernel = grad_kernel,
+			.transform_function = inverse_transform_function
+		};
+		pthreadpool_compute_2d_tiled(
+			(pthreadpool_function_2d_tiled_t)compute_grad_kernel_transform,
+			&grad_kernel_transform_context,
+			output_channels, input_channels,
+			1, mr);
+		NNP_KERNEL_TRANSFORM_END(profile)
+	}
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_convolution_backward(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const float* input,
+	const float* grad_output,
+	const float* kernel,
+	float* grad_input,
+	float* grad_kernel,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
+	const void* activation_parameters,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	const struct nnp_size output_size =
+	{
+		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
+		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+	};
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, (struct nnp_size) { .width = 1, .height = 1 }, activation, activation_parameters);
+	if (status != nnp_status_success)
+		goto cleanup;
+
+	if (activation != nnp_activation_identity)
+	{
+		status = nnp_status_unsupported_activation;
+		goto cleanup;
+	}
+
+	if (activation_parameters != NULL)
+	{
+		status = nnp_status_unsupported_activation_parameters;
+		goto cleanup;
+	}
+
+	/* If requested, choose optimal convolution algorithm */
+	if (algorithm == nnp_convolution_algorithm_auto)
+	{
+		if (max(kernel_size.width, kernel_size.height) > 8)
+			algorithm = nnp_convolution_algorithm_ft16x16;
+		else
+		{
+			const size_t tile_count_8x8 =   divide_round_up(output_size.height, 8 - kernel_size.height + 1) *
+											divide_round_up(output_size.width, 8 - kernel_size.width + 1);
+			const size_t tile_count_16x16 = divide_round_up(output_size.height, 16 - kernel_size.height + 1) *
+											divide_round_up(output_size.width, 16 - kernel_size.width + 1);
+
+			if (tile_count_8x8 <= 4 * tile_count_16x16)
+				/* 8x8 tiles are more efficient */
+				algorithm = nnp_convolution_algorithm_ft8x8;
+			else
+				algorithm = nnp_convolution_algorithm_ft16x16;
+		}
+	}
+
+	switch (algorithm)
+	{
+		case nnp_convolution_algorithm_ft8x8:
+			if (max(kernel_size.width, kernel_size.height) > 8)
+			{
+				status = nnp_status_unsupported_algorithm;
+				break;
+			}
+			status = compute_fast_convolution_backward(
+				batch_size, input_channels, output_channels,
+				(struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size,
+				input, grad_output, kernel, grad_input, grad_kernel, workspace_buffer, workspace_size,
+				nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.ifft8x8_with_offset, profile);
+			break;
+
+		case nnp_convolution_algorithm_ft16x16:
+			if (max(kernel_size.width, kernel_size.height) > 16)
+			{
+				status = nnp_status_unsupported_algorithm;
+				break;
+			}
+			status = compute_fast_convolution_backward(
+				batch_size, input_channels, output_channels,
+				(struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size,
+				input, grad_output, kernel, grad_input, grad_kernel, workspace_buffer, workspace_size,
+				nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.ifft16x16_with_offset, profile);
+			break;
+
+		case nnp_convolution_algorithm_wt8x8:
+		case nnp_convolution_algorithm_ft32x32:
+			/* Overlap-add needs the linear convolution of a grad_output block to fit the tile, which only Fourier transforms provide */
+			status = nnp_status_unsupported_algorithm;
+			break;
+
+		default:
+			status = nnp_status_invalid_algorithm;
+	}
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
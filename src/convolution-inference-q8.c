@@ -0,0 +1,484 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include <nnpack/fxdiv.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+
+#include <nnpack/hwinfo.h>
+#include <nnpack/validation.h>
+
+/* Largest mr x nr tile among q8gemm micro-kernels */
+#define NNP_Q8GEMM_TILE_MAX 64
+
+
+/*
+ * Quantized operands are packed as int16 pairs along the reduction dimension, zero-padded to full micro-kernel tiles:
+ *   packed_kernel[output_channels_subblock][reduction_pair][mr][2]
+ *   packed_input[output_image_subblock][reduction_pair][nr][2]
+ * The input zero point is subtracted during packing, so padding (which represents real zero) packs as 0.
+ */
+
+struct NNP_CACHE_ALIGN q8_kernel_packing_context
+{
+	const int8_t* kernel;
+	int16_t* packed_kernel;
+
+	const size_t reduction_size;
+	const size_t reduction_pairs;
+	const size_t output_channels;
+	const size_t output_channels_subblock_max;
+};
+
+static void compute_q8_kernel_packing(
+	const struct q8_kernel_packing_context* context,
+	const size_t output_channels_subblock_start,
+	const size_t output_channels_subblock_size)
+{
+	const size_t reduction_size = context->reduction_size;
+	const size_t reduction_pairs = context->reduction_pairs;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+
+	const int8_t* kernel = context->kernel + output_channels_subblock_start * reduction_size;
+	int16_t* packed_kernel = context->packed_kernel + output_channels_subblock_start * reduction_pairs * 2;
+
+	for (size_t reduction_index = 0; reduction_index < reduction_pairs * 2; reduction_index++)
+	{
+		const size_t packed_offset = (reduction_index / 2 * output_channels_subblock_max) * 2 + reduction_index % 2;
+		for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_max; output_channels_subblock_offset++)
+		{
+			int16_t value = 0;
+			if (output_channels_subblock_offset < output_channels_subblock_size && reduction_index < reduction_size)
+				value = (int16_t) kernel[output_channels_subblock_offset * reduction_size + reduction_index];
+			packed_kernel[packed_offset + output_channels_subblock_offset * 2] = value;
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN q8_input_packing_context
+{
+	const uint8_t* input;
+	int16_t* packed_input;
+
+	const int16_t input_zero_point;
+	const size_t reduction_size;
+	const size_t reduction_pairs;
+	const size_t output_image_block_start;
+	const size_t output_image_subblock_max;
+	const struct nnp_size input_size;
+	const size_t input_padding_top;
+	const size_t input_padding_left;
+	const struct fxdiv_divisor_size_t kernel_elements;
+	const struct fxdiv_divisor_size_t kernel_width;
+	const struct fxdiv_divisor_size_t output_width;
+	const struct nnp_size output_subsampling;
+};
+
+static void compute_q8_input_packing(
+	const struct q8_input_packing_context* context,
+	const size_t output_image_subblock_start,
+	const size_t output_image_subblock_size)
+{
+	const int16_t input_zero_point = context->input_zero_point;
+	const size_t reduction_size = context->reduction_size;
+	const size_t reduction_pairs = context->reduction_pairs;
+	const size_t output_image_block_start = context->output_image_block_start;
+	const size_t output_image_subblock_max = context->output_image_subblock_max;
+	const struct nnp_size input_size = context->input_size;
+	const size_t input_padding_top = context->input_padding_top;
+	const size_t input_padding_left = context->input_padding_left;
+	const struct fxdiv_divisor_size_t kernel_elements = context->kernel_elements;
+	const struct fxdiv_divisor_size_t kernel_width = context->kernel_width;
+	const struct fxdiv_divisor_size_t output_width = context->output_width;
+	const struct nnp_size output_subsampling = context->output_subsampling;
+
+	const uint8_t* input = context->input;
+	int16_t* packed_input = context->packed_input + output_image_subblock_start * reduction_pairs * 2;
+
+	for (size_t reduction_index = 0; reduction_index < reduction_pairs * 2; reduction_index++)
+	{
+		const size_t packed_offset = (reduction_index / 2 * output_image_subblock_max) * 2 + reduction_index % 2;
+		if (reduction_index >= reduction_size)
+		{
+			for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_max; output_image_subblock_offset++)
+				packed_input[packed_offset + output_image_subblock_offset * 2] = 0;
+			continue;
+		}
+
+		const struct fxdiv_result_size_t reduction_index_divmod = fxdiv_divide_size_t(reduction_index, kernel_elements);
+		const size_t input_channel = reduction_index_divmod.quotient;
+		const struct fxdiv_result_size_t kernel_xy = fxdiv_divide_size_t(reduction_index_divmod.remainder, kernel_width);
+		const size_t kernel_y = kernel_xy.quotient;
+		const size_t kernel_x = kernel_xy.remainder;
+
+		for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_max; output_image_subblock_offset++)
+		{
+			int16_t value = 0;
+			if (output_image_subblock_offset < output_image_subblock_size)
+			{
+				const size_t output_image_index = output_image_block_start + output_image_subblock_start + output_image_subblock_offset;
+				const struct fxdiv_result_size_t output_xy = fxdiv_divide_size_t(output_image_index, output_width);
+				const size_t input_y = output_xy.quotient * output_subsampling.height + kernel_y - input_padding_top;
+				const size_t input_x = output_xy.remainder * output_subsampling.width + kernel_x - input_padding_left;
+				if (input_x < input_size.width && input_y < input_size.height)
+					value = (int16_t) input[(input_channel * input_size.height + input_y) * input_size.width + input_x] - input_zero_point;
+			}
+			packed_input[packed_offset + output_image_subblock_offset * 2] = value;
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN q8_direct_input_packing_context
+{
+	const uint8_t* input;
+	int16_t* packed_input;
+
+	const int16_t input_zero_point;
+	const size_t input_channels;
+	const size_t reduction_pairs;
+	const size_t image_size;
+	const size_t output_image_block_start;
+	const size_t output_image_subblock_max;
+};
+
+/* For unpadded 1x1 convolution with unit stride, the reduction index is the input channel and pixels map one-to-one */
+static void compute_q8_direct_input_packing(
+	const struct q8_direct_input_packing_context* context,
+	const size_t output_image_subblock_start,
+	const size_t output_image_subblock_size)
+{
+	const int16_t input_zero_point = context->input_zero_point;
+	const size_t input_channels = context->input_channels;
+	const size_t reduction_pairs = context->reduction_pairs;
+	const size_t image_size = context->image_size;
+	const size_t output_image_subblock_max = context->output_image_subblock_max;
+
+	const uint8_t* input = context->input + context->output_image_block_start + output_image_subblock_start;
+	int16_t* packed_input = context->packed_input + output_image_subblock_start * reduction_pairs * 2;
+
+	for (size_t input_channel = 0; input_channel < reduction_pairs * 2; input_channel++)
+	{
+		int16_t* packed_row = packed_input + (input_channel / 2 * output_image_subblock_max) * 2 + input_channel % 2;
+		size_t output_image_subblock_offset = 0;
+		if (input_channel < input_channels)
+		{
+			for (; output_image_subblock_offset < output_image_subblock_size; output_image_subblock_offset++)
+				packed_row[output_image_subblock_offset * 2] = (int16_t) input[input_channel * image_size + output_image_subblock_offset] - input_zero_point;
+		}
+		for (; output_image_subblock_offset < output_image_subblock_max; output_image_subblock_offset++)
+			packed_row[output_image_subblock_offset * 2] = 0;
+	}
+}
+
+struct NNP_CACHE_ALIGN q8_matrix_multiplication_context
+{
+	const int16_t* packed_kernel;
+	const int16_t* packed_input;
+	const int32_t* bias;
+	const float* requantization_scale;
+	uint8_t* output;
+
+	const size_t reduction_pairs;
+	const size_t output_image_size;
+	const size_t output_image_block_start;
+	const size_t output_channels_subblock_max;
+	const size_t output_image_subblock_max;
+	const long output_zero_point;
+	const long output_min;
+	const long output_max;
+
+	const nnp_fast_q8gemm_function q8gemm;
+};
+
+/* Multiplies one tile and requantizes it while the int32 accumulators are still in L1 */
+static void compute_q8_matrix_multiplication(
+	const struct q8_matrix_multiplication_context* context,
+	const size_t output_channels_subblock_start,
+	const size_t output_image_subblock_start,
+	const size_t output_channels_subblock_size,
+	const size_t output_image_subblock_size)
+{
+	const size_t reduction_pairs = context->reduction_pairs;
+	const size_t output_image_size = context->output_image_size;
+	const size_t output_image_block_start = context->output_image_block_start;
+	const size_t output_image_subblock_max = context->output_image_subblock_max;
+	const long output_zero_point = context->output_zero_point;
+	const long output_min = context->output_min;
+	const long output_max = context->output_max;
+	const int32_t* bias = context->bias;
+	const float* requantization_scale = context->requantization_scale;
+
+	NNP_SIMD_ALIGN int32_t accumulators[NNP_Q8GEMM_TILE_MAX];
+	context->q8gemm(
+		reduction_pairs, 0,
+		context->packed_kernel + output_channels_subblock_start * reduction_pairs * 2,
+		context->packed_input + output_image_subblock_start * reduction_pairs * 2,
+		accumulators,
+		output_image_subblock_max);
+
+	uint8_t* output = context->output + output_channels_subblock_start * output_image_size + output_image_block_start + output_image_subblock_start;
+	for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++)
+	{
+		const size_t output_channel = output_channels_subblock_start + output_channels_subblock_offset;
+		const int32_t bias_value = (bias != NULL ? bias[output_channel] : 0);
+		/* Accumulators above 2**24 are not exact in single precision, double keeps the product rounded once */
+		const double scale = (double) requantization_scale[output_channel];
+		for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_size; output_image_subblock_offset++)
+		{
+			const int32_t accumulator = accumulators[output_channels_subblock_offset * output_image_subblock_max + output_image_subblock_offset] + bias_value;
+			long value = lrint((double) accumulator * scale) + output_zero_point;
+			value = (value < output_min ? output_min : value);
+			value = (value > output_max ? output_max : value);
+			output[output_channels_subblock_offset * output_image_size + output_image_subblock_offset] = (uint8_t) value;
+		}
+	}
+}
+
+enum nnp_status nnp_convolution_inference_q8(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const uint8_t* input,
+	const uint8_t input_zero_point,
+	const int8_t* kernel,
+	const int32_t* bias,
+	const float* requantization_scale,
+	const uint8_t output_zero_point,
+	const uint8_t output_min,
+	const uint8_t output_max,
+	uint8_t* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
+	struct nnp_profile* profile)
+{
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(1, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, activation, NULL);
+	if (status != nnp_status_success)
+		goto cleanup;
+
+	if (output_min > output_max)
+	{
+		status = nnp_status_invalid_quantization_parameters;
+		goto cleanup;
+	}
+
+	if (nnp_hwinfo.q8gemm.only_mr_x_nr == NULL)
+	{
+		status = nnp_status_unsupported_hardware;
+		goto cleanup;
+	}
+
+	const bool direct_eligible =
+		max(kernel_size.height, kernel_size.width) == 1 &&
+		max(output_subsampling.height, output_subsampling.width) == 1 &&
+		max(max(input_padding.top, input_padding.bottom), max(input_padding.left, input_padding.right)) == 0;
+	switch (algorithm)
+	{
+	case nnp_convolution_algorithm_auto:
+		algorithm = (direct_eligible ? nnp_convolution_algorithm_direct : nnp_convolution_algorithm_implicit_gemm);
+		break;
+	case nnp_convolution_algorithm_implicit_gemm:
+		break;
+	case nnp_convolution_algorithm_direct:
+		if (!direct_eligible)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+		break;
+	case nnp_convolution_algorithm_ft8x8:
+	case nnp_convolution_algorithm_ft16x16:
+	case nnp_convolution_algorithm_ft32x32:
+	case nnp_convolution_algorithm_wt8x8:
+	case nnp_convolution_algorithm_wt8x8_fp16:
+		status = nnp_status_unsupported_algorithm;
+		goto cleanup;
+	default:
+		status = nnp_status_invalid_algorithm;
+		goto cleanup;
+	}
+
+	/* Workspace size queries may pass NULL data pointers */
+	if (requantization_scale != NULL)
+	{
+		for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+		{
+			const float scale = requantization_scale[output_channel];
+			if (!(scale > 0.0f) || !isfinite(scale))
+			{
+				status = nnp_status_invalid_quantization_parameters;
+				goto cleanup;
+			}
+		}
+	}
+
+	const struct nnp_size output_size =
+	{
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+	const size_t output_image_size = output_size.height * output_size.width;
+
+	const size_t output_channels_subblock_max = nnp_hwinfo.q8gemm.mr;
+	const size_t output_image_subblock_max = nnp_hwinfo.q8gemm.nr;
+
+	const size_t reduction_size = input_channels * kernel_size.height * kernel_size.width;
+	const size_t reduction_pairs = divide_round_up(reduction_size, 2);
+	const size_t packed_pair_size = 2 * sizeof(int16_t);
+
+	/* Packed input is blocked over output pixels to fit into L3 cache; packed kernel is not blocked */
+	const size_t output_image_block_max = round_up(
+		max(nnp_hwinfo.blocking.l3 / (reduction_pairs * packed_pair_size), output_image_subblock_max),
+		output_image_subblock_max);
+
+	const size_t packed_kernel_size = round_up(round_up(output_channels, output_channels_subblock_max) * reduction_pairs * packed_pair_size, 64);
+	const size_t packed_input_size = min(output_image_block_max, round_up(output_image_size, output_image_subblock_max)) * reduction_pairs * packed_pair_size;
+	memory_size = packed_kernel_size + packed_input_size;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+			{
+				status = nnp_status_out_of_memory;
+				goto cleanup;
+			}
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			goto cleanup;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+		{
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+
+		memory_block = workspace_buffer;
+	}
+
+	int16_t* packed_kernel = (int16_t*) memory_block;
+	int16_t* packed_input = (int16_t*) ((char*) memory_block + packed_kernel_size);
+
+	NNP_KERNEL_TRANSFORM_START(profile)
+	struct q8_kernel_packing_context kernel_packing_context =
+	{
+		.kernel = kernel,
+		.packed_kernel = packed_kernel,
+		.reduction_size = reduction_size,
+		.reduction_pairs = reduction_pairs,
+		.output_channels = output_channels,
+		.output_channels_subblock_max = output_channels_subblock_max,
+	};
+	pthreadpool_compute_1d_tiled(
+		(pthreadpool_function_1d_tiled_t) compute_q8_kernel_packing,
+		&kernel_packing_context,
+		output_channels, output_channels_subblock_max);
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	const struct fxdiv_divisor_size_t kernel_elements_divisor = fxdiv_init_size_t(kernel_size.height * kernel_size.width);
+	const struct fxdiv_divisor_size_t kernel_width_divisor = fxdiv_init_size_t(kernel_size.width);
+	const struct fxdiv_divisor_size_t output_width_divisor = fxdiv_init_size_t(output_size.width);
+	for (size_t output_image_block_start = 0; output_image_block_start < output_image_size; output_image_block_start += output_image_block_max)
+	{
+		const size_t output_image_block_size = min(output_image_size - output_image_block_start, output_image_block_max);
+
+		NNP_INPUT_TRANSFORM_START(profile)
+		if (algorithm == nnp_convolution_algorithm_direct)
+		{
+			struct q8_direct_input_packing_context input_packing_context =
+			{
+				.input = input,
+				.packed_input = packed_input,
+				.input_zero_point = (int16_t) input_zero_point,
+				.input_channels = input_channels,
+				.reduction_pairs = reduction_pairs,
+				.image_size = output_image_size,
+				.output_image_block_start = output_image_block_start,
+				.output_image_subblock_max = output_image_subblock_max,
+			};
+			pthreadpool_compute_1d_tiled(
+				(pthreadpool_function_1d_tiled_t) compute_q8_direct_input_packing,
+				&input_packing_context,
+				output_image_block_size, output_image_subblock_max);
+		}
+		else
+		{
+			struct q8_input_packing_context input_packing_context =
+			{
+				.input = input,
+				.packed_input = packed_input,
+				.input_zero_point = (int16_t) input_zero_point,
+				.reduction_size = reduction_size,
+				.reduction_pairs = reduction_pairs,
+				.output_image_block_start = output_image_block_start,
+				.output_image_subblock_max = output_image_subblock_max,
+				.input_size = input_size,
+				.input_padding_top = input_padding.top,
+				.input_padding_left = input_padding.left,
+				.kernel_elements = kernel_elements_divisor,
+				.kernel_width = kernel_width_divisor,
+				.output_width = output_width_divisor,
+				.output_subsampling = output_subsampling,
+			};
+			pthreadpool_compute_1d_tiled(
+				(pthreadpool_function_1d_tiled_t) compute_q8_input_packing,
+				&input_packing_context,
+				output_image_block_size, output_image_subblock_max);
+		}
+		NNP_INPUT_TRANSFORM_END(profile)
+
+		NNP_BLOCK_MULTIPLICATION_START(profile)
+		const uint8_t relu_min = (activation == nnp_activation_relu ? output_zero_point : 0);
+		struct q8_matrix_multiplication_context matrix_multiplication_context =
+		{
+			.packed_kernel = packed_kernel,
+			.packed_input = packed_input,
+			.bias = bias,
+			.requantization_scale = requantization_scale,
+			.output = output,
+			.reduction_pairs = reduction_pairs,
+			.output_image_size = output_image_size,
+			.output_image_block_start = output_image_block_start,
+			.output_channels_subblock_max = output_channels_subblock_max,
+			.output_image_subblock_max = output_image_subblock_max,
+			.output_zero_point = (long) output_zero_point,
+			.output_min = (long) max(output_min, relu_min),
+			.output_max = (long) output_max,
+			.q8gemm = nnp_hwinfo.q8gemm.only_mr_x_nr,
+		};
+		pthreadpool_compute_2d_tiled(
+			(pthreadpool_function_2d_tiled_t) compute_q8_matrix_multiplication,
+			&matrix_multiplication_context,
+			output_channels, output_image_block_size,
+			output_channels_subblock_max, output_image_subblock_max);
+		NNP_BLOCK_MULTIPLICATION_END(profile)
+	}
+
+cleanup:
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	NNP_TOTAL_END(profile)
+	return status;
+}
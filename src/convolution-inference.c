@@ -66,7 +66,9 @@ struct NNP_CACHE_ALIGN input_transform_context
 	const nnp_transform_2d_with_offset transform_function;
 
 	const size_t tuple_size;
+	/* Tiles [transform_tiles_start, transform_tiles_start + tiles_count) are stored in input_transform */
 	const size_t tiles_count;
+	const size_t transform_tiles_start;
 	const struct fxdiv_divisor_size_t tiles_x_count;
 	const size_t input_channels_block_start;
 	const size_t input_channels_block_size;
@@ -86,6 +88,7 @@ static void compute_input_transform(
 {
 	const size_t tuple_size = context->tuple_size;
 	const size_t tiles_count = context->tiles_count;
+	const size_t transform_tiles_start = context->transform_tiles_start;
 	const struct fxdiv_divisor_size_t tiles_x_count = context->tiles_x_count;
 	const size_t input_channels_block_start = context->input_channels_block_start;
 	const size_t input_channels_block_size = context->input_channels_block_size;
@@ -120,7 +123,7 @@ static void compute_input_transform(
 
 		transform_function(
 			input + (input_channel * input_size.width * input_size.height) + (input_y * input_size.width) + input_x,
-			input_transform + (tiles_subblock_start * input_channels_block_size + input_channels_block_offset * tiles_subblock_size + tiles_subblock_offset) * tuple_size,
+			input_transform + ((tiles_subblock_start - transform_tiles_start) * input_channels_block_size + input_channels_block_offset * tiles_subblock_size + tiles_subblock_offset) * tuple_size,
 			input_size.width,
 			input_channels_block_size * tiles_count * tuple_size,
 			row_count, column_count,
@@ -134,16 +137,48 @@ struct NNP_CACHE_ALIGN output_transform_context
 	float* output;
 	const void* output_transform;
 	const float* bias;
+	const float* residual;
 
 	const size_t tuple_size;
 	const size_t tiles_count;
+	/* Tiles [transform_tiles_start, transform_tiles_start + transform_tiles_count) are stored in output_transform */
+	const size_t transform_tiles_start;
+	const size_t transform_tiles_count;
 	const struct fxdiv_divisor_size_t tiles_x_count;
 	const struct fxdiv_divisor_size_t tiles_block_max;
 	const size_t output_channels;
 	const struct nnp_size output_size;
 	const struct nnp_size output_tile;
+	const struct nnp_size pooled_size;
+	const enum nnp_activation activation;
+	const enum nnp_convolution_pooling pooling;
 };
 
+/*
+ * 2x2 max-pooling with 2x2 stride of a block which starts at an even row and column.
+ * Windows which cross the bottom or right edge of the block are clipped, as in nnp_max_pooling_output.
+ */
+static inline void max_pool_2x2(
+	const float* input,
+	const size_t input_stride,
+	float* output,
+	const size_t output_stride,
+	const size_t row_count,
+	const size_t column_count)
+{
+	for (size_t row = 0; row < row_count; row += 2)
+	{
+		const float* input_row0 = input + row * input_stride;
+		const float* input_row1 = (row + 1 < row_count ? input_row0 + input_stride : input_row0);
+		for (size_t column = 0; column < column_count; column += 2)
+		{
+			const size_t next_column = (column + 1 < column_count ? column + 1 : column);
+			output[(row / 2) * output_stride + column / 2] =
+				maxf(maxf(input_row0[column], input_row0[next_column]), maxf(input_row1[column], input_row1[next_column]));
+		}
+	}
+}
+
 static void compute_output_transform(
 	const struct output_transform_context* context,
 	const size_t output_channels_subblock_start,
@@ -153,11 +188,16 @@ static void compute_output_transform(
 {
 	const size_t tuple_size = context->tuple_size;
 	const size_t tiles_count = context->tiles_count;
+	const size_t transform_tiles_start = context->transform_tiles_start;
+	const size_t transform_tiles_count = context->transform_tiles_count;
 	const struct fxdiv_divisor_size_t tiles_x_count = context->tiles_x_count;
 	const struct fxdiv_divisor_size_t tiles_block_max = context->tiles_block_max;
 	const size_t output_channels = context->output_channels;
 	const struct nnp_size output_size = context->output_size;
 	const struct nnp_size output_tile = context->output_tile;
+	const struct nnp_size pooled_size = context->pooled_size;
+	const enum nnp_activation activation = context->activation;
+	const enum nnp_convolution_pooling pooling = context->pooling;
 
 	const size_t tiles_block_start = fxdiv_round_down_size_t(tiles_subblock_start, tiles_block_max);
 	const size_t tiles_block_size = min(tiles_count - tiles_block_start, tiles_block_max.value);
@@ -165,6 +205,7 @@ static void compute_output_transform(
 	float* output = context->output;
 	const char* output_transform = (char*)context->output_transform;
 	const float* bias = context->bias;
+	const float* residual = context->residual;
 	const nnp_transform_2d_with_bias transform_function = context->transform_function;
 
 	for (size_t tiles_subblock_offset = 0; tiles_subblock_offset < tiles_subblock_size; tiles_subblock_offset++)
@@ -178,17 +219,57 @@ static void compute_output_transform(
 		const size_t output_x = tile_x * output_tile.width;
 		const size_t output_y = tile_y * output_tile.height;
 
+		const size_t row_count = min(output_tile.height, output_size.height - output_y);
+		const size_t column_count = min(output_tile.width, output_size.width - output_x);
+
 		for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++)
 		{
 			const size_t output_channel = output_channels_subblock_start + output_channels_subblock_offset;
-			transform_function(
-				output_transform + (tiles_block_start * output_channels + output_channels_subblock_start * tiles_block_size + ((tiles_subblock_start - tiles_block_start) + tiles_subblock_offset) * output_channels_subblock_size + output_channels_subblock_offset) * tuple_size,
-				output + (output_channel * output_size.width * output_size.height) + (output_y * output_size.width) + output_x,
-				bias + output_channel,
-				tiles_count * output_channels * tuple_size,
-				output_size.width,
-				min(output_tile.height, output_size.height - output_y),
-				min(output_tile.width, output_size.width - output_x));
+			const size_t output_offset = (output_channel * output_size.width * output_size.height) + (output_y * output_size.width) + output_x;
+			const void* output_transform_tile = output_transform + ((tiles_block_start - transform_tiles_start) * output_channels + output_channels_subblock_start * tiles_block_size + ((tiles_subblock_start - tiles_block_start) + tiles_subblock_offset) * output_channels_subblock_size + output_channels_subblock_offset) * tuple_size;
+
+			switch (pooling)
+			{
+			case nnp_convolution_pooling_none:
+				transform_function(
+					output_transform_tile,
+					output + output_offset,
+					bias + output_channel,
+					transform_tiles_count * output_channels * tuple_size,
+					output_size.width,
+					row_count,
+					column_count);
+
+				if (residual != NULL)
+					add_residual_with_activation(output + output_offset, output_size.width, residual + output_offset, output_size.width, 0.0f, row_count, column_count, activation);
+				break;
+
+			case nnp_convolution_pooling_max_2x2:
+			{
+				/* Full-resolution tile stays on stack, only the pooled tile is stored to output. Sized for the largest (32x32) tile */
+				NNP_SIMD_ALIGN float block[32 * 32];
+				transform_function(
+					output_transform_tile,
+					block,
+					bias + output_channel,
+					transform_tiles_count * output_channels * tuple_size,
+					output_tile.width,
+					row_count,
+					column_count);
+
+				if (residual != NULL)
+					add_residual_with_activation(block, output_tile.width, residual + output_offset, output_size.width, 0.0f, row_count, column_count, activation);
+
+				max_pool_2x2(
+					block, output_tile.width,
+					output + (output_channel * pooled_size.width * pooled_size.height) + (output_y / 2 * pooled_size.width) + output_x / 2, pooled_size.width,
+					row_count, column_count);
+				break;
+			}
+
+			default:
+				NNP_UNREACHABLE;
+			}
 		}
 	}
 }
@@ -197,6 +278,7 @@ struct NNP_CACHE_ALIGN tuple_multiplication_context
 {
 	const size_t tuple_elements;
 	const size_t tuple_size;
+	const size_t kernel_tuple_size;
 	const size_t tiles_subblock_max;
 	const size_t input_channels_block_size;
 	const size_t input_channels_block_start;
@@ -221,6 +303,7 @@ static void compute_tuple_multiplication(
 {
 	const size_t tuple_elements = context->tuple_elements;
 	const size_t tuple_size = context->tuple_size;
+	const size_t kernel_tuple_size = context->kernel_tuple_size;
 	const size_t tiles_subblock_max = context->tiles_subblock_max;
 	const size_t input_channels_block_size = context->input_channels_block_size;
 	const size_t input_channels_block_start = context->input_channels_block_start;
@@ -229,7 +312,7 @@ static void compute_tuple_multiplication(
 	const size_t output_channels_block_start = context->output_channels_block_start;
 
 	const char* input_transform = (char*)context->input_transform + tiles_block_start * input_channels_block_size * tuple_size;
-	const char* kernel_transform = (char*)context->kernel_transform + (output_channels_block_start + output_channels_subblock_start) * input_channels_block_size * tuple_size;
+	const char* kernel_transform = (char*)context->kernel_transform + (output_channels_block_start + output_channels_subblock_start) * input_channels_block_size * kernel_tuple_size;
 	char* output_transform = (char*)context->output_transform + (tiles_block_start * output_channels + (output_channels_block_start + output_channels_subblock_start) * tiles_block_size) * tuple_size;
 
 	if (output_channels_subblock_size == output_channels_subblock_max)
@@ -273,6 +356,321 @@ static void compute_tuple_multiplication(
 	}
 }
 
+/* Selects tuple GEMM micro-kernels for the tuple with the specified index in the transform domain */
+static void select_tuple_gemm_functions(
+	const bool fourier_transform,
+	const bool bypass_fft16x16,
+	const size_t tuple_index,
+	const size_t transform_element_size,
+	const size_t kernel_transform_element_size,
+	nnp_fast_tuple_gemm_function* fast_gemm_function,
+	nnp_full_tuple_gemm_function* full_gemm_function)
+{
+	if (fourier_transform)
+	{
+#ifdef _WIN64
+		if (bypass_fft16x16)
+		{
+			if (tuple_index < NNP_COMPLEX_TUPLE_INDEX)
+			{
+				*fast_gemm_function = nnp_hwinfo.cxgemm_psimd.s4cX_conjb_only_mr_x_nr;
+				*full_gemm_function = nnp_hwinfo.cxgemm_psimd.s4cX_conjb_upto_mr_x_nr;
+			}
+			else
+			{
+				*fast_gemm_function = nnp_hwinfo.cxgemm_psimd.cX_conjb_only_mr_x_nr;
+				*full_gemm_function = nnp_hwinfo.cxgemm_psimd.cX_conjb_upto_mr_x_nr;
+			}
+		}
+		else
+		{
+			if (tuple_index < NNP_COMPLEX_TUPLE_INDEX)
+			{
+				*fast_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_only_mr_x_nr;
+				*full_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_upto_mr_x_nr;
+			}
+			else
+			{
+				*fast_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_only_mr_x_nr;
+				*full_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_upto_mr_x_nr;
+			}
+		}
+#else
+		if (tuple_index < NNP_COMPLEX_TUPLE_INDEX)
+		{
+			*fast_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_only_mr_x_nr;
+			*full_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_upto_mr_x_nr;
+		}
+		else
+		{
+			*fast_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_only_mr_x_nr;
+			*full_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_upto_mr_x_nr;
+		}
+#endif
+	}
+	else
+	{
+		if NNP_LIKELY(transform_element_size == sizeof(float))
+		{
+#if NNP_BACKEND_X86_64
+			if (kernel_transform_element_size == sizeof(uint16_t))
+			{
+				*fast_gemm_function = nnp_hwinfo.sxgemm_fp16b.only_mr_x_nr;
+				*full_gemm_function = nnp_hwinfo.sxgemm_fp16b.upto_mr_x_nr;
+			}
+			else
+#endif /* NNP_BACKEND_X86_64 */
+			{
+				*fast_gemm_function = nnp_hwinfo.sxgemm.only_mr_x_nr;
+				*full_gemm_function = nnp_hwinfo.sxgemm.upto_mr_x_nr;
+			}
+		}
+#if NNP_BACKEND_ARM
+		else
+		{
+			*fast_gemm_function = nnp_hwinfo.hxgemm.only_mr_x_nr;
+			*full_gemm_function = nnp_hwinfo.hxgemm.upto_mr_x_nr;
+		}
+#endif /* NNP_BACKEND_ARM */
+	}
+}
+
+struct NNP_CACHE_ALIGN fused_convolution_context
+{
+	const nnp_transform_2d_with_offset input_transform_function;
+	const nnp_transform_2d_with_bias output_transform_function;
+	const float* input;
+	const void* kernel_transform;
+	const float* bias;
+	const float* residual;
+	float* output;
+	void* scratch;
+
+	const size_t scratch_size;
+	const size_t profile_scratch_size;
+	const size_t input_transform_scratch_size;
+	const bool profile;
+	const size_t threads_count;
+	const bool fourier_transform;
+	const bool bypass_fft16x16;
+	const size_t transform_element_size;
+	const size_t kernel_transform_element_size;
+	const size_t tuple_elements;
+	const size_t tuple_size;
+	const size_t kernel_tuple_size;
+	const size_t tuple_count;
+	const size_t kernel_transform_tile_size;
+	const size_t tiles_count;
+	const struct fxdiv_divisor_size_t tiles_x_count;
+	const struct fxdiv_divisor_size_t tiles_block_max;
+	const size_t tiles_subblock_max;
+	const size_t input_channels;
+	const size_t input_channels_block_max;
+	const size_t output_channels;
+	const size_t output_channels_block_max;
+	const size_t output_channels_subblock_max;
+	const struct nnp_size input_size;
+	const size_t input_padding_left;
+	const size_t input_padding_top;
+	const struct nnp_size input_tile;
+	const struct nnp_size input_tile_step;
+	const struct nnp_size output_size;
+	const struct nnp_size output_tile;
+	const struct nnp_size pooled_size;
+	const enum nnp_activation activation;
+	const enum nnp_convolution_pooling pooling;
+};
+
+/*
+ * Runs input transform, tuple multiplication and output transform for one block of tiles at a time,
+ * so that the transformed block never leaves the cache of the thread which produced it.
+ * Each worker processes every threads_count-th tile block in its own slice of scratch memory,
+ * which starts with the time the worker spent in each phase. The worker goes over its tile blocks once per block
+ * of output channels, so the kernel transform of that block is reused from cache by all of them.
+ */
+static void compute_fused_convolution(
+	const struct fused_convolution_context* context,
+	const size_t thread_index)
+{
+	const size_t tuple_size = context->tuple_size;
+	const size_t kernel_tuple_size = context->kernel_tuple_size;
+	const size_t tuple_count = context->tuple_count;
+	const size_t kernel_transform_tile_size = context->kernel_transform_tile_size;
+	const size_t tiles_count = context->tiles_count;
+	const size_t tiles_block_max = context->tiles_block_max.value;
+	const size_t tiles_subblock_max = context->tiles_subblock_max;
+	const size_t input_channels = context->input_channels;
+	const size_t input_channels_block_max = context->input_channels_block_max;
+	const size_t output_channels = context->output_channels;
+	const size_t output_channels_block_max = context->output_channels_block_max;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const size_t threads_count = context->threads_count;
+	const struct nnp_size output_size = context->output_size;
+	const struct nnp_size pooled_size = context->pooled_size;
+	const size_t output_channel_size = (context->pooling == nnp_convolution_pooling_none ?
+		output_size.height * output_size.width : pooled_size.height * pooled_size.width);
+
+	char* scratch = (char*)context->scratch + thread_index * context->scratch_size;
+	struct nnp_profile* profile = (context->profile ? (struct nnp_profile*) scratch : NULL);
+	char* input_transform = scratch + context->profile_scratch_size;
+	char* output_transform = input_transform + context->input_transform_scratch_size;
+	if (profile != NULL)
+		*profile = (struct nnp_profile) { 0.0 };
+
+	for (size_t output_channels_block_start = 0; output_channels_block_start < output_channels; output_channels_block_start += output_channels_block_max)
+	{
+		const size_t output_channels_block_size = min(output_channels - output_channels_block_start, output_channels_block_max);
+
+		for (size_t tiles_block_start = thread_index * tiles_block_max; tiles_block_start < tiles_count; tiles_block_start += threads_count * tiles_block_max)
+		{
+			const size_t tiles_block_size = min(tiles_count - tiles_block_start, tiles_block_max);
+
+			for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max)
+			{
+				const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+
+				NNP_INPUT_TRANSFORM_START(profile)
+				struct input_transform_context input_transform_context =
+				{
+					.input = context->input,
+					.input_transform = input_transform,
+					.transform_function = context->input_transform_function,
+					.tuple_size = tuple_size,
+					.tiles_count = tiles_block_size,
+					.transform_tiles_start = tiles_block_start,
+					.tiles_x_count = context->tiles_x_count,
+					.input_channels_block_start = input_channels_block_start,
+					.input_channels_block_size = input_channels_block_size,
+					.input_size = context->input_size,
+					.input_padding_left = context->input_padding_left,
+					.input_padding_top = context->input_padding_top,
+					.input_tile = context->input_tile,
+					.input_tile_step = context->input_tile_step
+				};
+				for (size_t input_channels_block_offset = 0; input_channels_block_offset < input_channels_block_size; input_channels_block_offset++)
+				{
+					for (size_t tiles_subblock_start = tiles_block_start; tiles_subblock_start < tiles_block_start + tiles_block_size; tiles_subblock_start += tiles_subblock_max)
+					{
+						compute_input_transform(&input_transform_context,
+							input_channels_block_offset, tiles_subblock_start,
+							1, min(tiles_block_start + tiles_block_size - tiles_subblock_start, tiles_subblock_max));
+					}
+				}
+				NNP_INPUT_TRANSFORM_END(profile)
+
+				NNP_BLOCK_MULTIPLICATION_START(profile)
+				const char* kernel_transform = (const char*)context->kernel_transform +
+					input_channels_block_start * output_channels * kernel_transform_tile_size +
+					output_channels_block_start * input_channels_block_size * kernel_tuple_size;
+				for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index++)
+				{
+					nnp_fast_tuple_gemm_function fast_gemm_function = NULL;
+					nnp_full_tuple_gemm_function full_gemm_function = NULL;
+					select_tuple_gemm_functions(
+						context->fourier_transform, context->bypass_fft16x16, tuple_index,
+						context->transform_element_size, context->kernel_transform_element_size,
+						&fast_gemm_function, &full_gemm_function);
+
+					/* Output transform scratch holds only the current block of output channels */
+					struct tuple_multiplication_context tuple_multiplication_context =
+					{
+						.tuple_elements = context->tuple_elements,
+						.tuple_size = tuple_size,
+						.kernel_tuple_size = kernel_tuple_size,
+						.tiles_subblock_max = tiles_subblock_max,
+						.input_channels_block_size = input_channels_block_size,
+						.input_channels_block_start = input_channels_block_start,
+						.output_channels = output_channels_block_size,
+						.output_channels_subblock_max = output_channels_subblock_max,
+						.output_channels_block_start = 0,
+						.input_transform = input_transform + tuple_index * tiles_block_size * input_channels_block_size * tuple_size,
+						.kernel_transform = kernel_transform + tuple_index * output_channels * input_channels_block_size * kernel_tuple_size,
+						.output_transform = output_transform + tuple_index * tiles_block_size * output_channels_block_size * tuple_size,
+						.fast_gemm = fast_gemm_function,
+						.full_gemm = full_gemm_function
+					};
+					for (size_t output_channels_subblock_start = 0; output_channels_subblock_start < output_channels_block_size; output_channels_subblock_start += output_channels_subblock_max)
+					{
+						compute_tuple_multiplication(&tuple_multiplication_context,
+							0, output_channels_subblock_start,
+							tiles_block_size, min(output_channels_block_size - output_channels_subblock_start, output_channels_subblock_max));
+					}
+				}
+				NNP_BLOCK_MULTIPLICATION_END(profile)
+			}
+
+			NNP_OUTPUT_TRANSFORM_START(profile)
+			struct output_transform_context output_transform_context =
+			{
+				.transform_function = context->output_transform_function,
+				.output = context->output + output_channels_block_start * output_channel_size,
+				.output_transform = output_transform,
+				.bias = context->bias + output_channels_block_start,
+				.residual = (context->residual == NULL ? NULL : context->residual + output_channels_block_start * output_size.height * output_size.width),
+				.tuple_size = tuple_size,
+				.tiles_count = tiles_count,
+				.transform_tiles_start = tiles_block_start,
+				.transform_tiles_count = tiles_block_size,
+				.tiles_x_count = context->tiles_x_count,
+				.tiles_block_max = context->tiles_block_max,
+				.output_channels = output_channels_block_size,
+				.output_size = output_size,
+				.output_tile = context->output_tile,
+				.pooled_size = pooled_size,
+				.activation = context->activation,
+				.pooling = context->pooling
+			};
+			for (size_t output_channels_subblock_start = 0; output_channels_subblock_start < output_channels_block_size; output_channels_subblock_start += output_channels_subblock_max)
+			{
+				for (size_t tiles_subblock_start = tiles_block_start; tiles_subblock_start < tiles_block_start + tiles_block_size; tiles_subblock_start += tiles_subblock_max)
+				{
+					compute_output_transform(&output_transform_context,
+						output_channels_subblock_start, tiles_subblock_start,
+						min(output_channels_block_size - output_channels_subblock_start, output_channels_subblock_max),
+						min(tiles_block_start + tiles_block_size - tiles_subblock_start, tiles_subblock_max));
+				}
+			}
+			NNP_OUTPUT_TRANSFORM_END(profile)
+		}
+	}
+}
+
+/* Transforms the kernel for all input channels, stored in blocks of input channels as for nnp_convolution_transform_strategy_precompute */
+static void transform_kernel_blocks(
+	const nnp_transform_2d_with_offset kernel_transform_function,
+	const float* kernel,
+	void* kernel_transform,
+	const size_t kernel_tuple_size,
+	const size_t kernel_transform_tile_size,
+	const size_t input_channels,
+	const size_t input_channels_block_max,
+	const size_t output_channels,
+	const size_t output_channels_subblock_max,
+	const struct nnp_size kernel_size)
+{
+	for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max)
+	{
+		const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+
+		struct kernel_transform_context kernel_transform_context =
+		{
+			.transform_function = kernel_transform_function,
+			.kernel = kernel + input_channels_block_start * kernel_size.height * kernel_size.width,
+			.kernel_transform = (char*)kernel_transform + input_channels_block_start * output_channels * kernel_transform_tile_size,
+			.tuple_size = kernel_tuple_size,
+			.input_channels = input_channels,
+			.input_channels_block_size = input_channels_block_size,
+			.output_channels = output_channels,
+			.kernel_size = kernel_size
+		};
+		pthreadpool_compute_2d_tiled(
+			(pthreadpool_function_2d_tiled_t)compute_kernel_transform,
+			&kernel_transform_context,
+			output_channels, input_channels_block_size,
+			output_channels_subblock_max, 1);
+	}
+}
+
 struct NNP_CACHE_ALIGN kernel_packing_context
 {
 	const float* kernel;
@@ -281,6 +679,8 @@ struct NNP_CACHE_ALIGN kernel_packing_context
 	const size_t reduction_size;
 	const size_t reduction_block_start;
 	const size_t reduction_block_size;
+	/* Subblocks past output_channels are zero-filled when the packed kernel is padded to full micro-kernel tiles */
+	const size_t output_channels;
 };
 
 static void compute_kernel_packing(
@@ -293,12 +693,18 @@ static void compute_kernel_packing(
 	const size_t reduction_size = context->reduction_size;
 	const size_t reduction_block_start = context->reduction_block_start;
 	const size_t reduction_block_size = context->reduction_block_size;
+	const size_t output_channels = context->output_channels;
 
 	const float* kernel = context->kernel + output_channels_subblock_start * reduction_size + reduction_block_offset;
 	float* packed_kernel = context->packed_kernel + output_channels_subblock_start * reduction_block_size + reduction_block_offset * output_channels_subblock_size;
 
 	for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++)
-		packed_kernel[output_channels_subblock_offset] = kernel[output_channels_subblock_offset * reduction_size];
+	{
+		if (output_channels_subblock_start + output_channels_subblock_offset < output_channels)
+			packed_kernel[output_channels_subblock_offset] = kernel[output_channels_subblock_offset * reduction_size];
+		else
+			packed_kernel[output_channels_subblock_offset] = 0.0f;
+	}
 }
 
 struct NNP_CACHE_ALIGN input_packing_context
@@ -441,6 +847,163 @@ static void compute_matrix_multiplication(
 	}
 }
 
+/* Largest mr x nr tile among indirect sgemm micro-kernels */
+#define NNP_SGEMM_INDIRECT_TILE_MAX 64
+
+struct NNP_CACHE_ALIGN indirection_context
+{
+	int32_t* indirection;
+
+	const size_t kernel_elements;
+	const size_t output_image_subblock_max;
+	const size_t output_image_block_start;
+	const struct nnp_size input_size;
+	const size_t input_padding_top;
+	const size_t input_padding_left;
+	const struct nnp_size kernel_size;
+	const struct fxdiv_divisor_size_t output_width;
+	const struct nnp_size output_subsampling;
+};
+
+/*
+ * Builds indirection[output_image_subblock][kernel_element][output_image_subblock_max] for one output image block:
+ * offsets of input pixels within a channel. Pixels in padding, and output pixels past the end of the image, get offset -1
+ * and read as zero.
+ */
+static void compute_indirection(
+	const struct indirection_context* context,
+	const size_t output_image_subblock_start,
+	const size_t output_image_subblock_size)
+{
+	const size_t kernel_elements = context->kernel_elements;
+	const size_t output_image_subblock_max = context->output_image_subblock_max;
+	const size_t output_image_block_start = context->output_image_block_start;
+	const struct nnp_size input_size = context->input_size;
+	const size_t input_padding_top = context->input_padding_top;
+	const size_t input_padding_left = context->input_padding_left;
+	const struct nnp_size kernel_size = context->kernel_size;
+	const struct fxdiv_divisor_size_t output_width = context->output_width;
+	const struct nnp_size output_subsampling = context->output_subsampling;
+
+	int32_t* indirection = context->indirection + output_image_subblock_start * kernel_elements;
+
+	for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_max; output_image_subblock_offset++)
+	{
+		if (output_image_subblock_offset >= output_image_subblock_size)
+		{
+			for (size_t kernel_element = 0; kernel_element < kernel_elements; kernel_element++)
+				indirection[kernel_element * output_image_subblock_max + output_image_subblock_offset] = -1;
+			continue;
+		}
+
+		const struct fxdiv_result_size_t output_xy = fxdiv_divide_size_t(output_image_block_start + output_image_subblock_start + output_image_subblock_offset, output_width);
+		for (size_t kernel_y = 0; kernel_y < kernel_size.height; kernel_y++)
+		{
+			const size_t input_y = output_xy.quotient * output_subsampling.height + kernel_y - input_padding_top;
+			for (size_t kernel_x = 0; kernel_x < kernel_size.width; kernel_x++)
+			{
+				const size_t input_x = output_xy.remainder * output_subsampling.width + kernel_x - input_padding_left;
+				const size_t kernel_element = kernel_y * kernel_size.width + kernel_x;
+				if (input_x < input_size.width && input_y < input_size.height)
+					indirection[kernel_element * output_image_subblock_max + output_image_subblock_offset] = (int32_t) (input_y * input_size.width + input_x);
+				else
+					indirection[kernel_element * output_image_subblock_max + output_image_subblock_offset] = -1;
+			}
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN indirect_matrix_multiplication_context
+{
+	const float* packed_kernel;
+	const float* input;
+	const int32_t* indirection;
+	float* output;
+
+	const size_t reduction_block_start;
+	const size_t reduction_block_size;
+	const size_t input_channels_block_size;
+	const size_t kernel_elements;
+	const size_t channel_stride;
+	const size_t output_image_size;
+	const size_t output_image_subblock_max;
+	const size_t output_channels_subblock_max;
+
+	const nnp_fast_indirect_sgemm_function indirect_gemm;
+};
+
+static void compute_indirect_matrix_multiplication(
+	const struct indirect_matrix_multiplication_context* context,
+	const size_t output_channels_block_start,
+	const size_t output_image_subblock_start,
+	size_t output_channels_block_size,
+	const size_t output_image_subblock_size)
+{
+	const size_t reduction_block_start = context->reduction_block_start;
+	const size_t reduction_block_size = context->reduction_block_size;
+	const size_t input_channels_block_size = context->input_channels_block_size;
+	const size_t kernel_elements = context->kernel_elements;
+	const size_t channel_stride = context->channel_stride;
+	const size_t output_image_size = context->output_image_size;
+	const size_t output_image_subblock_max = context->output_image_subblock_max;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const nnp_fast_indirect_sgemm_function indirect_gemm = context->indirect_gemm;
+
+	const float* packed_kernel = context->packed_kernel + output_channels_block_start * reduction_block_size;
+	const int32_t* indirection = context->indirection + output_image_subblock_start * kernel_elements;
+	float* output = context->output + output_channels_block_start * output_image_size + output_image_subblock_start;
+
+	while (output_channels_block_size != 0)
+	{
+		const size_t output_channels_subblock_size = min(output_channels_block_size, output_channels_subblock_max);
+		output_channels_block_size -= output_channels_subblock_size;
+
+		if (output_channels_subblock_size == output_channels_subblock_max && output_image_subblock_size == output_image_subblock_max)
+		{
+			indirect_gemm(
+				input_channels_block_size,
+				reduction_block_start,
+				packed_kernel,
+				context->input,
+				indirection,
+				kernel_elements,
+				channel_stride,
+				output,
+				output_image_size);
+		}
+		else
+		{
+			/* Packed kernel and indirection buffer are padded to full tiles: compute the full tile and store its valid part */
+			NNP_SIMD_ALIGN float block[NNP_SGEMM_INDIRECT_TILE_MAX];
+			indirect_gemm(
+				input_channels_block_size,
+				0,
+				packed_kernel,
+				context->input,
+				indirection,
+				kernel_elements,
+				channel_stride,
+				block,
+				output_image_subblock_max);
+
+			for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++)
+			{
+				for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_size; output_image_subblock_offset++)
+				{
+					const float value = block[output_channels_subblock_offset * output_image_subblock_max + output_image_subblock_offset];
+					if (reduction_block_start == 0)
+						output[output_channels_subblock_offset * output_image_size + output_image_subblock_offset] = value;
+					else
+						output[output_channels_subblock_offset * output_image_size + output_image_subblock_offset] += value;
+				}
+			}
+		}
+
+		packed_kernel += reduction_block_size * output_channels_subblock_max;
+		output += output_image_size * output_channels_subblock_max;
+	}
+}
+
 struct NNP_CACHE_ALIGN direct_convolution_context
 {
 	const float* input;
@@ -512,10 +1075,146 @@ static void compute_direct_convolution(
 	}
 }
 
+struct fast_convolution_blocking
+{
+	bool bypass_fft16x16;
+	size_t simd_width;
+	size_t tiles_subblock_max;
+	size_t output_channels_subblock_max;
+	size_t input_channels_block_max;
+	size_t tiles_block_max;
+	size_t output_channels_block_max;
+};
+
+/* Cache blocking of the tuple GEMM: input channels of a micro-kernel tile fit L1, a tile block fits L2 and an output channel block fits L3 */
+static struct fast_convolution_blocking get_fast_convolution_blocking(
+	const bool fourier_transform,
+	const size_t transform_element_size,
+	const struct nnp_size tile_size)
+{
+	struct fast_convolution_blocking blocking;
+#ifdef _WIN64
+	blocking.bypass_fft16x16 = tile_size.width == 16 && nnp_hwinfo.simd_width == 8;
+	blocking.simd_width = blocking.bypass_fft16x16 ? 4 : nnp_hwinfo.simd_width;
+	blocking.tiles_subblock_max = fourier_transform ? (blocking.bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.mr : nnp_hwinfo.cxgemm.mr) : nnp_hwinfo.sxgemm.mr;
+	blocking.output_channels_subblock_max = fourier_transform ? (blocking.bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.nr : nnp_hwinfo.cxgemm.nr) : nnp_hwinfo.sxgemm.nr;
+#else
+	blocking.bypass_fft16x16 = false;
+	blocking.simd_width = nnp_hwinfo.simd_width;
+	blocking.tiles_subblock_max = (fourier_transform ? nnp_hwinfo.cxgemm.mr : nnp_hwinfo.sxgemm.mr);
+	blocking.output_channels_subblock_max = (fourier_transform ? nnp_hwinfo.cxgemm.nr : nnp_hwinfo.sxgemm.nr);
+#endif
+
+	const size_t tuple_size = (fourier_transform ? blocking.simd_width * 2 : blocking.simd_width) * transform_element_size;
+	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / tuple_size;
+	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / tuple_size;
+	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / tuple_size;
+
+	blocking.input_channels_block_max = round_down(cache_elements_l1 / (blocking.tiles_subblock_max + blocking.output_channels_subblock_max), 2);
+	blocking.tiles_block_max = round_down(cache_elements_l2 / blocking.input_channels_block_max, blocking.tiles_subblock_max);
+	blocking.output_channels_block_max = round_down(cache_elements_l3 / blocking.input_channels_block_max, blocking.output_channels_subblock_max);
+	return blocking;
+}
+
+/*
+ * The fused schedule transforms input tiles again for every block of output channels. Transforming a tile of one channel
+ * costs as much as multiplying it by 3-6 output channels, so with 64 or more output channels per block the repeated
+ * transforms stay within a tenth of the tuple GEMM.
+ */
+#define NNP_FUSED_OUTPUT_CHANNELS_BLOCK_MIN 64
+
+struct fast_convolution_schedule
+{
+	bool fused;
+	size_t fused_tiles_block_max;
+	size_t fused_tiles_blocks_count;
+	size_t fused_output_channels_block_max;
+	size_t tiles_block_max;
+	size_t output_channels_block_max;
+};
+
+/*
+ * Tile-fused schedule: each thread transforms, multiplies and inverse-transforms a block of tiles sized to L2,
+ * so only per-thread scratch is needed. It is used when the staged transform buffers spill out of the L2 caches
+ * and there are enough tile blocks to occupy all threads; smaller layers parallelize better over output channels.
+ * Each thread walks its tile blocks once per block of output channels, so the kernel transform of the block stays in
+ * cache across them instead of being streamed from memory for every tile block. The block is sized to half of L2,
+ * or, if that holds too few output channels, to half of the shared L3, which threads walking the same block share.
+ * Tile blocks and their transforms take the other half of L2.
+ */
+static struct fast_convolution_schedule get_fast_convolution_schedule(
+	const struct fast_convolution_blocking* blocking,
+	const size_t input_channels,
+	const size_t output_channels,
+	const size_t tiles_count,
+	const size_t transform_tile_size,
+	const size_t kernel_transform_tile_size,
+	const size_t threads_count)
+{
+	struct fast_convolution_schedule schedule;
+	const size_t input_channels_block_size = min(input_channels, blocking->input_channels_block_max);
+	const size_t input_transform_size = tiles_count * input_channels_block_size * transform_tile_size;
+	const size_t output_transform_size = tiles_count * output_channels * transform_tile_size;
+
+	const size_t output_channel_kernel_transform_size = input_channels * kernel_transform_tile_size;
+	size_t fused_output_channels_block_max =
+		round_down(nnp_hwinfo.blocking.l2 / 2 / output_channel_kernel_transform_size, blocking->output_channels_subblock_max);
+	if (fused_output_channels_block_max < NNP_FUSED_OUTPUT_CHANNELS_BLOCK_MIN)
+	{
+		fused_output_channels_block_max =
+			round_down(nnp_hwinfo.blocking.l3 / 2 / output_channel_kernel_transform_size, blocking->output_channels_subblock_max);
+		/* A block which fits no cache would only repeat input transforms: keep all output channels together then */
+		if (fused_output_channels_block_max < NNP_FUSED_OUTPUT_CHANNELS_BLOCK_MIN)
+			fused_output_channels_block_max = output_channels;
+	}
+	schedule.fused_output_channels_block_max = min(fused_output_channels_block_max, output_channels);
+	schedule.fused_tiles_block_max = max(
+		round_down(nnp_hwinfo.blocking.l2 / 2 / ((input_channels_block_size + schedule.fused_output_channels_block_max) * transform_tile_size),
+			blocking->tiles_subblock_max),
+		blocking->tiles_subblock_max);
+	schedule.fused_tiles_blocks_count = divide_round_up(tiles_count, schedule.fused_tiles_block_max);
+	schedule.fused =
+		input_transform_size + output_transform_size > threads_count * nnp_hwinfo.blocking.l2 &&
+		schedule.fused_tiles_blocks_count >= threads_count;
+	schedule.tiles_block_max = (schedule.fused ? schedule.fused_tiles_block_max : blocking->tiles_block_max);
+	schedule.output_channels_block_max = (schedule.fused ? schedule.fused_output_channels_block_max : blocking->output_channels_block_max);
+	return schedule;
+}
+
+/* Storage size of input/output and kernel transforms; only wt8x8_fp16 stores them in half precision */
+static void get_fast_convolution_element_sizes(
+	const enum nnp_convolution_algorithm algorithm,
+	const enum nnp_activation transform_activation,
+	size_t* transform_element_size,
+	size_t* kernel_transform_element_size)
+{
+	*transform_element_size = sizeof(float);
+	*kernel_transform_element_size = sizeof(float);
+	if (algorithm != nnp_convolution_algorithm_wt8x8_fp16)
+		return;
+
+#if NNP_BACKEND_ARM
+	const nnp_transform_2d_with_bias output_transform_function = (transform_activation == nnp_activation_relu ?
+		nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias_with_relu : nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias);
+	if (nnp_hwinfo.transforms.iwt_f6x6_3x3_fp16_with_offset != NULL &&
+		nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16 != NULL &&
+		output_transform_function != NULL)
+	{
+		*transform_element_size = sizeof(uint16_t);
+		*kernel_transform_element_size = sizeof(uint16_t);
+	}
+#elif NNP_BACKEND_X86_64
+	/* With F16C, only the kernel transform is stored in fp16 */
+	if (nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16 != NULL)
+		*kernel_transform_element_size = sizeof(uint16_t);
+#endif
+}
+
 static enum nnp_status compute_fast_convolution_inference(
 	const bool fourier_transform,
 	const enum nnp_convolution_transform_strategy transform_strategy,
 	const size_t transform_element_size,
+	const size_t kernel_transform_element_size,
 	const size_t input_channels,
 	const size_t output_channels,
 	const struct nnp_size tile_size,
@@ -527,97 +1226,219 @@ static enum nnp_status compute_fast_convolution_inference(
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const nnp_transform_2d_with_offset input_transform_function,
 	const nnp_transform_2d_with_offset kernel_transform_function,
 	const nnp_transform_2d_with_bias output_transform_function,
+	const enum nnp_activation activation,
+	const enum nnp_convolution_pooling pooling,
 	struct nnp_profile* profile)
 {
 	void* memory_block = NULL;
 	size_t memory_size = 0;
-	
-#ifdef _WIN64
-	const bool bypass_fft16x16 = tile_size.width == 16 && nnp_hwinfo.simd_width == 8;
-	const size_t simd_width = bypass_fft16x16 ? 4 : nnp_hwinfo.simd_width;
-#else
-	const size_t simd_width = nnp_hwinfo.simd_width;
-#endif
+
+	const struct fast_convolution_blocking blocking = get_fast_convolution_blocking(fourier_transform, transform_element_size, tile_size);
+	const bool bypass_fft16x16 = blocking.bypass_fft16x16;
+	const size_t simd_width = blocking.simd_width;
 	const size_t tuple_elements = (fourier_transform ? simd_width * 2 : simd_width);
 	const size_t tuple_size = tuple_elements * transform_element_size;
+	const size_t kernel_tuple_size = tuple_elements * kernel_transform_element_size;
 	const size_t tile_elements = tile_size.height * tile_size.width;
 	const size_t tuple_count = tile_elements / tuple_elements;
 
-	const struct nnp_size output_tile_size =
+	struct nnp_size output_tile_size =
 	{
 		.width = (tile_size.width - kernel_size.width) / output_subsampling.width + 1,
 		.height = (tile_size.height - kernel_size.height) / output_subsampling.height + 1
 	};
-	const struct nnp_size tile_step =
+	struct nnp_size tile_step =
 	{
 		.width = tile_size.width - kernel_size.width + 1,
 		.height = tile_size.height - kernel_size.height + 1
 	};
+	if (pooling != nnp_convolution_pooling_none)
+	{
+		/* Pooling windows must not cross tile boundaries: shrink output tiles to even size and step input tiles accordingly */
+		output_tile_size.width = round_down(output_tile_size.width, 2);
+		output_tile_size.height = round_down(output_tile_size.height, 2);
+		if (output_tile_size.width == 0 || output_tile_size.height == 0)
+			return nnp_status_unsupported_algorithm;
+
+		tile_step.width = output_tile_size.width * output_subsampling.width;
+		tile_step.height = output_tile_size.height * output_subsampling.height;
+	}
+	const struct nnp_size pooled_size =
+	{
+		.width = divide_round_up(output_size.width, 2),
+		.height = divide_round_up(output_size.height, 2)
+	};
 
 	const size_t tiles_y_count = divide_round_up(output_size.height, output_tile_size.height);
 	const size_t tiles_x_count = divide_round_up(output_size.width, output_tile_size.width);
 	const size_t tiles_count = tiles_x_count * tiles_y_count;
 
-	/* Calculate cache blocking parameters */
-	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / tuple_size;
-	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / tuple_size;
-	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / tuple_size;
-
-#ifdef _WIN64
-	const size_t tiles_subblock_max = fourier_transform ? (bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.mr : nnp_hwinfo.cxgemm.mr) : nnp_hwinfo.sxgemm.mr;
-	const size_t output_channels_subblock_max = fourier_transform ? (bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.nr : nnp_hwinfo.cxgemm.nr) : nnp_hwinfo.sxgemm.nr;
-#else
-	const size_t tiles_subblock_max = (fourier_transform ? nnp_hwinfo.cxgemm.mr : nnp_hwinfo.sxgemm.mr);
-	const size_t output_channels_subblock_max = (fourier_transform ? nnp_hwinfo.cxgemm.nr : nnp_hwinfo.sxgemm.nr);
-#endif
-
-	const size_t input_channels_block_max = round_down(cache_elements_l1 / (tiles_subblock_max + output_channels_subblock_max), 2);
-	const size_t tiles_block_max = round_down(cache_elements_l2 / input_channels_block_max, tiles_subblock_max);
-	const size_t output_channels_block_max = round_down(cache_elements_l3 / input_channels_block_max, output_channels_subblock_max);
+	/* Cache blocking parameters */
+	const size_t tiles_subblock_max = blocking.tiles_subblock_max;
+	const size_t output_channels_subblock_max = blocking.output_channels_subblock_max;
+	const size_t input_channels_block_max = blocking.input_channels_block_max;
+	const size_t tiles_block_max = blocking.tiles_block_max;
+	const size_t output_channels_block_max = blocking.output_channels_block_max;
 
 	const size_t transform_tile_size = tile_elements * transform_element_size;
+	const size_t kernel_transform_tile_size = tile_elements * kernel_transform_element_size;
 	const size_t input_transform_size = tiles_count * min(input_channels, input_channels_block_max) * transform_tile_size;
 	const size_t output_transform_size = tiles_count * output_channels * transform_tile_size;
 
+	const size_t threads_count = pthreadpool_get_threads_count();
+	const struct fast_convolution_schedule schedule = get_fast_convolution_schedule(
+		&blocking, input_channels, output_channels, tiles_count, transform_tile_size, kernel_transform_tile_size, threads_count);
+	const bool fused_schedule = schedule.fused;
+	const size_t fused_tiles_block_max = schedule.fused_tiles_block_max;
+	const size_t fused_output_channels_block_max = schedule.fused_output_channels_block_max;
+	/* Per-thread scratch of the fused schedule: profile counters, then input and output transforms of a tile block */
+	const size_t fused_profile_scratch_size = round_up(sizeof(struct nnp_profile), 64);
+	const size_t fused_input_transform_scratch_size = round_up(fused_tiles_block_max * min(input_channels, input_channels_block_max) * transform_tile_size, 64);
+	const size_t fused_scratch_size = fused_profile_scratch_size + fused_input_transform_scratch_size +
+		round_up(fused_tiles_block_max * fused_output_channels_block_max * transform_tile_size, 64);
+
+	/*
+	 * Fused schedule computes kernel transform for all channels upfront: every thread consumes all of it, one block of
+	 * output channels at a time, and transforming it per thread or per block would repeat the work.
+	 */
+	const size_t fused_kernel_transform_size = (transform_strategy == nnp_convolution_transform_strategy_compute ?
+		round_up(output_channels * input_channels * kernel_transform_tile_size, 64) : 0);
+	const size_t staged_kernel_transform_size = (transform_strategy == nnp_convolution_transform_strategy_compute ?
+		output_channels * min(input_channels, input_channels_block_max) * kernel_transform_tile_size : 0);
+	const size_t staged_memory_size = input_transform_size + output_transform_size + staged_kernel_transform_size;
+
 	switch (transform_strategy)
 	{
 	case nnp_convolution_transform_strategy_compute:
 	case nnp_convolution_transform_strategy_reuse:
+	memory_size = (fused_schedule ? fused_kernel_transform_size + threads_count * fused_scratch_size : staged_memory_size);
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			/*
+			 * Report the larger of the two schedules, so that the size does not depend on the thread count which
+			 * picks the schedule: the fused schedule is only used with at most one thread per block of tiles.
+			 */
+			*workspace_size = max(staged_memory_size,
+				fused_kernel_transform_size + schedule.fused_tiles_blocks_count * fused_scratch_size);
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	if (fused_schedule)
 	{
-		memory_size = input_transform_size + output_transform_size;
-		const size_t kernel_transform_size = output_channels * min(input_channels, input_channels_block_max) * transform_tile_size;
+		const void* kernel_transform = kernel;
 		if (transform_strategy == nnp_convolution_transform_strategy_compute)
-			memory_size += kernel_transform_size;
+		{
+			NNP_KERNEL_TRANSFORM_START(profile)
+			transform_kernel_blocks(
+				kernel_transform_function, kernel, memory_block,
+				kernel_tuple_size, kernel_transform_tile_size,
+				input_channels, input_channels_block_max,
+				output_channels, output_channels_subblock_max,
+				kernel_size);
+			NNP_KERNEL_TRANSFORM_END(profile)
 
-		if (workspace_buffer == NULL)
+			kernel_transform = memory_block;
+		}
+
+		/* Transforms and multiplication are interleaved per tile block; workers time each phase in their scratch */
+		const double fused_start = (profile != NULL ? read_timer() : 0.0);
+		struct fused_convolution_context fused_convolution_context =
 		{
-			if (workspace_size == NULL)
-			{
-				memory_block = allocate_memory(memory_size);
-				if (memory_block == NULL)
-					return nnp_status_out_of_memory;
+			.input_transform_function = input_transform_function,
+			.output_transform_function = output_transform_function,
+			.input = input,
+			.kernel_transform = kernel_transform,
+			.bias = bias,
+			.residual = residual,
+			.output = output,
+			.scratch = (char*)memory_block + fused_kernel_transform_size,
+			.scratch_size = fused_scratch_size,
+			.profile_scratch_size = fused_profile_scratch_size,
+			.input_transform_scratch_size = fused_input_transform_scratch_size,
+			.profile = profile != NULL,
+			.threads_count = threads_count,
+			.fourier_transform = fourier_transform,
+			.bypass_fft16x16 = bypass_fft16x16,
+			.transform_element_size = transform_element_size,
+			.kernel_transform_element_size = kernel_transform_element_size,
+			.tuple_elements = tuple_elements,
+			.tuple_size = tuple_size,
+			.kernel_tuple_size = kernel_tuple_size,
+			.tuple_count = tuple_count,
+			.kernel_transform_tile_size = kernel_transform_tile_size,
+			.tiles_count = tiles_count,
+			.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
+			.tiles_block_max = fxdiv_init_size_t(fused_tiles_block_max),
+			.tiles_subblock_max = tiles_subblock_max,
+			.input_channels = input_channels,
+			.input_channels_block_max = input_channels_block_max,
+			.output_channels = output_channels,
+			.output_channels_block_max = fused_output_channels_block_max,
+			.output_channels_subblock_max = output_channels_subblock_max,
+			.input_size = input_size,
+			.input_padding_left = input_padding.left,
+			.input_padding_top = input_padding.top,
+			.input_tile = tile_size,
+			.input_tile_step = tile_step,
+			.output_size = output_size,
+			.output_tile = output_tile_size,
+			.pooled_size = pooled_size,
+			.activation = activation,
+			.pooling = pooling
+		};
+		pthreadpool_compute_1d(
+			(pthreadpool_function_1d_t)compute_fused_convolution,
+			&fused_convolution_context,
+			threads_count);
 
+		if (profile != NULL)
+		{
+			/* Split the wall time of the fused pass between phases in proportion to the time workers spent in each */
+			const double fused_time = read_timer() - fused_start;
+			struct nnp_profile threads_profile = { 0.0 };
+			for (size_t thread = 0; thread < threads_count; thread++)
+			{
+				const struct nnp_profile* thread_profile = (const struct nnp_profile*)
+					((char*)fused_convolution_context.scratch + thread * fused_scratch_size);
+				threads_profile.input_transform += thread_profile->input_transform;
+				threads_profile.block_multiplication += thread_profile->block_multiplication;
+				threads_profile.output_transform += thread_profile->output_transform;
 			}
-			else
+			const double threads_time =
+				threads_profile.input_transform + threads_profile.block_multiplication + threads_profile.output_transform;
+			if (threads_time > 0.0)
 			{
-				*workspace_size = memory_size;
-				return nnp_status_success;
+				profile->input_transform += fused_time * threads_profile.input_transform / threads_time;
+				profile->block_multiplication += fused_time * threads_profile.block_multiplication / threads_time;
+				profile->output_transform += fused_time * threads_profile.output_transform / threads_time;
 			}
 		}
-		else
-		{
-			if (*workspace_size < memory_size)
-				return nnp_status_insufficient_buffer;
-
-			memory_block = workspace_buffer;
-		}
-
+	}
+	else
+	{
 		char* input_transform = (char*)memory_block;
 		char* output_transform = (char*)memory_block + input_transform_size;
 		char* kernel_transform = (char*)memory_block + input_transform_size + output_transform_size;
@@ -634,7 +1455,7 @@ static enum nnp_status compute_fast_convolution_inference(
 					.transform_function = kernel_transform_function,
 					.kernel = kernel + input_channels_block_start * kernel_size.height * kernel_size.width,
 					.kernel_transform = kernel_transform,
-					.tuple_size = tuple_size,
+					.tuple_size = kernel_tuple_size,
 					.input_channels = input_channels,
 					.input_channels_block_size = input_channels_block_size,
 					.output_channels = output_channels,
@@ -648,7 +1469,7 @@ static enum nnp_status compute_fast_convolution_inference(
 				NNP_KERNEL_TRANSFORM_END(profile)
 			}
 			else
-				kernel_transform = (char*)kernel + input_channels_block_start * output_channels * transform_tile_size;
+				kernel_transform = (char*)kernel + input_channels_block_start * output_channels * kernel_transform_tile_size;
 
 			NNP_INPUT_TRANSFORM_START(profile)
 			struct input_transform_context input_transform_context =
@@ -658,6 +1479,7 @@ static enum nnp_status compute_fast_convolution_inference(
 				.transform_function = input_transform_function,
 				.tuple_size = tuple_size,
 				.tiles_count = tiles_count,
+				.transform_tiles_start = 0,
 				.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
 				.input_channels_block_start = input_channels_block_start,
 				.input_channels_block_size = input_channels_block_size,
@@ -679,64 +1501,11 @@ static enum nnp_status compute_fast_convolution_inference(
 			{
 				nnp_fast_tuple_gemm_function fast_gemm_function = NULL;
 				nnp_full_tuple_gemm_function full_gemm_function = NULL;
-				if (fourier_transform)
-				{
-#ifdef _WIN64
-					if (bypass_fft16x16)
-					{
-						if (tuple_index < NNP_COMPLEX_TUPLE_INDEX)
-						{
-							fast_gemm_function = nnp_hwinfo.cxgemm_psimd.s4cX_conjb_only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.cxgemm_psimd.s4cX_conjb_upto_mr_x_nr;
-						}
-						else
-						{
-							fast_gemm_function = nnp_hwinfo.cxgemm_psimd.cX_conjb_only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.cxgemm_psimd.cX_conjb_upto_mr_x_nr;
-						}
-					}
-					else
-					{
-						if (tuple_index < NNP_COMPLEX_TUPLE_INDEX)
-						{
-							fast_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_upto_mr_x_nr;
-						}
-						else
-						{
-							fast_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_upto_mr_x_nr;
-						}
-					}
-#else
-					if (tuple_index < NNP_COMPLEX_TUPLE_INDEX)
-					{
-						fast_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_only_mr_x_nr;
-						full_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_upto_mr_x_nr;
-					}
-					else
-					{
-						fast_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_only_mr_x_nr;
-						full_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_upto_mr_x_nr;
-					}
-#endif
-				}
-				else
-				{
-					if NNP_LIKELY(transform_element_size == sizeof(float))
-					{
-						fast_gemm_function = nnp_hwinfo.sxgemm.only_mr_x_nr;
-						full_gemm_function = nnp_hwinfo.sxgemm.upto_mr_x_nr;
-					}
-#if NNP_BACKEND_ARM
-					else
-					{
-						fast_gemm_function = nnp_hwinfo.hxgemm.only_mr_x_nr;
-						full_gemm_function = nnp_hwinfo.hxgemm.upto_mr_x_nr;
-					}
-#endif /* NNP_BACKEND_ARM */
-				}
-								
+				select_tuple_gemm_functions(
+					fourier_transform, bypass_fft16x16, tuple_index,
+					transform_element_size, kernel_transform_element_size,
+					&fast_gemm_function, &full_gemm_function);
+
 				for (size_t output_channels_block_start = 0; output_channels_block_start < output_channels; output_channels_block_start += output_channels_block_max)
 				{
 					const size_t output_channels_block_size = min(output_channels - output_channels_block_start, output_channels_block_max);
@@ -744,6 +1513,7 @@ static enum nnp_status compute_fast_convolution_inference(
 					{
 						.tuple_elements = tuple_elements,
 						.tuple_size = tuple_size,
+						.kernel_tuple_size = kernel_tuple_size,
 						.tiles_subblock_max = tiles_subblock_max,
 						.input_channels_block_size = input_channels_block_size,
 						.input_channels_block_start = input_channels_block_start,
@@ -751,7 +1521,7 @@ static enum nnp_status compute_fast_convolution_inference(
 						.output_channels_subblock_max = output_channels_subblock_max,
 						.output_channels_block_start = output_channels_block_start,
 						.input_transform = input_transform + tuple_index * tiles_count * input_channels_block_size * tuple_size,
-						.kernel_transform = kernel_transform + tuple_index * output_channels * input_channels_block_size * tuple_size,
+						.kernel_transform = kernel_transform + tuple_index * output_channels * input_channels_block_size * kernel_tuple_size,
 						.output_transform = output_transform + tuple_index * tiles_count * output_channels * tuple_size,
 						.fast_gemm = fast_gemm_function,
 						.full_gemm = full_gemm_function
@@ -773,13 +1543,19 @@ static enum nnp_status compute_fast_convolution_inference(
 			.output = output,
 			.output_transform = output_transform,
 			.bias = bias,
+			.residual = residual,
 			.tuple_size = tuple_size,
 			.tiles_count = tiles_count,
+			.transform_tiles_start = 0,
+			.transform_tiles_count = tiles_count,
 			.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
 			.tiles_block_max = fxdiv_init_size_t(tiles_block_max),
 			.output_channels = output_channels,
 			.output_size = output_size,
-			.output_tile = output_tile_size
+			.output_tile = output_tile_size,
+			.pooled_size = pooled_size,
+			.activation = activation,
+			.pooling = pooling
 		};
 		pthreadpool_compute_2d_tiled(
 			(pthreadpool_function_2d_tiled_t)compute_output_transform,
@@ -792,7 +1568,7 @@ static enum nnp_status compute_fast_convolution_inference(
 
 	case nnp_convolution_transform_strategy_precompute:
 	{
-		const size_t kernel_transform_size = output_channels * input_channels * transform_tile_size;
+		const size_t kernel_transform_size = output_channels * input_channels * kernel_transform_tile_size;
 		if (workspace_buffer == NULL)
 		{
 			*workspace_size = kernel_transform_size;
@@ -806,29 +1582,14 @@ static enum nnp_status compute_fast_convolution_inference(
 			memory_block = workspace_buffer;
 		}
 
-		for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max)
-		{
-			const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
-
-			NNP_KERNEL_TRANSFORM_START(profile)
-			struct kernel_transform_context kernel_transform_context =
-			{
-				.transform_function = kernel_transform_function,
-				.kernel = kernel + input_channels_block_start * kernel_size.height * kernel_size.width,
-				.kernel_transform = (char*)workspace_buffer + input_channels_block_start * output_channels * transform_tile_size,
-				.tuple_size = tuple_size,
-				.input_channels = input_channels,
-				.input_channels_block_size = input_channels_block_size,
-				.output_channels = output_channels,
-				.kernel_size = kernel_size
-			};
-			pthreadpool_compute_2d_tiled(
-				(pthreadpool_function_2d_tiled_t)compute_kernel_transform,
-				&kernel_transform_context,
-				output_channels, input_channels_block_size,
-				output_channels_subblock_max, 1);
-			NNP_KERNEL_TRANSFORM_END(profile)
-		}
+		NNP_KERNEL_TRANSFORM_START(profile)
+		transform_kernel_blocks(
+			kernel_transform_function, kernel, workspace_buffer,
+			kernel_tuple_size, kernel_transform_tile_size,
+			input_channels, input_channels_block_max,
+			output_channels, output_channels_subblock_max,
+			kernel_size);
+		NNP_KERNEL_TRANSFORM_END(profile)
 		break;
 
 	}
@@ -842,6 +1603,48 @@ static enum nnp_status compute_fast_convolution_inference(
 	return nnp_status_success;
 }
 
+struct gemm_convolution_blocking
+{
+	bool indirect;
+	size_t output_channels_subblock_max;
+	size_t output_image_subblock_max;
+	size_t reduction_block_max;
+	size_t output_channels_block_max;
+	size_t output_image_block_max;
+};
+
+static struct gemm_convolution_blocking get_gemm_convolution_blocking(
+	const struct nnp_size input_size,
+	const struct nnp_size kernel_size)
+{
+	struct gemm_convolution_blocking blocking;
+	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / sizeof(float);
+	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / sizeof(float);
+	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / sizeof(float);
+
+	/*
+	 * Indirect mode reads input through a buffer of pixel offsets, instead of packing an im2col block before every GEMM.
+	 * The offsets depend only on the output pixel, so they are built once per output image block and reused for all
+	 * input channels. Reduction blocks then cover whole input channels, and the packed kernel is zero-padded to full
+	 * micro-kernel tiles.
+	 */
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	blocking.indirect =
+		nnp_hwinfo.sgemm_indirect.only_mr_x_nr != NULL &&
+		kernel_elements <= round_down(cache_elements_l1 / (nnp_hwinfo.sgemm_indirect.mr + nnp_hwinfo.sgemm_indirect.nr), 2) &&
+		input_size.height * input_size.width <= (size_t) INT32_MAX;
+
+	blocking.output_channels_subblock_max = (blocking.indirect ? nnp_hwinfo.sgemm_indirect.mr : nnp_hwinfo.sgemm.mr);
+	blocking.output_image_subblock_max = (blocking.indirect ? nnp_hwinfo.sgemm_indirect.nr : nnp_hwinfo.sgemm.nr);
+
+	blocking.reduction_block_max = round_down(
+		round_down(cache_elements_l1 / (blocking.output_channels_subblock_max + blocking.output_image_subblock_max), 2),
+		blocking.indirect ? kernel_elements : 1);
+	blocking.output_channels_block_max = round_down(cache_elements_l2 / blocking.reduction_block_max, blocking.output_channels_subblock_max);
+	blocking.output_image_block_max = round_down(cache_elements_l3 / blocking.reduction_block_max, blocking.output_image_subblock_max);
+	return blocking;
+}
+
 static enum nnp_status compute_gemm_convolution_inference(
 	const enum nnp_convolution_transform_strategy transform_strategy,
 	const size_t input_channels,
@@ -854,10 +1657,12 @@ static enum nnp_status compute_gemm_convolution_inference(
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
+	const enum nnp_convolution_pooling pooling,
 	struct nnp_profile* profile)
 {
 	enum nnp_status status = nnp_status_success;
@@ -865,28 +1670,31 @@ static enum nnp_status compute_gemm_convolution_inference(
 	size_t memory_size = 0;
 	const size_t simd_width = nnp_hwinfo.simd_width;
 
-	/* Calculate cache blocking parameters */
-	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / sizeof(float);
-	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / sizeof(float);
-	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / sizeof(float);
-
-	const size_t output_channels_subblock_max = nnp_hwinfo.sgemm.mr;
-	const size_t output_image_subblock_max = nnp_hwinfo.sgemm.nr;
-
-	const size_t reduction_size = input_channels * kernel_size.height * kernel_size.width;
+	/* Cache blocking parameters */
+	const struct gemm_convolution_blocking blocking = get_gemm_convolution_blocking(input_size, kernel_size);
+	const bool indirect = blocking.indirect;
+	const size_t output_channels_subblock_max = blocking.output_channels_subblock_max;
+	const size_t output_image_subblock_max = blocking.output_image_subblock_max;
+	const size_t reduction_block_max = blocking.reduction_block_max;
+	const size_t output_channels_block_max = blocking.output_channels_block_max;
+	const size_t output_image_block_max = blocking.output_image_block_max;
+
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const size_t reduction_size = input_channels * kernel_elements;
 	const size_t output_image_size = output_size.height * output_size.width;
-	const size_t reduction_block_max = round_down(cache_elements_l1 / (output_channels_subblock_max + output_image_subblock_max), 2);
-	const size_t output_channels_block_max = round_down(cache_elements_l2 / reduction_block_max, output_channels_subblock_max);
-	const size_t output_image_block_max = round_down(cache_elements_l3 / reduction_block_max, output_image_subblock_max);
+	const size_t packed_output_channels = (indirect ? round_up(output_channels, output_channels_subblock_max) : output_channels);
 
 	switch (transform_strategy)
 	{
 	case nnp_convolution_transform_strategy_compute:
 	case nnp_convolution_transform_strategy_reuse:
 	{
-		const size_t packed_kernel_size = output_channels * min(reduction_block_max, reduction_size) * sizeof(float);
-		const size_t packed_input_size = min(output_image_block_max, round_up(output_image_size, simd_width)) *	min(reduction_block_max, reduction_size) * sizeof(float);
-		memory_size = packed_kernel_size + packed_input_size;
+		const size_t packed_kernel_size = packed_output_channels * min(reduction_block_max, reduction_size) * sizeof(float);
+		const size_t packed_input_size = (indirect ?
+			round_up(min(output_image_block_max, round_up(output_image_size, output_image_subblock_max)) * kernel_elements * sizeof(int32_t), 64) :
+			min(output_image_block_max, round_up(output_image_size, simd_width)) * min(reduction_block_max, reduction_size) * sizeof(float));
+		const size_t convolution_output_size = (pooling == nnp_convolution_pooling_none ? 0 : output_channels * output_image_size * sizeof(float));
+		memory_size = packed_kernel_size + packed_input_size + convolution_output_size;
 		if (workspace_buffer == NULL)
 		{
 			if (workspace_size == NULL)
@@ -910,91 +1718,166 @@ static enum nnp_status compute_gemm_convolution_inference(
 			memory_block = workspace_buffer;
 		}
 
-		float* packed_input = (float*)memory_block;
-		float* packed_kernel = (float*)((char*)memory_block + packed_input_size);
-
-		for (size_t reduction_block_start = 0; reduction_block_start < reduction_size; reduction_block_start += reduction_block_max)
-		{
-			const size_t reduction_block_size = min(reduction_size - reduction_block_start, reduction_block_max);
-
-			if (transform_strategy == nnp_convolution_transform_strategy_compute)
-			{
-				/* Pack kernel into memory block */
-				NNP_KERNEL_TRANSFORM_START(profile)
-				struct kernel_packing_context kernel_packing_context =
-				{
-					.kernel = kernel + reduction_block_start,
-					.packed_kernel = packed_kernel,
-					.reduction_size = reduction_size,
-					.reduction_block_start = reduction_block_start,
-					.reduction_block_size = reduction_block_size,
-				};
-				pthreadpool_compute_2d_tiled(
-					(pthreadpool_function_2d_tiled_t)compute_kernel_packing,
-					&kernel_packing_context,
-					output_channels, reduction_block_size,
-					output_channels_subblock_max, 1);
-				NNP_KERNEL_TRANSFORM_END(profile)
-			}
-			else
-				packed_kernel = (float*)((char*)kernel + output_channels * reduction_block_start * sizeof(float));
-
+		float* packed_input = (float*)memory_block;
+		int32_t* indirection = (int32_t*)memory_block;
+		float* packed_kernel = (float*)((char*)memory_block + packed_input_size);
+		/* With pooling, full-resolution output goes to workspace and only the pooled tensor is stored to output */
+		float* convolution_output = (pooling == nnp_convolution_pooling_none ? output : (float*)((char*)memory_block + packed_input_size + packed_kernel_size));
 
-			const struct fxdiv_divisor_size_t kernel_elements_divisor = fxdiv_init_size_t(kernel_size.height * kernel_size.width);
-			const struct fxdiv_divisor_size_t kernel_width_divisor = fxdiv_init_size_t(kernel_size.width);
-			const struct fxdiv_divisor_size_t output_width_divisor = fxdiv_init_size_t(output_size.width);
-			for (size_t output_image_block_start = 0; output_image_block_start < output_image_size; output_image_block_start += output_image_block_max)
-			{
-				const size_t output_image_block_size = min(output_image_size - output_image_block_start, output_image_block_max);
+		const struct fxdiv_divisor_size_t kernel_elements_divisor = fxdiv_init_size_t(kernel_elements);
+		const struct fxdiv_divisor_size_t kernel_width_divisor = fxdiv_init_size_t(kernel_size.width);
+		const struct fxdiv_divisor_size_t output_width_divisor = fxdiv_init_size_t(output_size.width);
+		/*
+		 * In indirect mode the indirection buffer covers one output image block and is reused for every reduction block.
+		 * Without it the whole image is processed at once and input packing is blocked inside the reduction loop.
+		 */
+		const size_t indirection_block_max = (indirect ? output_image_block_max : output_image_size);
+		for (size_t indirection_block_start = 0; indirection_block_start < output_image_size; indirection_block_start += indirection_block_max)
+		{
+			const size_t indirection_block_size = min(output_image_size - indirection_block_start, indirection_block_max);
 
-				/* Pack image into L3 block */
+			if (indirect)
+			{
 				NNP_INPUT_TRANSFORM_START(profile)
-				struct input_packing_context input_packing_context =
+				struct indirection_context indirection_context =
 				{
-					.input = input,
-					.packed_input = packed_input,
-					.simd_width = simd_width,
-					.reduction_block_start = reduction_block_start,
-					.reduction_block_size = reduction_block_size,
-					.output_image_block_start = output_image_block_start,
+					.indirection = indirection,
+					.kernel_elements = kernel_elements,
+					.output_image_subblock_max = output_image_subblock_max,
+					.output_image_block_start = indirection_block_start,
 					.input_size = input_size,
 					.input_padding_top = input_padding.top,
 					.input_padding_left = input_padding.left,
-					.kernel_elements = kernel_elements_divisor,
-					.kernel_width = kernel_width_divisor,
+					.kernel_size = kernel_size,
 					.output_width = output_width_divisor,
 					.output_subsampling = output_subsampling,
 				};
-				pthreadpool_compute_2d_tiled(
-					(pthreadpool_function_2d_tiled_t)compute_input_packing,
-					&input_packing_context,
-					reduction_block_size, output_image_block_size,
-					1, output_image_subblock_max);
+				pthreadpool_compute_1d_tiled(
+					(pthreadpool_function_1d_tiled_t)compute_indirection,
+					&indirection_context,
+					indirection_block_size, output_image_subblock_max);
 				NNP_INPUT_TRANSFORM_END(profile)
+			}
 
-				NNP_BLOCK_MULTIPLICATION_START(profile)
-				struct matrix_multiplication_context matrix_multiplication_context =
+			for (size_t reduction_block_start = 0; reduction_block_start < reduction_size; reduction_block_start += reduction_block_max)
+			{
+				const size_t reduction_block_size = min(reduction_size - reduction_block_start, reduction_block_max);
+
+				if (transform_strategy != nnp_convolution_transform_strategy_compute)
+					packed_kernel = (float*)((char*)kernel + packed_output_channels * reduction_block_start * sizeof(float));
+				else if (indirection_block_start == 0 || reduction_size > reduction_block_max)
 				{
-					.packed_kernel = packed_kernel,
-					.packed_input = packed_input,
-					.output = output,
-					.reduction_block_start = reduction_block_start,
-					.reduction_block_size = reduction_block_size,
-					.output_image_size = output_image_size,
-					.output_image_block_start = output_image_block_start,
-					.output_image_subblock_max = output_image_subblock_max,
-					.output_channels_subblock_max = output_channels_subblock_max,
-				};
-				pthreadpool_compute_2d_tiled(
-					(pthreadpool_function_2d_tiled_t)compute_matrix_multiplication,
-					&matrix_multiplication_context,
-					output_channels, output_image_block_size,
-					output_channels_block_max, output_image_subblock_max);
-				NNP_BLOCK_MULTIPLICATION_END(profile)
+					/* Pack kernel into memory block; a single reduction block stays packed across output image blocks */
+					NNP_KERNEL_TRANSFORM_START(profile)
+					struct kernel_packing_context kernel_packing_context =
+					{
+						.kernel = kernel + reduction_block_start,
+						.packed_kernel = packed_kernel,
+						.reduction_size = reduction_size,
+						.reduction_block_start = reduction_block_start,
+						.reduction_block_size = reduction_block_size,
+						.output_channels = output_channels,
+					};
+					pthreadpool_compute_2d_tiled(
+						(pthreadpool_function_2d_tiled_t)compute_kernel_packing,
+						&kernel_packing_context,
+						packed_output_channels, reduction_block_size,
+						output_channels_subblock_max, 1);
+					NNP_KERNEL_TRANSFORM_END(profile)
+				}
+
+				if (indirect)
+				{
+					NNP_BLOCK_MULTIPLICATION_START(profile)
+					struct indirect_matrix_multiplication_context indirect_matrix_multiplication_context =
+					{
+						.packed_kernel = packed_kernel,
+						.input = input + reduction_block_start / kernel_elements * input_size.height * input_size.width,
+						.indirection = indirection,
+						.output = convolution_output + indirection_block_start,
+						.reduction_block_start = reduction_block_start,
+						.reduction_block_size = reduction_block_size,
+						.input_channels_block_size = reduction_block_size / kernel_elements,
+						.kernel_elements = kernel_elements,
+						.channel_stride = input_size.height * input_size.width,
+						.output_image_size = output_image_size,
+						.output_image_subblock_max = output_image_subblock_max,
+						.output_channels_subblock_max = output_channels_subblock_max,
+						.indirect_gemm = nnp_hwinfo.sgemm_indirect.only_mr_x_nr,
+					};
+					pthreadpool_compute_2d_tiled(
+						(pthreadpool_function_2d_tiled_t)compute_indirect_matrix_multiplication,
+						&indirect_matrix_multiplication_context,
+						output_channels, indirection_block_size,
+						output_channels_block_max, output_image_subblock_max);
+					NNP_BLOCK_MULTIPLICATION_END(profile)
+					continue;
+				}
+
+				for (size_t output_image_block_start = 0; output_image_block_start < output_image_size; output_image_block_start += output_image_block_max)
+				{
+					const size_t output_image_block_size = min(output_image_size - output_image_block_start, output_image_block_max);
+
+					/* Pack image into L3 block */
+					NNP_INPUT_TRANSFORM_START(profile)
+					struct input_packing_context input_packing_context =
+					{
+						.input = input,
+						.packed_input = packed_input,
+						.simd_width = simd_width,
+						.reduction_block_start = reduction_block_start,
+						.reduction_block_size = reduction_block_size,
+						.output_image_block_start = output_image_block_start,
+						.input_size = input_size,
+						.input_padding_top = input_padding.top,
+						.input_padding_left = input_padding.left,
+						.kernel_elements = kernel_elements_divisor,
+						.kernel_width = kernel_width_divisor,
+						.output_width = output_width_divisor,
+						.output_subsampling = output_subsampling,
+					};
+					pthreadpool_compute_2d_tiled(
+						(pthreadpool_function_2d_tiled_t)compute_input_packing,
+						&input_packing_context,
+						reduction_block_size, output_image_block_size,
+						1, output_image_subblock_max);
+					NNP_INPUT_TRANSFORM_END(profile)
+
+					NNP_BLOCK_MULTIPLICATION_START(profile)
+					struct matrix_multiplication_context matrix_multiplication_context =
+					{
+						.packed_kernel = packed_kernel,
+						.packed_input = packed_input,
+						.output = convolution_output,
+						.reduction_block_start = reduction_block_start,
+						.reduction_block_size = reduction_block_size,
+						.output_image_size = output_image_size,
+						.output_image_block_start = output_image_block_start,
+						.output_image_subblock_max = output_image_subblock_max,
+						.output_channels_subblock_max = output_channels_subblock_max,
+					};
+					pthreadpool_compute_2d_tiled(
+						(pthreadpool_function_2d_tiled_t)compute_matrix_multiplication,
+						&matrix_multiplication_context,
+						output_channels, output_image_block_size,
+						output_channels_block_max, output_image_subblock_max);
+					NNP_BLOCK_MULTIPLICATION_END(profile)
+				}
 			}
 		}
 		/* Add bias */
 		NNP_OUTPUT_TRANSFORM_START(profile)
+		if (residual != NULL)
+		{
+			for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+				add_residual_with_activation(
+					convolution_output + output_channel * output_image_size, output_image_size,
+					residual + output_channel * output_image_size, output_image_size,
+					bias[output_channel], 1, output_image_size,
+					activation);
+		}
+		else
+		{
 			switch (activation)
 			{
 			case nnp_activation_identity:
@@ -1002,7 +1885,7 @@ static enum nnp_status compute_gemm_convolution_inference(
 				{
 					const float bias_value = bias[output_channel];
 					for (size_t index = 0; index < output_image_size; index++)
-						output[output_channel * output_image_size + index] += bias_value;
+						convolution_output[output_channel * output_image_size + index] += bias_value;
 				}
 				break;
 			case nnp_activation_relu:
@@ -1010,19 +1893,30 @@ static enum nnp_status compute_gemm_convolution_inference(
 				{
 					const float bias_value = bias[output_channel];
 					for (size_t index = 0; index < output_image_size; index++)
-						output[output_channel * output_image_size + index] = relu(output[output_channel * output_image_size + index] + bias_value, 0.0f);
+						convolution_output[output_channel * output_image_size + index] = relu(convolution_output[output_channel * output_image_size + index] + bias_value, 0.0f);
 				}
 				break;
 			default:
 				NNP_UNREACHABLE;
 			}
+		}
+
+		if (pooling != nnp_convolution_pooling_none)
+		{
+			const struct nnp_size pooled_size = { .width = divide_round_up(output_size.width, 2), .height = divide_round_up(output_size.height, 2) };
+			for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+				max_pool_2x2(
+					convolution_output + output_channel * output_image_size, output_size.width,
+					output + output_channel * pooled_size.width * pooled_size.height, pooled_size.width,
+					output_size.height, output_size.width);
+		}
 		NNP_OUTPUT_TRANSFORM_END(profile)
 	}
 	break;
 
 	case nnp_convolution_transform_strategy_precompute:
 	{
-		const size_t packed_kernel_size = output_channels * reduction_size * sizeof(float);
+		const size_t packed_kernel_size = packed_output_channels * reduction_size * sizeof(float);
 		if (workspace_buffer == NULL)
 		{
 			*workspace_size = packed_kernel_size;
@@ -1045,15 +1939,16 @@ static enum nnp_status compute_gemm_convolution_inference(
 			struct kernel_packing_context kernel_packing_context =
 			{
 				.kernel = kernel + reduction_block_start,
-				.packed_kernel = (float*)((char*)workspace_buffer + output_channels * reduction_block_start * sizeof(float)),
+				.packed_kernel = (float*)((char*)workspace_buffer + packed_output_channels * reduction_block_start * sizeof(float)),
 				.reduction_size = reduction_size,
 				.reduction_block_start = reduction_block_start,
 				.reduction_block_size = reduction_block_size,
+				.output_channels = output_channels,
 			};
 			pthreadpool_compute_2d_tiled(
 				(pthreadpool_function_2d_tiled_t)compute_kernel_packing,
 				&kernel_packing_context,
-				output_channels, reduction_block_size,
+				packed_output_channels, reduction_block_size,
 				output_channels_subblock_max, 1);
 			NNP_KERNEL_TRANSFORM_END(profile)
 		}
@@ -1078,26 +1973,50 @@ static enum nnp_status compute_direct_convolution_inference(
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
+	const enum nnp_convolution_pooling pooling,
 	struct nnp_profile* profile)
 {
+	void* memory_block = NULL;
 	const size_t image_elements = image_size.height * image_size.width;
 
-	if (workspace_buffer == NULL && workspace_size != NULL)
+	/* With pooling, full-resolution output goes to workspace and only the pooled tensor is stored to output */
+	const size_t memory_size = (pooling == nnp_convolution_pooling_none ? 0 : output_channels * image_elements * sizeof(float));
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size != NULL)
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+
+		if (memory_size != 0)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+	}
+	else
 	{
-		*workspace_size = 0;
-		return nnp_status_success;
+		if (memory_size != 0 && *workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
 	}
 
+	float* convolution_output = (pooling == nnp_convolution_pooling_none ? output : (float*)memory_block);
+
 	NNP_BLOCK_MULTIPLICATION_START(profile)
 	struct direct_convolution_context direct_convolution_context =
 	{
 		.input = input,
 		.kernel = kernel,
-		.output = output,
+		.output = convolution_output,
 		.image_elements = image_elements,
 		.input_channels = input_channels,
 		.input_channels_block_max = nnp_hwinfo.conv1x1.mr,
@@ -1114,68 +2033,302 @@ static enum nnp_status compute_direct_convolution_inference(
 
 	/* Add bias */
 	NNP_OUTPUT_TRANSFORM_START(profile)
-	switch (activation)
+	if (residual != NULL)
 	{
-	case nnp_activation_identity:
 		for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+			add_residual_with_activation(
+				convolution_output + output_channel * image_elements, image_elements,
+				residual + output_channel * image_elements, image_elements,
+				bias[output_channel], 1, image_elements,
+				activation);
+	}
+	else
+	{
+		switch (activation)
 		{
-			const float bias_value = bias[output_channel];
-			for (size_t index = 0; index < image_elements; index++)
-				output[output_channel * image_elements + index] += bias_value;
+		case nnp_activation_identity:
+			for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+			{
+				const float bias_value = bias[output_channel];
+				for (size_t index = 0; index < image_elements; index++)
+					convolution_output[output_channel * image_elements + index] += bias_value;
+			}
+			break;
+
+		case nnp_activation_relu:
+			for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+			{
+				const float bias_value = bias[output_channel];
+				for (size_t index = 0; index < image_elements; index++)
+					convolution_output[output_channel * image_elements + index] = relu(convolution_output[output_channel * image_elements + index] + bias_value, 0.0f);
+			}
+			break;
+
+		default:
+			NNP_UNREACHABLE;
 		}
-		break;
+	}
 
-	case nnp_activation_relu:
+	if (pooling != nnp_convolution_pooling_none)
+	{
+		const struct nnp_size pooled_size = { .width = divide_round_up(image_size.width, 2), .height = divide_round_up(image_size.height, 2) };
 		for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
-		{
-			const float bias_value = bias[output_channel];
-			for (size_t index = 0; index < image_elements; index++)
-				output[output_channel * image_elements + index] = relu(output[output_channel * image_elements + index] + bias_value, 0.0f);
-		}
+			max_pool_2x2(
+				convolution_output + output_channel * image_elements, image_size.width,
+				output + output_channel * pooled_size.width * pooled_size.height, pooled_size.width,
+				image_size.height, image_size.width);
+	}
+	NNP_OUTPUT_TRANSFORM_END(profile)
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return nnp_status_success;
+}
+
+/*
+ * Analytic cost model for algorithm selection. Costs are in FLOP-equivalents:
+ * - transform FLOPs are weighted up, because transforms run far below tuple GEMM efficiency (shuffles, partial tiles);
+ * - traffic through buffers larger than the L3 blocking size is charged at the machine balance, which is about
+ *   simd_width / 2 FLOPs per byte (two FMA pipes against ~8 bytes of DRAM bandwidth per cycle), and traffic that
+ *   stays in cache at a quarter of that.
+ */
+#define NNP_TRANSFORM_FLOPS_WEIGHT 3.0
+#define NNP_CACHED_BYTES_WEIGHT 0.25
+
+struct convolution_cost
+{
+	double transform_flops;
+	double gemm_flops;
+	double bytes;
+	double footprint;
+	/* Zero for algorithms without tiled transforms */
+	struct nnp_size tile_size;
+	size_t tiles_count;
+	/* For implicit GEMM, blocks of reduction elements (input channels times kernel elements) and output pixels */
+	size_t input_channels_block_max;
+	size_t tiles_block_max;
+	size_t output_channels_block_max;
+};
+
+/* Returns false if the algorithm cannot compute the layer */
+static bool estimate_convolution_cost(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	struct nnp_size output_size,
+	enum nnp_activation transform_activation,
+	enum nnp_convolution_pooling pooling,
+	size_t threads_count,
+	struct convolution_cost* cost)
+{
+	const double output_elements = (double) output_size.height * (double) output_size.width;
+	cost->tile_size = (struct nnp_size) { .width = 0, .height = 0 };
+	cost->tiles_count = 0;
+	switch (algorithm)
+	{
+	case nnp_convolution_algorithm_implicit_gemm:
+	{
+		const struct gemm_convolution_blocking blocking = get_gemm_convolution_blocking(input_size, kernel_size);
+		cost->input_channels_block_max = blocking.reduction_block_max;
+		cost->tiles_block_max = blocking.output_image_block_max;
+		cost->output_channels_block_max = blocking.output_channels_block_max;
+
+		/* Every output pixel reads a packed panel of input_channels x kernel elements */
+		const double reduction_size = (double) input_channels * kernel_size.height * kernel_size.width;
+		cost->transform_flops = output_elements * reduction_size;
+		/* Kernel packing is skipped when the caller reuses a pre-packed kernel */
+		if (transform_strategy == nnp_convolution_transform_strategy_compute)
+			cost->transform_flops += reduction_size * output_channels;
+		cost->gemm_flops = 2.0 * output_elements * reduction_size * output_channels;
+		cost->bytes = sizeof(float) * output_elements * (reduction_size + output_channels);
+		cost->footprint = sizeof(float) * output_elements * (input_channels + output_channels);
+		return true;
+	}
+
+	case nnp_convolution_algorithm_direct:
+		cost->input_channels_block_max = nnp_hwinfo.conv1x1.mr;
+		cost->tiles_block_max = output_size.height * output_size.width;
+		cost->output_channels_block_max = nnp_hwinfo.conv1x1.nr;
+
+		cost->transform_flops = 0.0;
+		cost->gemm_flops = 2.0 * output_elements * input_channels * output_channels;
+		cost->bytes = sizeof(float) * output_elements * (input_channels + output_channels);
+		cost->footprint = cost->bytes;
+		return true;
+
+	default:
 		break;
+	}
 
+	/* Fast algorithms: per-tile transform FLOPs and per-tile tuple GEMM FLOPs for one input/output channel pair */
+	size_t tile_size;
+	bool fourier_transform = true;
+	double input_transform_flops, kernel_transform_flops, output_transform_flops, tile_gemm_flops;
+	switch (algorithm)
+	{
+	case nnp_convolution_algorithm_wt8x8:
+	case nnp_convolution_algorithm_wt8x8_fp16:
+		/* 16 (input), 11 (kernel) and 14 (output) one-dimensional transforms of about 24 FLOPs each; 64 real MACs */
+		tile_size = 8;
+		fourier_transform = false;
+		input_transform_flops = 384.0;
+		kernel_transform_flops = 264.0;
+		output_transform_flops = 336.0;
+		tile_gemm_flops = 128.0;
+		break;
+	case nnp_convolution_algorithm_ft8x8:
+	case nnp_convolution_algorithm_ft16x16:
+	case nnp_convolution_algorithm_ft32x32:
+	{
+		/* Real 2D FFT of N x N takes about 2.5 N^2 log2(N^2) FLOPs; N^2 / 2 complex MACs of 8 FLOPs each */
+		tile_size = (algorithm == nnp_convolution_algorithm_ft8x8 ? 8 : algorithm == nnp_convolution_algorithm_ft16x16 ? 16 : 32);
+		const double log2_tile_elements = (tile_size == 8 ? 6.0 : tile_size == 16 ? 8.0 : 10.0);
+		input_transform_flops = 2.5 * tile_size * tile_size * log2_tile_elements;
+		kernel_transform_flops = input_transform_flops;
+		output_transform_flops = input_transform_flops;
+		tile_gemm_flops = 4.0 * tile_size * tile_size;
+		break;
+	}
 	default:
-		NNP_UNREACHABLE;
+		return false;
 	}
-	NNP_OUTPUT_TRANSFORM_END(profile)
 
-	return nnp_status_success;
+	if (max(kernel_size.height, kernel_size.width) > tile_size)
+		return false;
+
+	struct nnp_size output_tile_size =
+	{
+		.width = (tile_size - kernel_size.width) / output_subsampling.width + 1,
+		.height = (tile_size - kernel_size.height) / output_subsampling.height + 1
+	};
+	if (pooling != nnp_convolution_pooling_none)
+	{
+		output_tile_size.width = round_down(output_tile_size.width, 2);
+		output_tile_size.height = round_down(output_tile_size.height, 2);
+	}
+	if (output_tile_size.width == 0 || output_tile_size.height == 0)
+		return false;
+
+	cost->tile_size = (struct nnp_size) { .width = tile_size, .height = tile_size };
+	cost->tiles_count =
+		divide_round_up(output_size.height, output_tile_size.height) * divide_round_up(output_size.width, output_tile_size.width);
+	const double tiles_count = (double) cost->tiles_count;
+
+	/*
+	 * Blocking and schedule are derived exactly as the call derives them. The staged schedule streams the kernel transform
+	 * once per block of tiles. The fused schedule transforms input once per block of output channels; every thread reads
+	 * the kernel transform from memory once if a block of it stays in cache, and once per block of tiles otherwise.
+	 */
+	size_t transform_element_size, kernel_transform_element_size;
+	get_fast_convolution_element_sizes(algorithm, transform_activation, &transform_element_size, &kernel_transform_element_size);
+	const struct fast_convolution_blocking blocking = get_fast_convolution_blocking(fourier_transform, transform_element_size, cost->tile_size);
+	const struct fast_convolution_schedule schedule = get_fast_convolution_schedule(
+		&blocking, input_channels, output_channels, cost->tiles_count,
+		transform_element_size * tile_size * tile_size, kernel_transform_element_size * tile_size * tile_size,
+		threads_count);
+	cost->input_channels_block_max = blocking.input_channels_block_max;
+	cost->tiles_block_max = schedule.tiles_block_max;
+	cost->output_channels_block_max = schedule.output_channels_block_max;
+
+	const double transform_tile_size = (double) transform_element_size * tile_size * tile_size;
+	const double kernel_transform_tile_size = (double) kernel_transform_element_size * tile_size * tile_size;
+	const double input_transform_size = tiles_count * input_channels * transform_tile_size;
+	const double output_transform_size = tiles_count * output_channels * transform_tile_size;
+	const double kernel_transform_size = (double) input_channels * output_channels * kernel_transform_tile_size;
+
+	double input_transform_passes = 1.0;
+	double kernel_passes = (double) divide_round_up(cost->tiles_count, max(schedule.tiles_block_max, 1));
+	if (schedule.fused)
+	{
+		input_transform_passes = (double) divide_round_up(output_channels, schedule.output_channels_block_max);
+		if ((double) input_channels * schedule.output_channels_block_max * kernel_transform_tile_size <= (double) (nnp_hwinfo.blocking.l3 / 2))
+			kernel_passes = (double) threads_count;
+	}
+
+	cost->transform_flops = tiles_count * (input_channels * input_transform_flops * input_transform_passes + output_channels * output_transform_flops);
+	if (transform_strategy == nnp_convolution_transform_strategy_compute)
+		cost->transform_flops += (double) input_channels * output_channels * kernel_transform_flops;
+	cost->gemm_flops = tiles_count * input_channels * output_channels * tile_gemm_flops;
+	cost->bytes = 2.0 * (input_transform_size + output_transform_size) + kernel_passes * kernel_transform_size;
+	cost->footprint = input_transform_size + output_transform_size + kernel_transform_size;
+	return true;
+}
+
+static double convolution_cost_flops(const struct convolution_cost* cost)
+{
+	const double flops_per_byte = 0.5 * nnp_hwinfo.simd_width;
+	const double bytes_weight = (cost->footprint > (double) nnp_hwinfo.blocking.l3 ? 1.0 : NNP_CACHED_BYTES_WEIGHT);
+	return cost->gemm_flops + NNP_TRANSFORM_FLOPS_WEIGHT * cost->transform_flops + bytes_weight * flops_per_byte * cost->bytes;
 }
 
-static inline enum nnp_convolution_algorithm select_algorithm(
+/*
+ * Picks the cheapest algorithm under the cost model among those that support the layer.
+ * The choice depends only on the layer and on whether the kernel transform is computed in the call: precompute, reuse
+ * and workspace size queries of a layer must resolve to the same algorithm, so neither the workspace, the residual, nor
+ * the thread count is considered. The cost is estimated with a single-threaded schedule.
+ */
+static enum nnp_convolution_algorithm select_algorithm(
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
 	struct nnp_size kernel_size,
 	struct nnp_size output_subsampling,
-	struct nnp_size output_size)
+	struct nnp_size output_size,
+	enum nnp_activation activation,
+	enum nnp_convolution_pooling pooling)
 {
-	if (max(output_subsampling.height, output_subsampling.width) == 1) 
-	{
-		/* Stride-1 convolution: consider fast convolution algorithm and direct 1x1 */
-		if (max(kernel_size.height, kernel_size.width) == 1) 
-			return nnp_convolution_algorithm_direct;
-		else if (kernel_size.height == 3 && kernel_size.width == 3)
-			return nnp_convolution_algorithm_wt8x8;
-		else if (min(kernel_size.height, kernel_size.width) >= 2)
+	enum nnp_convolution_algorithm candidates[6];
+	size_t candidates_count = 0;
+	if (max(output_subsampling.height, output_subsampling.width) == 1)
+	{
+		/* Stride-1 convolution: consider fast convolution algorithms and direct 1x1 (which has no pre-computed form) */
+		if (max(kernel_size.height, kernel_size.width) == 1 && transform_strategy == nnp_convolution_transform_strategy_compute)
+			candidates[candidates_count++] = nnp_convolution_algorithm_direct;
+		if (kernel_size.height == 3 && kernel_size.width == 3 && nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream != NULL)
+			candidates[candidates_count++] = nnp_convolution_algorithm_wt8x8;
+		if (min(kernel_size.height, kernel_size.width) >= 2)
 		{
-			/* Consider FFT-based fast convolution */
-			if (max(kernel_size.height, kernel_size.width) <= 8)
-			{
-				/* Decide between FFT 8x8 and FFT 16x16 */
-				const size_t tile_count_8x8 = divide_round_up(output_size.height, 8 - kernel_size.height + 1) *	divide_round_up(output_size.width, 8 - kernel_size.width + 1);
-				const size_t tile_count_16x16 =	divide_round_up(output_size.height, 16 - kernel_size.height + 1) * divide_round_up(output_size.width, 16 - kernel_size.width + 1);
-					
-				if (tile_count_8x8 <= 4 * tile_count_16x16)
-					/* 8x8 tiles are more efficient */
-					return nnp_convolution_algorithm_ft8x8;
-				else
-					return nnp_convolution_algorithm_ft16x16;
-			}
-			else if (max(kernel_size.height, kernel_size.width) <= 16)
-				return nnp_convolution_algorithm_ft16x16;
+			if (max(kernel_size.height, kernel_size.width) <= 8 && nnp_hwinfo.transforms.fft8x8_with_offset_and_stream != NULL)
+				candidates[candidates_count++] = nnp_convolution_algorithm_ft8x8;
+			if (max(kernel_size.height, kernel_size.width) <= 16 && nnp_hwinfo.transforms.fft16x16_with_offset_and_stream != NULL)
+				candidates[candidates_count++] = nnp_convolution_algorithm_ft16x16;
+			/* 32x32 transforms are not available on x86-64 */
+			if (max(kernel_size.height, kernel_size.width) <= 32 && nnp_hwinfo.transforms.fft32x32_with_offset_and_stream != NULL)
+				candidates[candidates_count++] = nnp_convolution_algorithm_ft32x32;
 		}
 	}
-				
+	/* Implicit GEMM supports any layer; with precompute/reuse its kernel is pre-packed */
+	candidates[candidates_count++] = nnp_convolution_algorithm_implicit_gemm;
+
 	/* Fall-back algorithm */
-	return nnp_convolution_algorithm_implicit_gemm;
+	enum nnp_convolution_algorithm best_algorithm = nnp_convolution_algorithm_implicit_gemm;
+	double best_cost = 0.0;
+	bool have_best = false;
+	for (size_t i = 0; i < candidates_count; i++)
+	{
+		struct convolution_cost cost;
+		if (!estimate_convolution_cost(candidates[i], transform_strategy,
+			input_channels, output_channels, input_size, kernel_size, output_subsampling, output_size,
+			activation, pooling, 1, &cost))
+		{
+			continue;
+		}
+
+		const double flops = convolution_cost_flops(&cost);
+		if (!have_best || flops < best_cost)
+		{
+			best_algorithm = candidates[i];
+			best_cost = flops;
+			have_best = true;
+		}
+	}
+	return best_algorithm;
 }
 
 enum nnp_status nnp_convolution_inference(
@@ -1190,11 +2343,13 @@ enum nnp_status nnp_convolution_inference(
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
 	const void* activation_parameters,
+	const enum nnp_convolution_pooling pooling,
 	struct nnp_profile* profile)
 {
 	NNP_TOTAL_START(profile)
@@ -1210,6 +2365,16 @@ enum nnp_status nnp_convolution_inference(
 		goto cleanup;
 	}
 
+	switch (pooling)
+	{
+	case nnp_convolution_pooling_none:
+	case nnp_convolution_pooling_max_2x2:
+		break;
+	default:
+		status = nnp_status_invalid_pooling_size;
+		goto cleanup;
+	}
+
 	const struct nnp_size output_size =
 	{
 		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
@@ -1217,9 +2382,16 @@ enum nnp_status nnp_convolution_inference(
 	};
 
 	if (algorithm == nnp_convolution_algorithm_auto)
-		algorithm = select_algorithm(kernel_size, output_subsampling, output_size);
+		algorithm = select_algorithm(
+			transform_strategy, input_channels, output_channels,
+			input_size, kernel_size, output_subsampling, output_size,
+			activation, pooling);
 
-	const size_t transform_element_size = sizeof(float);
+	/* With a residual, the activation must follow the addition, so output transforms are chosen without it */
+	const enum nnp_activation transform_activation = (residual == NULL ? activation : nnp_activation_identity);
+
+	size_t transform_element_size, kernel_transform_element_size;
+	get_fast_convolution_element_sizes(algorithm, transform_activation, &transform_element_size, &kernel_transform_element_size);
 	struct nnp_size tile_size = { .width = 8,.height = 8 };
 	bool fourier_transform = false;
 	nnp_transform_2d_with_offset input_transform_function = NULL;
@@ -1240,31 +2412,33 @@ enum nnp_status nnp_convolution_inference(
 			status = nnp_status_unsupported_algorithm;
 			goto cleanup;
 		}
-		tile_size = (struct nnp_size) { .width = 8, .height = 8 };
-		transform_element_size = sizeof(uint16_t);
-		fourier_transform = false;
-
-		input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_fp16_with_offset;
-		kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16;
-		switch (activation)
+		if (transform_element_size == sizeof(uint16_t))
 		{
-		case nnp_activation_identity:
-			output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias;
-			break;
-		case nnp_activation_relu:
-			output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias_with_relu;
-			break;
-		default:
-			NNP_UNREACHABLE;
+			tile_size = (struct nnp_size) { .width = 8, .height = 8 };
+			fourier_transform = false;
+
+			input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_fp16_with_offset;
+			kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16;
+			switch (transform_activation)
+			{
+			case nnp_activation_identity:
+				output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias;
+				break;
+			case nnp_activation_relu:
+				output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias_with_relu;
+				break;
+			default:
+				NNP_UNREACHABLE;
+				break;
+			}
 			break;
 		}
-		if (input_transform_function != NULL && kernel_transform_function != NULL && output_transform_function != NULL)
-			break;
 #endif
 		/*
 		* Fallthrough otherwise. The rationale here is that only some backends have fp16 storage natively implemented
 		* (e.g. ARM NEON + VFP_FP16 currently), while configuration is (currently) fairly platform-independent.
 		* Thus silently falling back to the baseline Winograd implementation is reasonable.
+		* On x86-64 with F16C, only the kernel transform is stored in fp16 (see below).
 		*/
 
 	case nnp_convolution_algorithm_wt8x8:
@@ -1276,7 +2450,14 @@ enum nnp_status nnp_convolution_inference(
 		}
 		input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream;
 		kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3;
-		switch (activation)
+#if NNP_BACKEND_X86_64
+		if (kernel_transform_element_size == sizeof(uint16_t))
+		{
+			/* Halves kernel transform footprint and bandwidth; the tuple GEMM widens it to fp32 in registers */
+			kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16;
+		}
+#endif /* NNP_BACKEND_X86_64 */
+		switch (transform_activation)
 		{
 			case nnp_activation_identity:
 				if (output_subsampling.height == 1 && output_subsampling.width == 1)
@@ -1315,7 +2496,7 @@ enum nnp_status nnp_convolution_inference(
 		input_transform_function = nnp_hwinfo.transforms.fft8x8_with_offset_and_stream;
 		kernel_transform_function = nnp_hwinfo.transforms.fft8x8_with_offset_and_stream;
 		fourier_transform = true;
-		if (activation == nnp_activation_relu)
+		if (transform_activation == nnp_activation_relu)
 			output_transform_function = nnp_hwinfo.transforms.ifft8x8_with_bias_with_relu;
 		else
 			output_transform_function = nnp_hwinfo.transforms.ifft8x8_with_bias;
@@ -1340,13 +2521,45 @@ enum nnp_status nnp_convolution_inference(
 		input_transform_function = nnp_hwinfo.transforms.fft16x16_with_offset_and_stream;
 		kernel_transform_function = nnp_hwinfo.transforms.fft16x16_with_offset_and_stream;
 		fourier_transform = true;
-		if (activation == nnp_activation_relu)
+		if (transform_activation == nnp_activation_relu)
 			output_transform_function = nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu;
 		else
 			output_transform_function = nnp_hwinfo.transforms.ifft16x16_with_bias;
 	}
 	break;
 
+	case nnp_convolution_algorithm_ft32x32:
+	{
+		/* 32x32 transforms are implemented only for backends with 4-wide complex tuples, not for x86-64 */
+		if (nnp_hwinfo.transforms.fft32x32_with_offset_and_stream == NULL)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+
+		if (max(kernel_size.height, kernel_size.width) > 32)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+
+		if (max(output_subsampling.height, output_subsampling.width) > 1)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+
+		tile_size = (struct nnp_size) { .width = 32, .height = 32 };
+		input_transform_function = nnp_hwinfo.transforms.fft32x32_with_offset_and_stream;
+		kernel_transform_function = nnp_hwinfo.transforms.fft32x32_with_offset_and_stream;
+		fourier_transform = true;
+		if (transform_activation == nnp_activation_relu)
+			output_transform_function = nnp_hwinfo.transforms.ifft32x32_with_bias_with_relu;
+		else
+			output_transform_function = nnp_hwinfo.transforms.ifft32x32_with_bias;
+	}
+	break;
+
 	case nnp_convolution_algorithm_implicit_gemm:
 		break;
 	
@@ -1381,6 +2594,7 @@ enum nnp_status nnp_convolution_inference(
 	case nnp_convolution_algorithm_wt8x8_fp16:
 	case nnp_convolution_algorithm_ft8x8:
 	case nnp_convolution_algorithm_ft16x16:
+	case nnp_convolution_algorithm_ft32x32:
 	{
 		if (input_transform_function == NULL || kernel_transform_function == NULL || output_transform_function == NULL) 
 		{
@@ -1389,26 +2603,21 @@ enum nnp_status nnp_convolution_inference(
 		}
 		
 		status = compute_fast_convolution_inference(
-			fourier_transform, transform_strategy, transform_element_size,
+			fourier_transform, transform_strategy, transform_element_size, kernel_transform_element_size,
 			input_channels, output_channels,
 			tile_size, input_size, input_padding, kernel_size, output_size, output_subsampling,
-			input, kernel, bias, output, workspace_buffer, workspace_size,
-			input_transform_function, kernel_transform_function, output_transform_function, profile);
+			input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+			input_transform_function, kernel_transform_function, output_transform_function, activation, pooling, profile);
 	}
 	break;
 
 	case nnp_convolution_algorithm_implicit_gemm:
 	{
-		if (transform_strategy != nnp_convolution_transform_strategy_compute)
-		{
-			status = nnp_status_unsupported_transform_strategy;
-			goto cleanup;
-		}
 		status = compute_gemm_convolution_inference(
 			transform_strategy,
 			input_channels, output_channels,
 			input_size, input_padding, kernel_size, output_size, output_subsampling,
-			input, kernel, bias, output, workspace_buffer, workspace_size, activation, profile);
+			input, kernel, bias, residual, output, workspace_buffer, workspace_size, activation, pooling, profile);
 	}
 	break;
 
@@ -1422,7 +2631,7 @@ enum nnp_status nnp_convolution_inference(
 
 		status = compute_direct_convolution_inference(
 			input_channels, output_channels, input_size, kernel_size,
-			input, kernel, bias, output, workspace_buffer, workspace_size, activation, profile);
+			input, kernel, bias, residual, output, workspace_buffer, workspace_size, activation, pooling, profile);
 	}
 	break;
 
@@ -1434,3 +2643,146 @@ cleanup:
 	NNP_TOTAL_END(profile)
 	return status;
 }
+
+enum nnp_status nnp_convolution_inference_query(
+	enum nnp_convolution_algorithm algorithm,
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const enum nnp_activation activation,
+	const enum nnp_convolution_pooling pooling,
+	struct nnp_convolution_info* info)
+{
+	enum nnp_status status = validate_convolution_arguments(1, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, activation, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	const struct nnp_size output_size =
+	{
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+
+	if (algorithm == nnp_convolution_algorithm_auto)
+		algorithm = select_algorithm(
+			transform_strategy, input_channels, output_channels,
+			input_size, kernel_size, output_subsampling, output_size,
+			activation, pooling);
+
+	/* Workspace size query also rejects parameters the algorithm does not support */
+	size_t workspace_size = 0;
+	status = nnp_convolution_inference(
+		algorithm, transform_strategy, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &workspace_size,
+		activation, NULL, pooling, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	struct convolution_cost cost;
+	if (!estimate_convolution_cost(algorithm, transform_strategy,
+		input_channels, output_channels, input_size, kernel_size, output_subsampling, output_size, activation, pooling,
+		pthreadpool_get_threads_count(), &cost))
+	{
+		return nnp_status_unsupported_algorithm;
+	}
+
+	if (info != NULL)
+	{
+		*info = (struct nnp_convolution_info)
+		{
+			.algorithm = algorithm,
+			.workspace_size = workspace_size,
+			.tile_size = cost.tile_size,
+			.tiles_count = cost.tiles_count,
+			.input_channels_block_max = cost.input_channels_block_max,
+			.tiles_block_max = cost.tiles_block_max,
+			.output_channels_block_max = cost.output_channels_block_max,
+			.transform_flops = cost.transform_flops,
+			.gemm_flops = cost.gemm_flops,
+			.memory_bytes = cost.bytes,
+		};
+	}
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_convolution_inference_fold_batch_norm(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	const float* mean,
+	const float* variance,
+	const float* gamma,
+	const float* beta,
+	const float epsilon,
+	void* transformed_kernel,
+	size_t* transformed_kernel_size,
+	float* folded_bias,
+	struct nnp_profile* profile)
+{
+	/* Size query does not depend on batch normalization parameters */
+	if (transformed_kernel == NULL)
+		return nnp_convolution_inference(
+			algorithm, nnp_convolution_transform_strategy_precompute,
+			input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			NULL, NULL, NULL, NULL, NULL, NULL, transformed_kernel_size,
+			nnp_activation_identity, NULL, nnp_convolution_pooling_none,
+			profile);
+
+	if (!(epsilon >= 0.0f) || !isfinite(epsilon))
+		return nnp_status_invalid_batch_norm_parameters;
+
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+	{
+		const float denominator = variance[output_channel] + epsilon;
+		if (!(denominator > 0.0f) || !isfinite(denominator))
+			return nnp_status_invalid_batch_norm_parameters;
+	}
+
+	/* Folded bias is staged after the scaled kernel and copied out only if the kernel transform succeeds */
+	const size_t kernel_elements = input_channels * kernel_size.height * kernel_size.width;
+	const size_t scaled_kernel_size = output_channels * kernel_elements * sizeof(float);
+	const size_t staged_bias_size = output_channels * sizeof(float);
+	float* scaled_kernel = allocate_memory(scaled_kernel_size + staged_bias_size);
+	if (scaled_kernel == NULL)
+		return nnp_status_out_of_memory;
+	float* staged_bias = scaled_kernel + output_channels * kernel_elements;
+
+	/*
+	 * y = gamma * (conv(x, w) + b - mean) / sqrt(var + eps) + beta = conv(x, w * scale) + (b - mean) * scale + beta.
+	 * Transforms are linear, so scaling the kernel before the transform bakes the scale into the transformed kernel.
+	 */
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+	{
+		const float scale = (gamma != NULL ? gamma[output_channel] : 1.0f) / sqrtf(variance[output_channel] + epsilon);
+		for (size_t index = 0; index < kernel_elements; index++)
+			scaled_kernel[output_channel * kernel_elements + index] = kernel[output_channel * kernel_elements + index] * scale;
+
+		const float bias_value = (bias != NULL ? bias[output_channel] : 0.0f);
+		staged_bias[output_channel] = (bias_value - mean[output_channel]) * scale + (beta != NULL ? beta[output_channel] : 0.0f);
+	}
+
+	const enum nnp_status status = nnp_convolution_inference(
+		algorithm, nnp_convolution_transform_strategy_precompute,
+		input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, scaled_kernel, NULL, NULL, NULL, transformed_kernel, transformed_kernel_size,
+		nnp_activation_identity, NULL, nnp_convolution_pooling_none,
+		profile);
+	if (status == nnp_status_success)
+		memcpy(folded_bias, staged_bias, staged_bias_size);
+
+	release_memory(scaled_kernel, scaled_kernel_size + staged_bias_size);
+	return status;
+}
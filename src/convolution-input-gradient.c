@@ -2,10 +2,12 @@
 #include <cstdbool>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #else
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #endif
 
 #include <nnpack.h>
@@ -67,6 +69,7 @@ struct NNP_CACHE_ALIGN grad_output_transform_context
 {
 	const nnp_transform_2d_with_offset transform_function;
 	const float* grad_output;
+	const float* output;
 	float* grad_output_transform;
 
 	const size_t tuple_elements;
@@ -78,6 +81,7 @@ struct NNP_CACHE_ALIGN grad_output_transform_context
 	const size_t row_count;
 	const size_t column_offset;
 	const size_t column_count;
+	const enum nnp_activation activation;
 };
 
 static void compute_grad_output_transform(
@@ -96,8 +100,10 @@ static void compute_grad_output_transform(
 	const size_t row_count                                = context->row_count;
 	const size_t column_offset                            = context->column_offset;
 	const size_t column_count                             = context->column_count;
+	const enum nnp_activation activation                  = context->activation;
 
 	const float* grad_output                              = context->grad_output;
+	const float* output                                   = context->output;
 	float* grad_output_transform                          = context->grad_output_transform;
 	const nnp_transform_2d_with_offset transform_function = context->transform_function;
 
@@ -105,13 +111,28 @@ static void compute_grad_output_transform(
 	const size_t output_channels_block_size   = min(output_channels - output_channels_block_start, output_channels_block_max);
 	const size_t output_channels_block_offset = output_channel - output_channels_block_start;
 
+	/* With ReLU, the gradient is masked by the forward output while the tile is loaded into a stack block */
+	float block[16 * 16];
 	for (size_t batch_subblock_offset = 0; batch_subblock_offset < batch_subblock_size; batch_subblock_offset++)
 	{
 		const size_t sample = batch_subblock_start + batch_subblock_offset;
+		const size_t channel_offset = ((sample * output_channels) + output_channel) * output_size.width * output_size.height;
+		const float* grad_output_tile = grad_output + channel_offset;
+		size_t grad_output_stride = output_size.width;
+		if (activation == nnp_activation_relu)
+		{
+			const float* output_tile = output + channel_offset;
+			for (size_t row = 0; row < row_count; row++)
+				for (size_t column = 0; column < column_count; column++)
+					block[row * column_count + column] = output_tile[row * output_size.width + column] > 0.0f ? grad_output_tile[row * output_size.width + column] : 0.0f;
+
+			grad_output_tile = block;
+			grad_output_stride = column_count;
+		}
 		transform_function(
-			grad_output + ((sample * output_channels) + output_channel) * output_size.width * output_size.height,
+			grad_output_tile,
 			grad_output_transform +	(output_channels_block_start * batch_size + batch_subblock_start * output_channels_block_size + output_channels_block_offset * batch_subblock_size + batch_subblock_offset) * tuple_elements,
-			output_size.width,
+			grad_output_stride,
 			batch_size * output_channels * tuple_elements * sizeof(float),
 			row_count, column_count,
 			row_offset,	column_offset);
@@ -266,6 +287,7 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 	const struct nnp_size kernel_size,
 	const struct nnp_size output_size,
 	const float* grad_output,
+	const float* output,
 	const float* kernel,
 	float* grad_input,
 	void* workspace_buffer,
@@ -273,6 +295,7 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 	const nnp_transform_2d_with_offset grad_output_transform_function,
 	const nnp_transform_2d_with_offset kernel_transform_function,
 	const nnp_transform_2d_with_offset grad_input_transform_function,
+	const enum nnp_activation activation,
 	struct nnp_profile* profile)
 {
 	void* memory_block = NULL;
@@ -382,6 +405,7 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 			{
 				.transform_function = grad_output_transform_function,
 				.grad_output = grad_output + grad_output_y * output_size.width + grad_output_x,
+				.output = output + grad_output_y * output_size.width + grad_output_x,
 				.grad_output_transform = grad_output_transform,
 				.tuple_elements = tuple_elements,
 				.batch_size = batch_size,
@@ -391,7 +415,8 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 				.row_offset = row_offset,
 				.row_count = min(output_size.height - grad_output_y,	tile_size.height - row_offset),
 				.column_offset = column_offset,
-				.column_count = min(output_size.width - grad_output_x, tile_size.width - column_offset)
+				.column_count = min(output_size.width - grad_output_x, tile_size.width - column_offset),
+				.activation = activation
 			};
 			pthreadpool_compute_2d_tiled(
 				(pthreadpool_function_2d_tiled_t)compute_grad_output_transform,
@@ -495,6 +520,609 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 	return nnp_status_success;
 }
 
+struct NNP_CACHE_ALIGN grad_output_upsampling_context
+{
+	const struct nnp_size output_size;
+	const struct nnp_size output_subsampling;
+	const struct nnp_size upsampled_output_size;
+	const float* grad_output;
+	const float* output;
+	float* upsampled_grad_output;
+	const enum nnp_activation activation;
+};
+
+static void compute_grad_output_upsampling(
+	const struct grad_output_upsampling_context* context,
+	const size_t channel)
+{
+	const struct nnp_size output_size           = context->output_size;
+	const struct nnp_size output_subsampling    = context->output_subsampling;
+	const struct nnp_size upsampled_output_size = context->upsampled_output_size;
+	const enum nnp_activation activation        = context->activation;
+	const float* grad_output                    = context->grad_output + channel * output_size.height * output_size.width;
+	const float* output                         = context->output + channel * output_size.height * output_size.width;
+	float* upsampled_grad_output                = context->upsampled_grad_output + channel * upsampled_output_size.height * upsampled_output_size.width;
+
+	memset(upsampled_grad_output, 0, upsampled_output_size.height * upsampled_output_size.width * sizeof(float));
+	for (size_t y = 0; y < output_size.height; y++)
+	{
+		float* upsampled_row = upsampled_grad_output + y * output_subsampling.height * upsampled_output_size.width;
+		for (size_t x = 0; x < output_size.width; x++)
+		{
+			const size_t index = y * output_size.width + x;
+			if (activation != nnp_activation_relu || output[index] > 0.0f)
+				upsampled_row[x * output_subsampling.width] = grad_output[index];
+		}
+	}
+}
+
+/*
+ * Strided convolution is the unit-stride convolution sampled at every output_subsampling-th position, so its input
+ * gradient is the unit-stride input gradient of grad_output with zeros inserted between the sampled positions.
+ */
+static enum nnp_status compute_strided_convolution_input_gradient(
+	const enum nnp_convolution_algorithm algorithm,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size output_size,
+	const float* grad_output,
+	const float* output,
+	const float* kernel,
+	float* grad_input,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
+	struct nnp_profile* profile)
+{
+	const struct nnp_size unit_subsampling = { .width = 1, .height = 1 };
+	const struct nnp_size upsampled_output_size =
+	{
+		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
+		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+	};
+
+	size_t input_gradient_workspace_size = 0;
+	enum nnp_status status = nnp_convolution_input_gradient(
+		algorithm, batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, unit_subsampling,
+		NULL, NULL, NULL, NULL, NULL, &input_gradient_workspace_size,
+		nnp_activation_identity, NULL, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	const size_t upsampled_grad_output_size = round_up(batch_size * output_channels * upsampled_output_size.height * upsampled_output_size.width * sizeof(float), 64);
+	const size_t memory_size = upsampled_grad_output_size + input_gradient_workspace_size;
+	void* memory_block = NULL;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	float* upsampled_grad_output = (float*)memory_block;
+	void* input_gradient_workspace = (input_gradient_workspace_size == 0 ? NULL : (char*)memory_block + upsampled_grad_output_size);
+
+	struct grad_output_upsampling_context grad_output_upsampling_context =
+	{
+		.output_size = output_size,
+		.output_subsampling = output_subsampling,
+		.upsampled_output_size = upsampled_output_size,
+		.grad_output = grad_output,
+		.output = output,
+		.upsampled_grad_output = upsampled_grad_output,
+		.activation = activation
+	};
+	pthreadpool_compute_1d(
+		(pthreadpool_function_1d_t)compute_grad_output_upsampling,
+		&grad_output_upsampling_context,
+		batch_size * output_channels);
+
+	status = nnp_convolution_input_gradient(
+		algorithm, batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, unit_subsampling,
+		upsampled_grad_output, NULL, kernel, grad_input,
+		input_gradient_workspace, input_gradient_workspace == NULL ? NULL : &input_gradient_workspace_size,
+		nnp_activation_identity, NULL, profile);
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return status;
+}
+
+/*
+ * Input gradient is a unit-stride convolution of grad_output with the spatially flipped kernel, input and output channels
+ * swapped, and padding complemented to kernel_size - 1. It is computed image by image with the direct (1x1) or implicit
+ * GEMM implementation of nnp_convolution_inference.
+ */
+static enum nnp_status compute_gemm_convolution_input_gradient(
+	const enum nnp_convolution_algorithm algorithm,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_size,
+	const float* grad_output,
+	const float* output,
+	const float* kernel,
+	float* grad_input,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
+	struct nnp_profile* profile)
+{
+	const struct nnp_size unit_subsampling = { .width = 1, .height = 1 };
+	const struct nnp_padding grad_output_padding =
+	{
+		.top = kernel_size.height - 1 - input_padding.top,
+		.right = kernel_size.width - 1 - input_padding.right,
+		.bottom = kernel_size.height - 1 - input_padding.bottom,
+		.left = kernel_size.width - 1 - input_padding.left
+	};
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const size_t output_elements = output_size.height * output_size.width;
+	const size_t input_elements = input_size.height * input_size.width;
+
+	size_t inference_workspace_size = 0;
+	enum nnp_status status = nnp_convolution_inference(
+		algorithm, nnp_convolution_transform_strategy_compute,
+		output_channels, input_channels,
+		output_size, grad_output_padding, kernel_size, unit_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &inference_workspace_size,
+		nnp_activation_identity, NULL, nnp_convolution_pooling_none, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	const size_t flipped_kernel_size = round_up(input_channels * output_channels * kernel_elements * sizeof(float), 64);
+	const size_t zero_bias_size = round_up(input_channels * sizeof(float), 64);
+	const size_t masked_grad_output_size = (activation == nnp_activation_relu ? round_up(output_channels * output_elements * sizeof(float), 64) : 0);
+	const size_t memory_size = flipped_kernel_size + zero_bias_size + masked_grad_output_size + inference_workspace_size;
+	void* memory_block = NULL;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	float* flipped_kernel = (float*)memory_block;
+	float* zero_bias = (float*)((char*)memory_block + flipped_kernel_size);
+	float* masked_grad_output = (float*)((char*)memory_block + flipped_kernel_size + zero_bias_size);
+	void* inference_workspace = (inference_workspace_size == 0 ? NULL : (char*)memory_block + flipped_kernel_size + zero_bias_size + masked_grad_output_size);
+
+	NNP_KERNEL_TRANSFORM_START(profile)
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+	{
+		for (size_t input_channel = 0; input_channel < input_channels; input_channel++)
+		{
+			const float* kernel_channel = kernel + (output_channel * input_channels + input_channel) * kernel_elements;
+			float* flipped_kernel_channel = flipped_kernel + (input_channel * output_channels + output_channel) * kernel_elements;
+			for (size_t index = 0; index < kernel_elements; index++)
+				flipped_kernel_channel[index] = kernel_channel[kernel_elements - 1 - index];
+		}
+	}
+	memset(zero_bias, 0, input_channels * sizeof(float));
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	for (size_t sample = 0; sample < batch_size && status == nnp_status_success; sample++)
+	{
+		const float* grad_output_sample = grad_output + sample * output_channels * output_elements;
+		if (activation == nnp_activation_relu)
+		{
+			/* Without tile transforms there is no load stage to fuse the mask into, so it is applied to a per-image copy */
+			const float* output_sample = output + sample * output_channels * output_elements;
+			for (size_t index = 0; index < output_channels * output_elements; index++)
+				masked_grad_output[index] = output_sample[index] > 0.0f ? grad_output_sample[index] : 0.0f;
+
+			grad_output_sample = masked_grad_output;
+		}
+
+		size_t inference_buffer_size = inference_workspace_size;
+		status = nnp_convolution_inference(
+			algorithm, nnp_convolution_transform_strategy_compute,
+			output_channels, input_channels,
+			output_size, grad_output_padding, kernel_size, unit_subsampling,
+			grad_output_sample, flipped_kernel, zero_bias, NULL,
+			grad_input + sample * input_channels * input_elements,
+			inference_workspace, inference_workspace == NULL ? NULL : &inference_buffer_size,
+			nnp_activation_identity, NULL, nnp_convolution_pooling_none, NULL);
+	}
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return status;
+}
+
+struct NNP_CACHE_ALIGN grad_output_packing_context
+{
+	size_t output_elements;
+	size_t pixels_start;
+	size_t output_channels_block_start;
+	size_t output_channels_block_size;
+	const float* grad_output;
+	const float* output;
+	float* packed_grad_output;
+	enum nnp_activation activation;
+};
+
+/*
+ * Packs a subblock of output pixels for a block of output channels, interleaved by channel, as the left operand of sgemm.
+ * The ReLU mask is applied here, so grad_output is read only once.
+ */
+static void compute_grad_output_packing(
+	const struct grad_output_packing_context context[restrict static 1],
+	size_t pixels_subblock_start,
+	size_t pixels_subblock_size)
+{
+	const size_t output_elements = context->output_elements;
+	const size_t output_channels_block_start = context->output_channels_block_start;
+	const size_t output_channels_block_size = context->output_channels_block_size;
+	const size_t offset = output_channels_block_start * output_elements + context->pixels_start + pixels_subblock_start;
+	const float* grad_output = context->grad_output + offset;
+	float* packed_grad_output = context->packed_grad_output + pixels_subblock_start * output_channels_block_size;
+
+	for (size_t output_channels_block_offset = 0; output_channels_block_offset < output_channels_block_size; output_channels_block_offset++)
+	{
+		const float* grad_output_row = grad_output + output_channels_block_offset * output_elements;
+		if (context->activation == nnp_activation_relu)
+		{
+			const float* output_row = context->output + offset + output_channels_block_offset * output_elements;
+			for (size_t pixels_subblock_offset = 0; pixels_subblock_offset < pixels_subblock_size; pixels_subblock_offset++)
+				*packed_grad_output++ = output_row[pixels_subblock_offset] > 0.0f ? grad_output_row[pixels_subblock_offset] : 0.0f;
+		}
+		else
+		{
+			for (size_t pixels_subblock_offset = 0; pixels_subblock_offset < pixels_subblock_size; pixels_subblock_offset++)
+				*packed_grad_output++ = grad_output_row[pixels_subblock_offset];
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN kernel_packing_context
+{
+	size_t column_elements;
+	size_t output_channels_block_start;
+	size_t output_channels_block_size;
+	size_t simd_width;
+	const float* kernel;
+	float* packed_kernel;
+};
+
+/* Packs a subblock of kernel columns for a block of output channels, interleaved by column, as the right operand of sgemm */
+static void compute_kernel_packing(
+	const struct kernel_packing_context context[restrict static 1],
+	size_t columns_subblock_start,
+	size_t columns_subblock_size)
+{
+	const size_t column_elements = context->column_elements;
+	const size_t output_channels_block_size = context->output_channels_block_size;
+	const size_t columns_subblock_stride = round_up(columns_subblock_size, context->simd_width);
+	const float* kernel = context->kernel + context->output_channels_block_start * column_elements + columns_subblock_start;
+	float* packed_kernel = context->packed_kernel + columns_subblock_start * output_channels_block_size;
+
+	for (size_t output_channels_block_offset = 0; output_channels_block_offset < output_channels_block_size; output_channels_block_offset++)
+	{
+		for (size_t columns_subblock_offset = 0; columns_subblock_offset < columns_subblock_size; columns_subblock_offset++)
+			packed_kernel[output_channels_block_offset * columns_subblock_stride + columns_subblock_offset] =
+				kernel[output_channels_block_offset * column_elements + columns_subblock_offset];
+	}
+}
+
+struct NNP_CACHE_ALIGN column_multiplication_context
+{
+	const float* packed_grad_output;
+	const float* packed_kernel;
+	float* columns;
+	size_t column_elements;
+	size_t output_channels_block_size;
+	size_t update;
+	size_t pixels_subblock_max;
+	size_t columns_subblock_max;
+	nnp_fast_sgemm_function fast_sgemm_function;
+	nnp_full_sgemm_function full_sgemm_function;
+};
+
+static void compute_column_multiplication(
+	const struct column_multiplication_context context[restrict static 1],
+	size_t pixels_subblock_start,
+	size_t columns_block_start,
+	size_t pixels_subblock_size,
+	size_t columns_block_size)
+{
+	const size_t column_elements = context->column_elements;
+	const size_t output_channels_block_size = context->output_channels_block_size;
+	const size_t update = context->update;
+	const size_t columns_subblock_max = context->columns_subblock_max;
+	const float* packed_grad_output = context->packed_grad_output + pixels_subblock_start * output_channels_block_size;
+
+	for (size_t columns_subblock_start = 0; columns_subblock_start < columns_block_size; columns_subblock_start += columns_subblock_max)
+	{
+		const size_t columns_subblock_size = min(columns_block_size - columns_subblock_start, columns_subblock_max);
+		const size_t column = columns_block_start + columns_subblock_start;
+		const float* packed_kernel = context->packed_kernel + column * output_channels_block_size;
+		float* columns = context->columns + pixels_subblock_start * column_elements + column;
+		if (pixels_subblock_size == context->pixels_subblock_max && columns_subblock_size == columns_subblock_max)
+		{
+			context->fast_sgemm_function(
+				output_channels_block_size, update,
+				packed_grad_output, packed_kernel, columns, column_elements);
+		}
+		else
+		{
+			context->full_sgemm_function(
+				pixels_subblock_size, columns_subblock_size,
+				output_channels_block_size, update,
+				packed_grad_output, packed_kernel, columns, column_elements);
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN column_folding_context
+{
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_subsampling;
+	struct nnp_size output_size;
+	size_t input_channels;
+	size_t pixels_start;
+	size_t pixels_count;
+	const float* columns;
+	float* grad_input;
+};
+
+static void compute_column_folding(
+	const struct column_folding_context context[restrict static 1],
+	size_t input_channel)
+{
+	const struct nnp_size input_size = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size kernel_size = context->kernel_size;
+	const struct nnp_size output_subsampling = context->output_subsampling;
+	const struct nnp_size output_size = context->output_size;
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const size_t columns_stride = context->input_channels * kernel_elements;
+	const size_t pixels_count = context->pixels_count;
+
+	const float* columns = context->columns + input_channel * kernel_elements;
+	float* grad_input = context->grad_input + input_channel * input_size.height * input_size.width;
+
+	size_t y = context->pixels_start / output_size.width;
+	size_t x = context->pixels_start % output_size.width;
+	for (size_t pixel = 0; pixel < pixels_count; pixel++)
+	{
+		const float* column = columns + pixel * columns_stride;
+		for (size_t kernel_y = 0; kernel_y < kernel_size.height; kernel_y++)
+		{
+			/* Unsigned wrap-around makes padding rows and columns compare above the input size */
+			const size_t input_y = y * output_subsampling.height + kernel_y - input_padding.top;
+			if (input_y >= input_size.height)
+				continue;
+
+			for (size_t kernel_x = 0; kernel_x < kernel_size.width; kernel_x++)
+			{
+				const size_t input_x = x * output_subsampling.width + kernel_x - input_padding.left;
+				if (input_x < input_size.width)
+					grad_input[input_y * input_size.width + input_x] += column[kernel_y * kernel_size.width + kernel_x];
+			}
+		}
+
+		if (++x == output_size.width)
+		{
+			x = 0;
+			y++;
+		}
+	}
+}
+
+/*
+ * Strided input gradient without zero-stuffing: a GEMM of grad_output with the kernel produces, for every output pixel,
+ * its contribution to input_channels * kernel_pixels input positions, which are then added into grad_input (col2im).
+ * The kernel is packed once for sgemm. Output pixels are processed in blocks sized to keep the columns in L2, and the
+ * reduction over output channels is split into blocks sized for L1, which sgemm accumulates into the columns.
+ */
+static enum nnp_status compute_strided_gemm_convolution_input_gradient(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size output_size,
+	const float* grad_output,
+	const float* output,
+	const float* kernel,
+	float* grad_input,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation,
+	struct nnp_profile* profile)
+{
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const size_t output_elements = output_size.height * output_size.width;
+	const size_t input_elements = input_size.height * input_size.width;
+	const size_t column_elements = input_channels * kernel_elements;
+
+	const size_t pixels_subblock_max = nnp_hwinfo.sgemm.mr;
+	const size_t columns_subblock_max = nnp_hwinfo.sgemm.nr;
+	/* A row panel of each packed operand fits in L1 */
+	const size_t output_channels_block_max = min(max(nnp_hwinfo.blocking.l1 / ((pixels_subblock_max + columns_subblock_max) * sizeof(float)), 1), output_channels);
+	/* Blocks of fewer than 64 pixels would leave the GEMM with too few rows to be efficient */
+	const size_t pixels_block_max = min(max(nnp_hwinfo.blocking.l2 / ((column_elements + output_channels_block_max) * sizeof(float)), 64), output_elements);
+	const size_t columns_block_max = max(round_down(nnp_hwinfo.blocking.l2 / (output_channels_block_max * sizeof(float)), columns_subblock_max), columns_subblock_max);
+
+	const size_t packed_kernel_size = round_up(round_up(column_elements, columns_subblock_max) * output_channels * sizeof(float), 64);
+	const size_t packed_grad_output_size = round_up(round_up(pixels_block_max, pixels_subblock_max) * output_channels_block_max * sizeof(float), 64);
+	const size_t columns_size = round_up(pixels_block_max * column_elements * sizeof(float), 64);
+	const size_t memory_size = packed_kernel_size + packed_grad_output_size + columns_size;
+	void* memory_block = NULL;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	float* packed_kernel = (float*)memory_block;
+	float* packed_grad_output = (float*)((char*)memory_block + packed_kernel_size);
+	float* columns = (float*)((char*)memory_block + packed_kernel_size + packed_grad_output_size);
+
+	/* Blocks of output channels of the packed kernel follow each other */
+	NNP_KERNEL_TRANSFORM_START(profile)
+	for (size_t output_channels_block_start = 0; output_channels_block_start < output_channels; output_channels_block_start += output_channels_block_max)
+	{
+		struct kernel_packing_context kernel_packing_context =
+		{
+			.column_elements = column_elements,
+			.output_channels_block_start = output_channels_block_start,
+			.output_channels_block_size = min(output_channels - output_channels_block_start, output_channels_block_max),
+			.simd_width = nnp_hwinfo.simd_width,
+			.kernel = kernel,
+			.packed_kernel = packed_kernel + round_up(column_elements, columns_subblock_max) * output_channels_block_start,
+		};
+		pthreadpool_compute_1d_tiled(
+			(pthreadpool_function_1d_tiled_t)compute_kernel_packing,
+			&kernel_packing_context,
+			column_elements, columns_subblock_max);
+	}
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	struct column_multiplication_context column_multiplication_context =
+	{
+		.packed_grad_output = packed_grad_output,
+		.columns = columns,
+		.column_elements = column_elements,
+		.pixels_subblock_max = pixels_subblock_max,
+		.columns_subblock_max = columns_subblock_max,
+		.fast_sgemm_function = nnp_hwinfo.sgemm.only_mr_x_nr,
+		.full_sgemm_function = nnp_hwinfo.sgemm.upto_mr_x_nr,
+	};
+	for (size_t sample = 0; sample < batch_size; sample++)
+	{
+		float* grad_input_sample = grad_input + sample * input_channels * input_elements;
+		memset(grad_input_sample, 0, input_channels * input_elements * sizeof(float));
+
+		for (size_t pixels_start = 0; pixels_start < output_elements; pixels_start += pixels_block_max)
+		{
+			const size_t pixels_count = min(output_elements - pixels_start, pixels_block_max);
+
+			for (size_t output_channels_block_start = 0; output_channels_block_start < output_channels; output_channels_block_start += output_channels_block_max)
+			{
+				const size_t output_channels_block_size = min(output_channels - output_channels_block_start, output_channels_block_max);
+
+				NNP_INPUT_TRANSFORM_START(profile)
+				struct grad_output_packing_context grad_output_packing_context =
+				{
+					.output_elements = output_elements,
+					.pixels_start = pixels_start,
+					.output_channels_block_start = output_channels_block_start,
+					.output_channels_block_size = output_channels_block_size,
+					.grad_output = grad_output + sample * output_channels * output_elements,
+					.output = (activation == nnp_activation_relu ? output + sample * output_channels * output_elements : NULL),
+					.packed_grad_output = packed_grad_output,
+					.activation = activation,
+				};
+				pthreadpool_compute_1d_tiled(
+					(pthreadpool_function_1d_tiled_t)compute_grad_output_packing,
+					&grad_output_packing_context,
+					pixels_count, pixels_subblock_max);
+				NNP_INPUT_TRANSFORM_END(profile)
+
+				NNP_BLOCK_MULTIPLICATION_START(profile)
+				column_multiplication_context.packed_kernel = packed_kernel + round_up(column_elements, columns_subblock_max) * output_channels_block_start;
+				column_multiplication_context.output_channels_block_size = output_channels_block_size;
+				column_multiplication_context.update = (output_channels_block_start != 0);
+				pthreadpool_compute_2d_tiled(
+					(pthreadpool_function_2d_tiled_t)compute_column_multiplication,
+					&column_multiplication_context,
+					pixels_count, column_elements,
+					pixels_subblock_max, columns_block_max);
+				NNP_BLOCK_MULTIPLICATION_END(profile)
+			}
+
+			NNP_OUTPUT_TRANSFORM_START(profile)
+			struct column_folding_context column_folding_context =
+			{
+				.input_size = input_size,
+				.input_padding = input_padding,
+				.kernel_size = kernel_size,
+				.output_subsampling = output_subsampling,
+				.output_size = output_size,
+				.input_channels = input_channels,
+				.pixels_start = pixels_start,
+				.pixels_count = pixels_count,
+				.columns = columns,
+				.grad_input = grad_input_sample,
+			};
+			pthreadpool_compute_1d(
+				(pthreadpool_function_1d_t)compute_column_folding,
+				&column_folding_context,
+				input_channels);
+			NNP_OUTPUT_TRANSFORM_END(profile)
+		}
+	}
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return nnp_status_success;
+}
+
 enum nnp_status nnp_convolution_input_gradient(
 	enum nnp_convolution_algorithm algorithm,
 	const size_t batch_size,
@@ -503,7 +1131,9 @@ enum nnp_status nnp_convolution_input_gradient(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* grad_output,
+	const float* output,
 	const float* kernel,
 	float* grad_input,
 	void* workspace_buffer,
@@ -516,30 +1146,36 @@ enum nnp_status nnp_convolution_input_gradient(
 
 	const struct nnp_size output_size =
 	{
-		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
-		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
 	};
 
 	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, (struct nnp_size) { .width = 1, .height = 1 }, activation, activation_parameters);
+	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, activation, activation_parameters);
 	if (status != nnp_status_success) 
 		goto cleanup;
 	
-	if (activation != nnp_activation_identity) 
+	if (activation_parameters != NULL) 
 	{
-		status = nnp_status_unsupported_activation;
+		status = nnp_status_unsupported_activation_parameters;
 		goto cleanup;
 	}
 
-	if (activation_parameters != NULL) 
+	/* ReLU gradient is masked by the forward output, which is only optional for workspace size queries */
+	if (activation == nnp_activation_relu && output == NULL && !(workspace_buffer == NULL && workspace_size != NULL))
 	{
-		status = nnp_status_unsupported_activation_parameters;
+		status = nnp_status_invalid_activation;
 		goto cleanup;
 	}
 
 	if (algorithm == nnp_convolution_algorithm_auto) 
 	{
-		if (max(kernel_size.width, kernel_size.height) > 8) 
+		if (kernel_size.height == 1 && kernel_size.width == 1)
+			/* 1x1 convolution is a plain GEMM */
+			algorithm = nnp_convolution_algorithm_direct;
+		else if (output_subsampling.height != 1 || output_subsampling.width != 1)
+			algorithm = nnp_convolution_algorithm_implicit_gemm;
+		else if (max(kernel_size.width, kernel_size.height) > 8) 
 			algorithm = nnp_convolution_algorithm_ft16x16;
 		else 
 		{
@@ -561,6 +1197,28 @@ enum nnp_status nnp_convolution_input_gradient(
 				algorithm = nnp_convolution_algorithm_ft16x16;
 		}
 	}
+
+	if (output_subsampling.height != 1 || output_subsampling.width != 1)
+	{
+		if (algorithm == nnp_convolution_algorithm_direct || algorithm == nnp_convolution_algorithm_implicit_gemm)
+		{
+			/* GEMM-based algorithms fold strided columns directly, transform-based ones work on zero-stuffed grad_output */
+			if (algorithm == nnp_convolution_algorithm_direct && (kernel_size.height != 1 || kernel_size.width != 1))
+				status = nnp_status_unsupported_algorithm;
+			else
+				status = compute_strided_gemm_convolution_input_gradient(
+					batch_size, input_channels, output_channels,
+					input_size, input_padding, kernel_size, output_subsampling, output_size,
+					grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, activation, profile);
+			goto cleanup;
+		}
+
+		status = compute_strided_convolution_input_gradient(
+			algorithm, batch_size, input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling, output_size,
+			grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, activation, profile);
+		goto cleanup;
+	}
 	
 	/* Choose tiling parameters and transform functions depending on convolution algorithm */
 	switch (algorithm) 
@@ -571,17 +1229,35 @@ enum nnp_status nnp_convolution_input_gradient(
 			status = nnp_status_unsupported_algorithm;
 			goto cleanup;
 		}
-		status = compute_fast_convolution_input_gradient(false, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, grad_output, kernel, grad_input, workspace_buffer, workspace_size, nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream, nnp_hwinfo.transforms.kwt_f6x6_3Rx3R, nnp_hwinfo.transforms.owt_f6x6_3x3, profile);
+		status = compute_fast_convolution_input_gradient(false, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream, nnp_hwinfo.transforms.kwt_f6x6_3Rx3R, nnp_hwinfo.transforms.owt_f6x6_3x3, activation, profile);
 		break;
 
 	case nnp_convolution_algorithm_ft8x8:
-		status = compute_fast_convolution_input_gradient(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, grad_output, kernel, grad_input, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.ifft8x8_with_offset, profile);
+		status = compute_fast_convolution_input_gradient(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.ifft8x8_with_offset, activation, profile);
 		break;
 
 	case nnp_convolution_algorithm_ft16x16:
-		status = compute_fast_convolution_input_gradient(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size, grad_output, kernel, grad_input, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.ifft16x16_with_offset, profile);
+		status = compute_fast_convolution_input_gradient(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size, grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.ifft16x16_with_offset, activation, profile);
 	    break;
 
+	case nnp_convolution_algorithm_ft32x32:
+		/* 32x32 Fourier transforms are implemented only for the forward pass */
+		status = nnp_status_unsupported_algorithm;
+		break;
+
+	case nnp_convolution_algorithm_direct:
+		if (kernel_size.height != 1 || kernel_size.width != 1)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+		status = compute_gemm_convolution_input_gradient(algorithm, batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_size, grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, activation, profile);
+		break;
+
+	case nnp_convolution_algorithm_implicit_gemm:
+		status = compute_gemm_convolution_input_gradient(algorithm, batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_size, grad_output, output, kernel, grad_input, workspace_buffer, workspace_size, activation, profile);
+		break;
+
 	default:
 		status = nnp_status_invalid_algorithm;
 	}
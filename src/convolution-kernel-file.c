@@ -0,0 +1,356 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+
+#include <nnpack/hwinfo.h>
+
+
+/* "NNPKRNL\0" when read as a little-endian 64-bit integer; a byte-swapped magic identifies a foreign-endian file */
+#define NNP_KERNEL_FILE_MAGIC UINT64_C(0x004C4E524B504E4E)
+#define NNP_KERNEL_FILE_VERSION 2
+/* Payload starts on a page boundary, so the mapped transformed kernel is aligned for SIMD loads */
+#define NNP_KERNEL_FILE_PAYLOAD_OFFSET 4096
+
+enum kernel_file_backend
+{
+	kernel_file_backend_x86_64 = 1,
+	kernel_file_backend_psimd = 2,
+	kernel_file_backend_arm = 3,
+	kernel_file_backend_scalar = 4,
+};
+
+/* Everything in the host configuration that determines the layout of a transformed kernel */
+struct kernel_file_signature
+{
+	uint32_t backend;
+	uint32_t isa;
+	uint32_t simd_width;
+	uint32_t sxgemm_mr;
+	uint32_t sxgemm_nr;
+	uint32_t cxgemm_mr;
+	uint32_t cxgemm_nr;
+	/* Size of one transformed kernel element: 4 for fp32, 2 for fp16 */
+	uint32_t element_size;
+	uint64_t blocking_l1;
+	uint64_t blocking_l2;
+	uint64_t blocking_l3;
+};
+
+struct kernel_file_header
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t header_size;
+
+	uint32_t algorithm;
+	uint32_t tile_height;
+	uint32_t tile_width;
+	uint32_t kernel_height;
+	uint32_t kernel_width;
+	uint32_t output_subsampling_height;
+	uint32_t output_subsampling_width;
+	uint32_t reserved;
+	uint64_t input_channels;
+	uint64_t output_channels;
+
+	struct kernel_file_signature signature;
+
+	uint64_t payload_offset;
+	uint64_t payload_size;
+};
+
+#if !defined(_WIN32)
+/* Length of the mapping of a kernel file with the given payload size; load and unload must agree on it */
+static size_t get_mapping_size(uint64_t payload_size)
+{
+	return (size_t) (NNP_KERNEL_FILE_PAYLOAD_OFFSET + payload_size);
+}
+#endif
+
+static struct kernel_file_signature get_host_signature(void)
+{
+	struct kernel_file_signature signature;
+	memset(&signature, 0, sizeof(signature));
+#if NNP_BACKEND_X86_64
+	signature.backend = kernel_file_backend_x86_64;
+#elif NNP_BACKEND_ARM
+	signature.backend = kernel_file_backend_arm;
+#elif NNP_BACKEND_SCALAR
+	signature.backend = kernel_file_backend_scalar;
+#else
+	signature.backend = kernel_file_backend_psimd;
+#endif
+	signature.isa =
+		(nnp_hwinfo.isa.has_avx ? UINT32_C(1) : 0) |
+		(nnp_hwinfo.isa.has_fma3 ? UINT32_C(2) : 0) |
+		(nnp_hwinfo.isa.has_avx2 ? UINT32_C(4) : 0) |
+		(nnp_hwinfo.isa.has_f16c ? UINT32_C(8) : 0);
+	signature.simd_width = nnp_hwinfo.simd_width;
+	signature.sxgemm_mr = nnp_hwinfo.sxgemm.mr;
+	signature.sxgemm_nr = nnp_hwinfo.sxgemm.nr;
+	signature.cxgemm_mr = nnp_hwinfo.cxgemm.mr;
+	signature.cxgemm_nr = nnp_hwinfo.cxgemm.nr;
+	signature.blocking_l1 = nnp_hwinfo.blocking.l1;
+	signature.blocking_l2 = nnp_hwinfo.blocking.l2;
+	signature.blocking_l3 = nnp_hwinfo.blocking.l3;
+	return signature;
+}
+
+static enum nnp_status get_tile_size(enum nnp_convolution_algorithm algorithm, struct nnp_size* tile_size)
+{
+	switch (algorithm)
+	{
+	case nnp_convolution_algorithm_wt8x8:
+	case nnp_convolution_algorithm_wt8x8_fp16:
+	case nnp_convolution_algorithm_ft8x8:
+		*tile_size = (struct nnp_size) { .width = 8, .height = 8 };
+		return nnp_status_success;
+	case nnp_convolution_algorithm_ft16x16:
+		*tile_size = (struct nnp_size) { .width = 16, .height = 16 };
+		return nnp_status_success;
+	case nnp_convolution_algorithm_ft32x32:
+		*tile_size = (struct nnp_size) { .width = 32, .height = 32 };
+		return nnp_status_success;
+	case nnp_convolution_algorithm_implicit_gemm:
+	case nnp_convolution_algorithm_direct:
+		/* These algorithms do not have a pre-computed kernel transform */
+		return nnp_status_unsupported_transform_strategy;
+	default:
+		/* Auto must be resolved before the kernel is transformed: the file describes one concrete layout */
+		return nnp_status_invalid_algorithm;
+	}
+}
+
+/* Builds the header expected for the layer on this host and checks the transformed kernel size */
+static enum nnp_status init_header(
+	struct kernel_file_header* header,
+	enum nnp_convolution_algorithm algorithm,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling)
+{
+	if (!nnp_hwinfo.initialized)
+		return nnp_status_uninitialized;
+
+	if (!nnp_hwinfo.supported)
+		return nnp_status_unsupported_hardware;
+
+	struct nnp_size tile_size;
+	enum nnp_status status = get_tile_size(algorithm, &tile_size);
+	if (status != nnp_status_success)
+		return status;
+
+	/* Layout of the transformed kernel does not depend on the input size, so query it for the smallest valid input */
+	size_t payload_size = 0;
+	status = nnp_convolution_inference(
+		algorithm, nnp_convolution_transform_strategy_precompute,
+		input_channels, output_channels,
+		kernel_size, (struct nnp_padding) { 0, 0, 0, 0 }, kernel_size, output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &payload_size,
+		nnp_activation_identity, NULL, nnp_convolution_pooling_none,
+		NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	/* Element type of the transformed kernel is whatever the precompute call stores on this host, e.g. fp16 only with F16C */
+	const size_t tile_elements_count = (size_t) input_channels * output_channels * tile_size.height * tile_size.width;
+
+	memset(header, 0, sizeof(struct kernel_file_header));
+	header->magic = NNP_KERNEL_FILE_MAGIC;
+	header->version = NNP_KERNEL_FILE_VERSION;
+	header->header_size = sizeof(struct kernel_file_header);
+	header->algorithm = (uint32_t) algorithm;
+	header->tile_height = (uint32_t) tile_size.height;
+	header->tile_width = (uint32_t) tile_size.width;
+	header->kernel_height = (uint32_t) kernel_size.height;
+	header->kernel_width = (uint32_t) kernel_size.width;
+	header->output_subsampling_height = (uint32_t) output_subsampling.height;
+	header->output_subsampling_width = (uint32_t) output_subsampling.width;
+	header->input_channels = input_channels;
+	header->output_channels = output_channels;
+	header->signature = get_host_signature();
+	header->signature.element_size = (uint32_t) (payload_size / tile_elements_count);
+	header->payload_offset = NNP_KERNEL_FILE_PAYLOAD_OFFSET;
+	header->payload_size = payload_size;
+	return nnp_status_success;
+}
+
+static enum nnp_status validate_header(
+	const struct kernel_file_header* header,
+	const struct kernel_file_header* expected_header,
+	uint64_t file_size)
+{
+	if (header->magic != NNP_KERNEL_FILE_MAGIC || header->version != NNP_KERNEL_FILE_VERSION)
+		return nnp_status_invalid_kernel_file;
+
+	if (header->header_size != sizeof(struct kernel_file_header) || header->payload_offset != NNP_KERNEL_FILE_PAYLOAD_OFFSET)
+		return nnp_status_invalid_kernel_file;
+
+	/* Exact size match also lets unload recover the mapping length from the payload size */
+	if (header->payload_size != file_size - header->payload_offset)
+		return nnp_status_invalid_kernel_file;
+
+	if (header->algorithm != expected_header->algorithm)
+		return nnp_status_invalid_kernel_file;
+
+	/* A half-precision payload needs a host which reads kernel transforms in fp16 (F16C on x86-64) */
+	if (header->signature.element_size != expected_header->signature.element_size)
+		return nnp_status_unsupported_hardware;
+
+	if (memcmp(&header->signature, &expected_header->signature, sizeof(struct kernel_file_signature)) != 0)
+		return nnp_status_unsupported_hardware;
+
+	/* Tile size, payload size, and layer parameters must all match what this host would have produced */
+	if (memcmp(header, expected_header, sizeof(struct kernel_file_header)) != 0)
+		return nnp_status_invalid_kernel_file;
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_convolution_inference_save_kernel(
+	const char* path,
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const void* transformed_kernel,
+	const size_t transformed_kernel_size)
+{
+	struct kernel_file_header header;
+	enum nnp_status status = init_header(&header, algorithm, input_channels, output_channels, kernel_size, output_subsampling);
+	if (status != nnp_status_success)
+		return status;
+
+	if (transformed_kernel_size != header.payload_size)
+		return nnp_status_insufficient_buffer;
+
+	FILE* file = fopen(path, "wb");
+	if (file == NULL)
+		return nnp_status_io_error;
+
+	static const uint8_t padding[NNP_KERNEL_FILE_PAYLOAD_OFFSET] = { 0 };
+	bool written =
+		fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(padding, NNP_KERNEL_FILE_PAYLOAD_OFFSET - sizeof(header), 1, file) == 1 &&
+		(transformed_kernel_size == 0 || fwrite(transformed_kernel, transformed_kernel_size, 1, file) == 1);
+	written = (fclose(file) == 0) && written;
+
+	if (!written)
+	{
+		remove(path);
+		return nnp_status_io_error;
+	}
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_convolution_inference_load_kernel(
+	const char* path,
+	enum nnp_convolution_algorithm algorithm,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const void** transformed_kernel,
+	size_t* transformed_kernel_size)
+{
+	struct kernel_file_header expected_header;
+	enum nnp_status status = init_header(&expected_header, algorithm, input_channels, output_channels, kernel_size, output_subsampling);
+	if (status != nnp_status_success)
+		return status;
+
+	const void* mapping = NULL;
+	uint64_t file_size = 0;
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return nnp_status_io_error;
+
+	LARGE_INTEGER large_file_size;
+	if (!GetFileSizeEx(file, &large_file_size) || (uint64_t) large_file_size.QuadPart < NNP_KERNEL_FILE_PAYLOAD_OFFSET)
+	{
+		CloseHandle(file);
+		return nnp_status_invalid_kernel_file;
+	}
+	file_size = (uint64_t) large_file_size.QuadPart;
+
+	/* The view keeps the mapping object alive; both handles can be closed right away */
+	HANDLE file_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (file_mapping == NULL)
+		return nnp_status_io_error;
+
+	mapping = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(file_mapping);
+	if (mapping == NULL)
+		return nnp_status_io_error;
+#else
+	const int file = open(path, O_RDONLY);
+	if (file == -1)
+		return nnp_status_io_error;
+
+	struct stat file_stat;
+	if (fstat(file, &file_stat) != 0 || (uint64_t) file_stat.st_size < NNP_KERNEL_FILE_PAYLOAD_OFFSET)
+	{
+		close(file);
+		return nnp_status_invalid_kernel_file;
+	}
+	file_size = (uint64_t) file_stat.st_size;
+
+	void* file_mapping = mmap(NULL, get_mapping_size(file_size - NNP_KERNEL_FILE_PAYLOAD_OFFSET), PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (file_mapping == MAP_FAILED)
+		return nnp_status_io_error;
+	mapping = file_mapping;
+#endif
+
+	status = validate_header((const struct kernel_file_header*) mapping, &expected_header, file_size);
+	if (status != nnp_status_success)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(mapping);
+#else
+		munmap((void*) mapping, get_mapping_size(file_size - NNP_KERNEL_FILE_PAYLOAD_OFFSET));
+#endif
+		return status;
+	}
+
+	*transformed_kernel = (const uint8_t*) mapping + NNP_KERNEL_FILE_PAYLOAD_OFFSET;
+	*transformed_kernel_size = (size_t) expected_header.payload_size;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_convolution_inference_unload_kernel(
+	const void* transformed_kernel,
+	const size_t transformed_kernel_size)
+{
+	if (transformed_kernel == NULL)
+		return nnp_status_success;
+
+	const uint8_t* mapping = (const uint8_t*) transformed_kernel - NNP_KERNEL_FILE_PAYLOAD_OFFSET;
+#if defined(_WIN32)
+	if (!UnmapViewOfFile(mapping))
+		return nnp_status_io_error;
+#else
+	if (munmap((void*) mapping, get_mapping_size(transformed_kernel_size)) != 0)
+		return nnp_status_io_error;
+#endif
+	return nnp_status_success;
+}
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include <nnpack.h>
 #include <nnpack/macros.h>
 #include <nnpack/utils.h>
@@ -99,6 +101,36 @@ static void compute_grad_output_transform(
 	}
 }
 
+struct NNP_CACHE_ALIGN grad_bias_context
+{
+	const size_t tuple_elements;
+	const size_t batch_block_size;
+	const float* grad_output_transform;
+	float* grad_bias;
+};
+
+static void compute_grad_bias(
+	const struct grad_bias_context* context,
+	const size_t output_channels_subblock_start,
+	const size_t output_channels_subblock_size)
+{
+	const size_t tuple_elements                  = context->tuple_elements;
+	const size_t batch_block_size                = context->batch_block_size;
+	const float* grad_output_transform           = context->grad_output_transform;
+	float* grad_bias                             = context->grad_bias;
+
+	/* The first element of the first tuple is the DC component of the tile transform, i.e. the sum over the tile */
+	for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++) 
+	{
+		float sum = 0.0f;
+		for (size_t batch_block_offset = 0; batch_block_offset < batch_block_size; batch_block_offset++) 
+		{
+			sum += grad_output_transform[(output_channels_subblock_start * batch_block_size + batch_block_offset * output_channels_subblock_size + output_channels_subblock_offset) * tuple_elements];
+		}
+		grad_bias[output_channels_subblock_start + output_channels_subblock_offset] += sum;
+	}
+}
+
 struct NNP_CACHE_ALIGN grad_kernel_transform_context
 {
 	const size_t tuple_elements;
@@ -108,6 +140,7 @@ struct NNP_CACHE_ALIGN grad_kernel_transform_context
 	const struct nnp_size kernel_size;
 	const float* grad_kernel_transform;
 	float* grad_kernel;
+	const bool accumulate;
 	const nnp_transform_2d_with_offset transform_function;
 };
 
@@ -125,6 +158,7 @@ static void compute_grad_kernel_transform(
 	const struct nnp_size kernel_size            = context->kernel_size;
 	const float* grad_kernel_transform           = context->grad_kernel_transform;
 	float* grad_kernel                           = context->grad_kernel;
+	const bool accumulate                        = context->accumulate;
 	const nnp_transform_2d_with_offset transform = context->transform_function;
 
 	const size_t output_channels_block_start  = round_down(output_channel, output_channels_block_max);
@@ -132,16 +166,24 @@ static void compute_grad_kernel_transform(
 	const size_t output_channels_block_offset = output_channel - output_channels_block_start;
 	const size_t kernel_elements = kernel_size.height * kernel_size.width;
 
+	/* In accumulation mode, each kernel is inverse-transformed into a stack block and added to grad_kernel while it is hot */
+	float block[16 * 16];
 	for (size_t input_channels_subblock_offset = 0; input_channels_subblock_offset < input_channels_subblock_size; input_channels_subblock_offset++) 
 	{
 		const size_t input_channel = input_channels_subblock_start + input_channels_subblock_offset;
+		float* grad_kernel_channel = grad_kernel + (output_channel * input_channels + input_channel) * kernel_elements;
 		transform(
 			grad_kernel_transform +	(output_channels_block_start * input_channels + input_channels_subblock_start * output_channels_block_size + output_channels_block_offset * input_channels_subblock_size + input_channels_subblock_offset) * tuple_elements,
-			grad_kernel + (output_channel * input_channels + input_channel) * kernel_elements,
+			accumulate ? block : grad_kernel_channel,
 			output_channels * input_channels * tuple_elements * sizeof(float),
 			kernel_size.width,
 			kernel_size.height,	kernel_size.width,
 			0, 0);
+		if (accumulate)
+		{
+			for (size_t i = 0; i < kernel_elements; i++)
+				grad_kernel_channel[i] += block[i];
+		}
 	}
 }
 
@@ -239,6 +281,9 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 	const float* input,
 	const float* grad_output,
 	float* grad_kernel,
+	float* grad_bias,
+	const bool accumulate,
+	const bool reuse_input_transform,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const nnp_transform_2d_with_offset input_transform_function,
@@ -279,8 +324,8 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 	const size_t input_channels_block_max  = round_down(cache_elements_l3 / batch_block_max, input_channels_subblock_max);
 	const size_t output_channels_block_max = round_down(cache_elements_l2 / batch_block_max, output_channels_subblock_max);
 
-	/* Calculate memory footprint and allocate memory */
-	const size_t input_transform_size       = min(batch_size, batch_block_max) * input_channels * tile_elements * sizeof(float);
+	/* Calculate memory footprint and allocate memory. Reused input transform is read in place. */
+	const size_t input_transform_size       = reuse_input_transform ? 0 : min(batch_size, batch_block_max) * input_channels * tile_elements * sizeof(float);
 	const size_t grad_kernel_transform_size = output_channels * input_channels * tile_elements * sizeof(float);
 	const size_t grad_output_transform_size = min(batch_size, batch_block_max) * output_channels * tile_elements * sizeof(float);
 	const size_t memory_size = input_transform_size + grad_output_transform_size + grad_kernel_transform_size;
@@ -310,8 +355,12 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 
 	float* input_transform = (float*)memory_block;
 	float* grad_output_transform = (float*)((char*)memory_block + input_transform_size);
+	const float* saved_input_transform = input;
 	float* grad_kernel_transform = (float*)((char*)memory_block + input_transform_size + grad_output_transform_size);
 
+	if (grad_bias != NULL && !accumulate)
+		memset(grad_bias, 0, output_channels * sizeof(float));
+
 #ifdef _WIN64
 	nnp_fast_tuple_gemm_function fast_gemm_a = bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.cX_conjb_transc_only_mr_x_nr : nnp_hwinfo.cxgemm.cX_conjb_transc_only_mr_x_nr;
 	nnp_full_tuple_gemm_function full_gemm_a = bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.cX_conjb_transc_upto_mr_x_nr : nnp_hwinfo.cxgemm.cX_conjb_transc_upto_mr_x_nr;
@@ -333,28 +382,36 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 			{
 				const size_t batch_block_size = min(batch_size - batch_block_start, batch_block_max);
 
-				/* Input transform */
+				/* Input transform, or the one saved by nnp_convolution_output in the same layout */
 				NNP_INPUT_TRANSFORM_START(profile)
-				struct input_transform_context input_transform_context = 
+				if (reuse_input_transform)
 				{
-					.tuple_elements = tuple_elements,
-					.input_elements = input_size.height * input_size.width,
-					.batch_block_size = batch_block_size,
-					.input_channels = input_channels,
-					.input_stride = input_size.width,
-					.row_offset = row_offset,
-					.column_offset = column_offset,
-					.row_count = min(input_size.height - input_y, tile_size.height - row_offset),
-					.column_count = min(input_size.width - input_x, tile_size.width - column_offset),
-					.input = input + (batch_block_start * input_channels * input_size.height + input_y) * input_size.width + input_x,
-					.input_transform = input_transform,
-					.transform_function = input_transform_function
-				};
-				pthreadpool_compute_2d_tiled(
-					(pthreadpool_function_2d_tiled_t)compute_input_transform,
-					&input_transform_context,
-					batch_block_size, input_channels,
-					1, input_channels_subblock_max);
+					input_transform = (float*)saved_input_transform;
+					saved_input_transform += batch_block_size * input_channels * tile_elements;
+				}
+				else
+				{
+					struct input_transform_context input_transform_context = 
+					{
+						.tuple_elements = tuple_elements,
+						.input_elements = input_size.height * input_size.width,
+						.batch_block_size = batch_block_size,
+						.input_channels = input_channels,
+						.input_stride = input_size.width,
+						.row_offset = row_offset,
+						.column_offset = column_offset,
+						.row_count = min(input_size.height - input_y, tile_size.height - row_offset),
+						.column_count = min(input_size.width - input_x, tile_size.width - column_offset),
+						.input = input + (batch_block_start * input_channels * input_size.height + input_y) * input_size.width + input_x,
+						.input_transform = input_transform,
+						.transform_function = input_transform_function
+					};
+					pthreadpool_compute_2d_tiled(
+						(pthreadpool_function_2d_tiled_t)compute_input_transform,
+						&input_transform_context,
+						batch_block_size, input_channels,
+						1, input_channels_subblock_max);
+				}
 				NNP_INPUT_TRANSFORM_END(profile)
 
 				/* Grad output transform */
@@ -377,6 +434,23 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 					&grad_output_transform_context,
 					batch_block_size, output_channels,
 					1, output_channels_subblock_max);
+
+				/* Grad bias from DC components of grad output transform */
+				if (grad_bias != NULL) 
+				{
+					struct grad_bias_context grad_bias_context = 
+					{
+						.tuple_elements = tuple_elements,
+						.batch_block_size = batch_block_size,
+						.grad_output_transform = grad_output_transform,
+						.grad_bias = grad_bias
+					};
+					pthreadpool_compute_1d_tiled(
+						(pthreadpool_function_1d_tiled_t)compute_grad_bias,
+						&grad_bias_context,
+						output_channels,
+						output_channels_subblock_max);
+				}
 				NNP_OUTPUT_TRANSFORM_END(profile)
 
 				NNP_BLOCK_MULTIPLICATION_START(profile)
@@ -442,6 +516,7 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 		.kernel_size = kernel_size,
 		.grad_kernel_transform = grad_kernel_transform,
 		.grad_kernel = grad_kernel,
+		.accumulate = accumulate,
 		.transform_function = grad_kernel_transform_function
 	};
 	pthreadpool_compute_2d_tiled(
@@ -457,17 +532,430 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 	return nnp_status_success;
 }
 
+struct NNP_CACHE_ALIGN grad_output_upsampling_context
+{
+	const struct nnp_size output_size;
+	const struct nnp_size output_subsampling;
+	const struct nnp_size upsampled_output_size;
+	const float* grad_output;
+	float* upsampled_grad_output;
+};
+
+static void compute_grad_output_upsampling(
+	const struct grad_output_upsampling_context* context,
+	const size_t channel)
+{
+	const struct nnp_size output_size           = context->output_size;
+	const struct nnp_size output_subsampling    = context->output_subsampling;
+	const struct nnp_size upsampled_output_size = context->upsampled_output_size;
+	const float* grad_output                    = context->grad_output + channel * output_size.height * output_size.width;
+	float* upsampled_grad_output                = context->upsampled_grad_output + channel * upsampled_output_size.height * upsampled_output_size.width;
+
+	memset(upsampled_grad_output, 0, upsampled_output_size.height * upsampled_output_size.width * sizeof(float));
+	for (size_t y = 0; y < output_size.height; y++)
+	{
+		float* upsampled_row = upsampled_grad_output + y * output_subsampling.height * upsampled_output_size.width;
+		for (size_t x = 0; x < output_size.width; x++)
+			upsampled_row[x * output_subsampling.width] = grad_output[y * output_size.width + x];
+	}
+}
+
+/*
+ * Strided convolution is the unit-stride convolution sampled at every output_subsampling-th position, so its kernel
+ * gradient is the unit-stride kernel gradient for grad_output with zeros inserted between the sampled positions.
+ */
+static enum nnp_status compute_strided_convolution_kernel_gradient(
+	const enum nnp_convolution_algorithm algorithm,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size output_size,
+	const float* input,
+	const float* grad_output,
+	float* grad_kernel,
+	float* grad_bias,
+	const bool accumulate,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	struct nnp_profile* profile)
+{
+	const struct nnp_size unit_subsampling = { .width = 1, .height = 1 };
+	const struct nnp_size upsampled_output_size =
+	{
+		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
+		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+	};
+
+	size_t kernel_gradient_workspace_size = 0;
+	enum nnp_status status = nnp_convolution_kernel_gradient(
+		algorithm, nnp_convolution_transform_strategy_compute, batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, unit_subsampling,
+		NULL, NULL, NULL, NULL, accumulate, NULL, &kernel_gradient_workspace_size,
+		nnp_activation_identity, NULL, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	const size_t upsampled_grad_output_size = round_up(batch_size * output_channels * upsampled_output_size.height * upsampled_output_size.width * sizeof(float), 64);
+	const size_t memory_size = upsampled_grad_output_size + kernel_gradient_workspace_size;
+	void* memory_block = NULL;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	float* upsampled_grad_output = (float*)memory_block;
+	void* kernel_gradient_workspace = (kernel_gradient_workspace_size == 0 ? NULL : (char*)memory_block + upsampled_grad_output_size);
+
+	struct grad_output_upsampling_context grad_output_upsampling_context =
+	{
+		.output_size = output_size,
+		.output_subsampling = output_subsampling,
+		.upsampled_output_size = upsampled_output_size,
+		.grad_output = grad_output,
+		.upsampled_grad_output = upsampled_grad_output
+	};
+	pthreadpool_compute_1d(
+		(pthreadpool_function_1d_t)compute_grad_output_upsampling,
+		&grad_output_upsampling_context,
+		batch_size * output_channels);
+
+	status = nnp_convolution_kernel_gradient(
+		algorithm, nnp_convolution_transform_strategy_compute, batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, unit_subsampling,
+		input, upsampled_grad_output, grad_kernel, grad_bias, accumulate,
+		kernel_gradient_workspace, kernel_gradient_workspace == NULL ? NULL : &kernel_gradient_workspace_size,
+		nnp_activation_identity, NULL, profile);
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return status;
+}
+
+struct NNP_CACHE_ALIGN grad_output_packing_context
+{
+	size_t output_elements;
+	size_t pixels_start;
+	size_t pixels_count;
+	const float* grad_output;
+	float* packed_grad_output;
+};
+
+/* Packs a subblock of grad_output rows, interleaved by pixel, as the left operand of sgemm */
+static void compute_grad_output_packing(
+	const struct grad_output_packing_context context[restrict static 1],
+	size_t output_channels_subblock_start,
+	size_t output_channels_subblock_size)
+{
+	const size_t output_elements = context->output_elements;
+	const size_t pixels_count = context->pixels_count;
+	const float* grad_output = context->grad_output + output_channels_subblock_start * output_elements + context->pixels_start;
+	float* packed_grad_output = context->packed_grad_output + output_channels_subblock_start * pixels_count;
+
+	for (size_t pixel = 0; pixel < pixels_count; pixel++)
+	{
+		for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++)
+			*packed_grad_output++ = grad_output[output_channels_subblock_offset * output_elements + pixel];
+	}
+}
+
+struct NNP_CACHE_ALIGN input_packing_context
+{
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_subsampling;
+	struct nnp_size output_size;
+	size_t pixels_start;
+	size_t pixels_count;
+	size_t simd_width;
+	const float* input;
+	float* packed_input;
+};
+
+/*
+ * Unfolds a subblock of input rows (one per input channel and kernel pixel) straight into the right operand of sgemm,
+ * interleaved by pixel, so the unfolded input is never materialized as a separate matrix.
+ */
+static void compute_input_packing(
+	const struct input_packing_context context[restrict static 1],
+	size_t rows_subblock_start,
+	size_t rows_subblock_size)
+{
+	const struct nnp_size input_size = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size kernel_size = context->kernel_size;
+	const struct nnp_size output_subsampling = context->output_subsampling;
+	const struct nnp_size output_size = context->output_size;
+	const size_t pixels_start = context->pixels_start;
+	const size_t pixels_count = context->pixels_count;
+	const size_t rows_subblock_stride = round_up(rows_subblock_size, context->simd_width);
+	float* packed_input = context->packed_input + rows_subblock_start * pixels_count;
+
+	for (size_t rows_subblock_offset = 0; rows_subblock_offset < rows_subblock_size; rows_subblock_offset++)
+	{
+		const size_t row = rows_subblock_start + rows_subblock_offset;
+		const size_t input_channel = row / (kernel_size.height * kernel_size.width);
+		const size_t kernel_y = row / kernel_size.width % kernel_size.height;
+		const size_t kernel_x = row % kernel_size.width;
+		const float* input = context->input + input_channel * input_size.height * input_size.width;
+
+		size_t y = pixels_start / output_size.width;
+		size_t x = pixels_start % output_size.width;
+		for (size_t pixel = 0; pixel < pixels_count; pixel++)
+		{
+			/* Unsigned wrap-around makes padding rows and columns compare above the input size */
+			const size_t input_y = y * output_subsampling.height + kernel_y - input_padding.top;
+			const size_t input_x = x * output_subsampling.width + kernel_x - input_padding.left;
+			packed_input[pixel * rows_subblock_stride + rows_subblock_offset] =
+				(input_y < input_size.height && input_x < input_size.width) ? input[input_y * input_size.width + input_x] : 0.0f;
+
+			if (++x == output_size.width)
+			{
+				x = 0;
+				y++;
+			}
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN unfolded_multiplication_context
+{
+	const float* packed_grad_output;
+	const float* packed_input;
+	float* grad_kernel;
+	size_t unfolded_rows;
+	size_t pixels_count;
+	size_t update;
+	size_t output_channels_subblock_max;
+	size_t rows_subblock_max;
+	nnp_fast_sgemm_function fast_sgemm_function;
+	nnp_full_sgemm_function full_sgemm_function;
+};
+
+static void compute_unfolded_multiplication(
+	const struct unfolded_multiplication_context context[restrict static 1],
+	size_t output_channels_subblock_start,
+	size_t rows_block_start,
+	size_t output_channels_subblock_size,
+	size_t rows_block_size)
+{
+	const size_t unfolded_rows = context->unfolded_rows;
+	const size_t pixels_count = context->pixels_count;
+	const size_t update = context->update;
+	const size_t rows_subblock_max = context->rows_subblock_max;
+	const float* packed_grad_output = context->packed_grad_output + output_channels_subblock_start * pixels_count;
+
+	for (size_t rows_subblock_start = 0; rows_subblock_start < rows_block_size; rows_subblock_start += rows_subblock_max)
+	{
+		const size_t rows_subblock_size = min(rows_block_size - rows_subblock_start, rows_subblock_max);
+		const size_t row = rows_block_start + rows_subblock_start;
+		const float* packed_input = context->packed_input + row * pixels_count;
+		float* grad_kernel = context->grad_kernel + output_channels_subblock_start * unfolded_rows + row;
+		if (output_channels_subblock_size == context->output_channels_subblock_max && rows_subblock_size == rows_subblock_max)
+		{
+			context->fast_sgemm_function(
+				pixels_count, update,
+				packed_grad_output, packed_input, grad_kernel, unfolded_rows);
+		}
+		else
+		{
+			context->full_sgemm_function(
+				output_channels_subblock_size, rows_subblock_size,
+				pixels_count, update,
+				packed_grad_output, packed_input, grad_kernel, unfolded_rows);
+		}
+	}
+}
+
+/*
+ * Kernel gradient is a GEMM of grad_output [output_channels x output_pixels] with the transposed unfolded input
+ * [input_channels * kernel_pixels x output_pixels], where the reduction runs over the pixels of all images in the batch.
+ * The reduction is split into blocks of pixels sized for L1, and both operands of a block are packed directly from
+ * grad_output and input, with the unfolding done by the packing. sgemm accumulates every block after the first into
+ * grad_kernel, so the workspace holds only the packed operands of one block. Subsampling is handled by the unfolding.
+ */
+static enum nnp_status compute_gemm_convolution_kernel_gradient(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size output_size,
+	const float* input,
+	const float* grad_output,
+	float* grad_kernel,
+	float* grad_bias,
+	const bool accumulate,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	struct nnp_profile* profile)
+{
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const size_t output_elements = output_size.height * output_size.width;
+	const size_t input_elements = input_size.height * input_size.width;
+	const size_t unfolded_rows = input_channels * kernel_elements;
+
+	const size_t output_channels_subblock_max = nnp_hwinfo.sgemm.mr;
+	const size_t rows_subblock_max = nnp_hwinfo.sgemm.nr;
+	/* A row panel of each packed operand fits in L1, and a block of the packed unfolded input fits in L2 */
+	const size_t pixels_block_max = min(max(nnp_hwinfo.blocking.l1 / ((output_channels_subblock_max + rows_subblock_max) * sizeof(float)), 1), output_elements);
+	const size_t rows_block_max = max(round_down(nnp_hwinfo.blocking.l2 / (pixels_block_max * sizeof(float)), rows_subblock_max), rows_subblock_max);
+
+	const size_t packed_grad_output_size = round_up(round_up(output_channels, output_channels_subblock_max) * pixels_block_max * sizeof(float), 64);
+	const size_t packed_input_size = round_up(round_up(unfolded_rows, rows_subblock_max) * pixels_block_max * sizeof(float), 64);
+	const size_t memory_size = packed_grad_output_size + packed_input_size;
+	void* memory_block = NULL;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL)
+				return nnp_status_out_of_memory;
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	float* packed_grad_output = (float*)memory_block;
+	float* packed_input = (float*)((char*)memory_block + packed_grad_output_size);
+
+	if (grad_bias != NULL && !accumulate)
+		memset(grad_bias, 0, output_channels * sizeof(float));
+
+	struct unfolded_multiplication_context unfolded_multiplication_context =
+	{
+		.packed_grad_output = packed_grad_output,
+		.packed_input = packed_input,
+		.grad_kernel = grad_kernel,
+		.unfolded_rows = unfolded_rows,
+		.output_channels_subblock_max = output_channels_subblock_max,
+		.rows_subblock_max = rows_subblock_max,
+		.fast_sgemm_function = nnp_hwinfo.sgemm.only_mr_x_nr,
+		.full_sgemm_function = nnp_hwinfo.sgemm.upto_mr_x_nr,
+	};
+	for (size_t sample = 0; sample < batch_size; sample++)
+	{
+		const float* input_sample = input + sample * input_channels * input_elements;
+		const float* grad_output_sample = grad_output + sample * output_channels * output_elements;
+
+		for (size_t pixels_start = 0; pixels_start < output_elements; pixels_start += pixels_block_max)
+		{
+			const size_t pixels_count = min(output_elements - pixels_start, pixels_block_max);
+
+			NNP_INPUT_TRANSFORM_START(profile)
+			struct grad_output_packing_context grad_output_packing_context =
+			{
+				.output_elements = output_elements,
+				.pixels_start = pixels_start,
+				.pixels_count = pixels_count,
+				.grad_output = grad_output_sample,
+				.packed_grad_output = packed_grad_output,
+			};
+			pthreadpool_compute_1d_tiled(
+				(pthreadpool_function_1d_tiled_t)compute_grad_output_packing,
+				&grad_output_packing_context,
+				output_channels, output_channels_subblock_max);
+
+			struct input_packing_context input_packing_context =
+			{
+				.input_size = input_size,
+				.input_padding = input_padding,
+				.kernel_size = kernel_size,
+				.output_subsampling = output_subsampling,
+				.output_size = output_size,
+				.pixels_start = pixels_start,
+				.pixels_count = pixels_count,
+				.simd_width = nnp_hwinfo.simd_width,
+				.input = input_sample,
+				.packed_input = packed_input,
+			};
+			pthreadpool_compute_1d_tiled(
+				(pthreadpool_function_1d_tiled_t)compute_input_packing,
+				&input_packing_context,
+				unfolded_rows, rows_subblock_max);
+			NNP_INPUT_TRANSFORM_END(profile)
+
+			/* The first block of the first image overwrites grad_kernel unless the caller asked to accumulate into it */
+			NNP_BLOCK_MULTIPLICATION_START(profile)
+			unfolded_multiplication_context.pixels_count = pixels_count;
+			unfolded_multiplication_context.update = accumulate || sample != 0 || pixels_start != 0;
+			pthreadpool_compute_2d_tiled(
+				(pthreadpool_function_2d_tiled_t)compute_unfolded_multiplication,
+				&unfolded_multiplication_context,
+				output_channels, unfolded_rows,
+				output_channels_subblock_max, rows_block_max);
+			NNP_BLOCK_MULTIPLICATION_END(profile)
+		}
+
+		if (grad_bias != NULL)
+		{
+			for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+			{
+				const float* grad_output_channel = grad_output_sample + output_channel * output_elements;
+				float sum = 0.0f;
+				for (size_t index = 0; index < output_elements; index++)
+					sum += grad_output_channel[index];
+				grad_bias[output_channel] += sum;
+			}
+		}
+	}
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return nnp_status_success;
+}
+
 enum nnp_status nnp_convolution_kernel_gradient(
 	enum nnp_convolution_algorithm algorithm,
+	const enum nnp_convolution_transform_strategy input_transform_strategy,
 	const size_t batch_size,
 	const size_t input_channels,
 	const size_t output_channels,
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* grad_output,
 	float* grad_kernel,
+	float* grad_bias,
+	const bool accumulate,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
@@ -478,12 +966,12 @@ enum nnp_status nnp_convolution_kernel_gradient(
 
 	const struct nnp_size output_size = 
 	{
-		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
-		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
 	};
 
 	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels,	input_size, input_padding, kernel_size, (struct nnp_size) { .width = 1, .height = 1 }, activation, activation_parameters);
+	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels,	input_size, input_padding, kernel_size, output_subsampling, activation, activation_parameters);
 	if (status != nnp_status_success)
 		goto cleanup;
 	
@@ -499,10 +987,38 @@ enum nnp_status nnp_convolution_kernel_gradient(
 		goto cleanup;
 	}
 
+	/* With the reuse strategy, input is the transform saved by nnp_convolution_output */
+	bool reuse_input_transform = false;
+	switch (input_transform_strategy)
+	{
+		case nnp_convolution_transform_strategy_compute:
+			break;
+		case nnp_convolution_transform_strategy_reuse:
+			if (output_subsampling.height != 1 || output_subsampling.width != 1)
+			{
+				status = nnp_status_unsupported_transform_strategy;
+				goto cleanup;
+			}
+			reuse_input_transform = true;
+			break;
+		case nnp_convolution_transform_strategy_precompute:
+			/* Input transform is saved by nnp_convolution_output */
+			status = nnp_status_unsupported_transform_strategy;
+			goto cleanup;
+		default:
+			status = nnp_status_invalid_transform_strategy;
+			goto cleanup;
+	}
+
 	/* If requested, choose optimal convolution algorithm */
 	if (algorithm == nnp_convolution_algorithm_auto) 
 	{
-		if (max(kernel_size.width, kernel_size.height) > 8ull) 
+		if (kernel_size.height == 1 && kernel_size.width == 1 && !reuse_input_transform)
+			/* 1x1 convolution is a plain GEMM */
+			algorithm = nnp_convolution_algorithm_direct;
+		else if (output_subsampling.height != 1 || output_subsampling.width != 1)
+			algorithm = nnp_convolution_algorithm_implicit_gemm;
+		else if (max(kernel_size.width, kernel_size.height) > 8ull) 
 			algorithm = nnp_convolution_algorithm_ft16x16;
 		else 
 		{
@@ -519,15 +1035,32 @@ enum nnp_status nnp_convolution_kernel_gradient(
 		}
 	}
 
+	if (reuse_input_transform && algorithm != nnp_convolution_algorithm_ft8x8 && algorithm != nnp_convolution_algorithm_ft16x16)
+	{
+		status = nnp_status_unsupported_transform_strategy;
+		goto cleanup;
+	}
+
+	/* GEMM-based algorithms handle subsampling natively, transform-based ones work on zero-stuffed grad_output */
+	if ((output_subsampling.height != 1 || output_subsampling.width != 1) &&
+		algorithm != nnp_convolution_algorithm_direct && algorithm != nnp_convolution_algorithm_implicit_gemm)
+	{
+		status = compute_strided_convolution_kernel_gradient(
+			algorithm, batch_size, input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling, output_size,
+			input, grad_output, grad_kernel, grad_bias, accumulate, workspace_buffer, workspace_size, profile);
+		goto cleanup;
+	}
+
 	/* Choose tiling parameters and transform functions depending on convolution algorithm */
 	switch (algorithm) 
 	{
 		case nnp_convolution_algorithm_ft8x8:
-			status = compute_fast_convolution_kernel_gradient(batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, input, grad_output, grad_kernel, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.ifft8x8_with_offset, profile);
+			status = compute_fast_convolution_kernel_gradient(batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, input, grad_output, grad_kernel, grad_bias, accumulate, reuse_input_transform, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.ifft8x8_with_offset, profile);
 			break;
 
 		case nnp_convolution_algorithm_ft16x16:
-			status = compute_fast_convolution_kernel_gradient(batch_size, input_channels, output_channels, (struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size, input, grad_output, grad_kernel, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.ifft16x16_with_offset, profile);
+			status = compute_fast_convolution_kernel_gradient(batch_size, input_channels, output_channels, (struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size, input, grad_output, grad_kernel, grad_bias, accumulate, reuse_input_transform, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.ifft16x16_with_offset, profile);
 			break;
 
 		case nnp_convolution_algorithm_wt8x8:
@@ -537,6 +1070,24 @@ enum nnp_status nnp_convolution_kernel_gradient(
 			 */
 			status = nnp_status_unsupported_algorithm;
 			break;
+
+		case nnp_convolution_algorithm_ft32x32:
+			/* 32x32 Fourier transforms are implemented only for the forward pass */
+			status = nnp_status_unsupported_algorithm;
+			break;
+
+		case nnp_convolution_algorithm_direct:
+			if (kernel_size.height != 1 || kernel_size.width != 1)
+			{
+				status = nnp_status_unsupported_algorithm;
+				goto cleanup;
+			}
+			status = compute_gemm_convolution_kernel_gradient(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, output_size, input, grad_output, grad_kernel, grad_bias, accumulate, workspace_buffer, workspace_size, profile);
+			break;
+
+		case nnp_convolution_algorithm_implicit_gemm:
+			status = compute_gemm_convolution_kernel_gradient(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, output_size, input, grad_output, grad_kernel, grad_bias, accumulate, workspace_buffer, workspace_size, profile);
+			break;
 			
 		default:
 			status = nnp_status_invalid_algorithm;
@@ -1,9 +1,12 @@
+#include <string.h>
+
 #include <nnpack.h>
 #include <nnpack/utils.h>
 #include <nnpack/hwinfo.h>
 #include <nnpack/system.h>
 #include <nnpack/validation.h>
 #include <nnpack/macros.h>
+#include <nnpack/activations.h>
 
 
 struct NNP_CACHE_ALIGN kernel_transform_context
@@ -106,12 +109,73 @@ static void compute_input_transform(
 	}
 }
 
+/*
+ * Copies the input transform of one tile position into the layout compute_fast_convolution_kernel_gradient uses for
+ * its input transform: batch blocks of saved_batch_block_max images, each with input channel subblocks of
+ * saved_input_channels_subblock_max.
+ */
+struct NNP_CACHE_ALIGN input_transform_packing_context
+{
+	const float* input_transform;
+	float* saved_input_transform;
+
+	const size_t tuple_elements;
+	const size_t tuple_count;
+	const size_t batch_size;
+	const size_t input_channels;
+	const size_t input_channels_block_max;
+	const size_t batch_subblock_max;
+	const size_t saved_batch_block_max;
+	const size_t saved_input_channels_subblock_max;
+};
+
+static void compute_input_transform_packing(
+	const struct input_transform_packing_context* context,
+	const size_t sample,
+	const size_t input_channel)
+{
+	const float* input_transform                   = context->input_transform;
+	float* saved_input_transform                   = context->saved_input_transform;
+	const size_t tuple_elements                    = context->tuple_elements;
+	const size_t tuple_count                       = context->tuple_count;
+	const size_t batch_size                        = context->batch_size;
+	const size_t input_channels                    = context->input_channels;
+	const size_t input_channels_block_max          = context->input_channels_block_max;
+	const size_t batch_subblock_max                = context->batch_subblock_max;
+	const size_t saved_batch_block_max             = context->saved_batch_block_max;
+	const size_t saved_input_channels_subblock_max = context->saved_input_channels_subblock_max;
+
+	const size_t input_channels_block_start    = round_down(input_channel, input_channels_block_max);
+	const size_t input_channels_block_size     = min(input_channels - input_channels_block_start, input_channels_block_max);
+	const size_t batch_subblock_start          = round_down(sample, batch_subblock_max);
+	const size_t batch_subblock_size           = min(batch_size - batch_subblock_start, batch_subblock_max);
+	const float* input_tuple = input_transform +
+		(input_channels_block_start * batch_size + batch_subblock_start * input_channels_block_size +
+		(input_channel - input_channels_block_start) * batch_subblock_size + (sample - batch_subblock_start)) * tuple_elements;
+
+	const size_t saved_batch_block_start       = round_down(sample, saved_batch_block_max);
+	const size_t saved_batch_block_size        = min(batch_size - saved_batch_block_start, saved_batch_block_max);
+	const size_t input_channels_subblock_start = round_down(input_channel, saved_input_channels_subblock_max);
+	const size_t input_channels_subblock_size  = min(input_channels - input_channels_subblock_start, saved_input_channels_subblock_max);
+	float* saved_tuple = saved_input_transform + saved_batch_block_start * input_channels * tuple_count * tuple_elements +
+		(input_channels_subblock_start * saved_batch_block_size + (sample - saved_batch_block_start) * input_channels_subblock_size +
+		(input_channel - input_channels_subblock_start)) * tuple_elements;
+
+	for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index++)
+	{
+		memcpy(saved_tuple, input_tuple, tuple_elements * sizeof(float));
+		input_tuple += tuple_elements * batch_size * input_channels;
+		saved_tuple += tuple_elements * saved_batch_block_size * input_channels;
+	}
+}
+
 struct NNP_CACHE_ALIGN output_transform_context
 {
 	const nnp_transform_2d_with_bias transform_function;
 	float* output;
 	const float* output_transform;
 	const float* bias;
+	const float* residual;
 	const size_t tuple_elements;
 	const size_t output_channels;
 	const size_t batch_size;
@@ -121,6 +185,7 @@ struct NNP_CACHE_ALIGN output_transform_context
 	const size_t row_count;
 	const size_t column_offset;
 	const size_t column_count;
+	const enum nnp_activation activation;
 };
 
 static void compute_output_transform(
@@ -134,6 +199,7 @@ static void compute_output_transform(
 	float* output                                       = context->output;
 	const float* output_transform                       = context->output_transform;
 	const float* bias                                   = context->bias;
+	const float* residual                               = context->residual;
 	const size_t tuple_elements                         = context->tuple_elements;
 	const size_t batch_size                             = context->batch_size;
 	const size_t output_channels                        = context->output_channels;
@@ -143,6 +209,7 @@ static void compute_output_transform(
 	const size_t row_count                              = context->row_count;
 	const size_t column_offset                          = context->column_offset;
 	const size_t column_count                           = context->column_count;
+	const enum nnp_activation activation                = context->activation;
 
 	const size_t batch_block_start	= round_down(sample, batch_block_max);
 	const size_t batch_block_size	= min(batch_size - batch_block_start, batch_block_max);
@@ -151,13 +218,17 @@ static void compute_output_transform(
 	for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset++) 
 	{
 		const size_t output_channel = output_channels_subblock_start + output_channels_subblock_offset;
+		const size_t output_offset = ((sample * output_channels) + output_channel) * output_size.width * output_size.height;
 		transform_function(
 			output_transform + (batch_block_start * output_channels + output_channels_subblock_start * batch_block_size + batch_block_offset * output_channels_subblock_size + output_channels_subblock_offset) * tuple_elements,
-			output + ((sample * output_channels) + output_channel) * output_size.width * output_size.height,
+			output + output_offset,
 			bias + output_channel,
 			batch_size * output_channels * tuple_elements * sizeof(float),
 			output_size.width,
 			row_count, column_count);
+
+		if (residual != NULL)
+			add_residual_with_activation(output + output_offset, output_size.width, residual + output_offset, output_size.width, 0.0f, row_count, column_count, activation);
 	}
 }
 
@@ -251,12 +322,16 @@ static enum nnp_status compute_fast_convolution_output(
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
+	float* saved_input_transform,
 	void* workspace_buffer,
 	size_t* workspace_size,
+	const struct cache_blocking_info* blocking,
 	const nnp_transform_2d_with_offset input_transform_function,
 	const nnp_transform_2d_with_offset kernel_transform_function,
 	const nnp_transform_2d_with_bias output_transform_function,
+	const enum nnp_activation activation,
 	struct nnp_profile* profile)
 {
 	void* memory_block = NULL;
@@ -278,9 +353,9 @@ static enum nnp_status compute_fast_convolution_output(
 	};
 
 	/* Calculate cache blocking parameters */
-	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / (tuple_elements * sizeof(float));
-	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / (tuple_elements * sizeof(float));
-	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / (tuple_elements * sizeof(float));
+	const size_t cache_elements_l1 = blocking->l1 / (tuple_elements * sizeof(float));
+	const size_t cache_elements_l2 = blocking->l2 / (tuple_elements * sizeof(float));
+	const size_t cache_elements_l3 = blocking->l3 / (tuple_elements * sizeof(float));
 
 #ifdef _WIN64
 	const size_t batch_subblock_max = fourier_transform ? (bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.mr : nnp_hwinfo.cxgemm.mr) : nnp_hwinfo.sxgemm.mr;
@@ -294,6 +369,15 @@ static enum nnp_status compute_fast_convolution_output(
 	const size_t batch_block_max           = round_down(cache_elements_l3 / input_channels_block_max, batch_subblock_max);
 	const size_t output_channels_block_max = round_down(cache_elements_l2 / input_channels_block_max, output_channels_subblock_max);
 
+	/* Blocking of the saved input transform must match compute_fast_convolution_kernel_gradient (saving uses nnp_hwinfo.blocking) */
+#ifdef _WIN64
+	const size_t saved_input_channels_subblock_max = bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.mr : nnp_hwinfo.cxgemm.mr;
+	const size_t saved_batch_block_max = round_down(cache_elements_l1 / (saved_input_channels_subblock_max + (bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.nr : nnp_hwinfo.cxgemm.nr)), 2);
+#else
+	const size_t saved_input_channels_subblock_max = nnp_hwinfo.cxgemm.mr;
+	const size_t saved_batch_block_max = round_down(cache_elements_l1 / (nnp_hwinfo.cxgemm.mr + nnp_hwinfo.cxgemm.nr), 2);
+#endif
+
 	/* Calculate memory footprint and allocate memory */
 	const size_t kernel_transform_size = output_channels * input_channels * tile_elements * sizeof(float);
 	const size_t input_transform_size  = batch_size * input_channels * tile_elements * sizeof(float);
@@ -383,6 +467,28 @@ static enum nnp_status compute_fast_convolution_output(
 				&input_transform_ctx,
 				input_channels, batch_size,
 				1, batch_subblock_max);
+
+			if (saved_input_transform != NULL)
+			{
+				struct input_transform_packing_context input_transform_packing_context =
+				{
+					.input_transform = input_transform,
+					.saved_input_transform = saved_input_transform,
+					.tuple_elements = tuple_elements,
+					.tuple_count = tuple_count,
+					.batch_size = batch_size,
+					.input_channels = input_channels,
+					.input_channels_block_max = input_channels_block_max,
+					.batch_subblock_max = batch_subblock_max,
+					.saved_batch_block_max = saved_batch_block_max,
+					.saved_input_channels_subblock_max = saved_input_channels_subblock_max
+				};
+				pthreadpool_compute_2d(
+					(pthreadpool_function_2d_t)compute_input_transform_packing,
+					&input_transform_packing_context,
+					batch_size, input_channels);
+				saved_input_transform += batch_size * input_channels * tile_elements;
+			}
 			NNP_INPUT_TRANSFORM_END(profile)
 
 			NNP_BLOCK_MULTIPLICATION_START(profile)
@@ -452,13 +558,15 @@ static enum nnp_status compute_fast_convolution_output(
 				.output = output + y * output_size.width + x,
 				.output_transform = output_transform,
 				.bias = bias,
+				.residual = (residual == NULL ? NULL : residual + y * output_size.width + x),
 				.tuple_elements = tuple_elements,
 				.output_channels = output_channels,
 				.batch_size = batch_size,
 				.batch_block_max = batch_block_max,
 				.output_size = output_size,
 				.row_count = min(output_tile_size.height, output_size.height - y),
-				.column_count = min(output_tile_size.width, output_size.width - x)
+				.column_count = min(output_tile_size.width, output_size.width - x),
+				.activation = activation
 			};
 			pthreadpool_compute_2d_tiled(
 				(pthreadpool_function_2d_tiled_t)compute_output_transform,
@@ -475,6 +583,285 @@ static enum nnp_status compute_fast_convolution_output(
 	return nnp_status_success;
 }
 
+struct NNP_CACHE_ALIGN package_convolution_output_context
+{
+	const bool fourier_transform;
+	const size_t packages_count;
+	const size_t batch_size;
+	const size_t input_channels;
+	const size_t output_channels;
+	const struct nnp_size tile_size;
+	const struct nnp_size input_size;
+	const struct nnp_padding input_padding;
+	const struct nnp_size kernel_size;
+	const struct nnp_size output_size;
+	const float* input;
+	const float* kernel;
+	const float* bias;
+	const float* residual;
+	float* output;
+	const nnp_transform_2d_with_offset input_transform_function;
+	const nnp_transform_2d_with_offset kernel_transform_function;
+	const nnp_transform_2d_with_bias output_transform_function;
+	const enum nnp_activation activation;
+	struct nnp_profile* profile;
+	enum nnp_status* status;
+};
+
+static void compute_package_convolution_output(
+	const struct package_convolution_output_context* context,
+	const size_t package)
+{
+	const size_t packages_count = context->packages_count;
+	const size_t batch_size     = context->batch_size;
+	const size_t batch_start    = batch_size * package / packages_count;
+	const size_t batch_end      = batch_size * (package + 1) / packages_count;
+
+	const size_t input_elements  = context->input_channels * context->input_size.height * context->input_size.width;
+	const size_t output_elements = context->output_channels * context->output_size.height * context->output_size.width;
+
+	/* Runs on a thread bound to the package: the workspace is allocated, and first touched, in its local memory */
+	context->status[package] = compute_fast_convolution_output(
+		context->fourier_transform, batch_end - batch_start, context->input_channels, context->output_channels,
+		context->tile_size, context->input_size, context->input_padding, context->kernel_size, context->output_size,
+		context->input + batch_start * input_elements, context->kernel, context->bias,
+		context->residual == NULL ? NULL : context->residual + batch_start * output_elements,
+		context->output + batch_start * output_elements,
+		NULL, NULL, NULL, &nnp_hwinfo.packages[package].blocking,
+		context->input_transform_function, context->kernel_transform_function, context->output_transform_function,
+		context->activation, package == 0 ? context->profile : NULL);
+}
+
+/*
+ * On multi-socket machines, a large batch is split across processor packages, each processed by threads bound to
+ * the package, with its own workspace in local memory and blocking for its own L3 cache. The kernel transform is
+ * recomputed per package to keep it local. Partitioning needs the library-allocated workspace; with a caller-provided
+ * workspace, or when saving the input transform, the whole batch is processed with nnp_hwinfo.blocking.
+ * Packages are not discovered in MSVC builds, where packages_count is always 1.
+ */
+static enum nnp_status compute_partitioned_convolution_output(
+	const bool fourier_transform,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size tile_size,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_size,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	float* saved_input_transform,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const nnp_transform_2d_with_offset input_transform_function,
+	const nnp_transform_2d_with_offset kernel_transform_function,
+	const nnp_transform_2d_with_bias output_transform_function,
+	const enum nnp_activation activation,
+	struct nnp_profile* profile)
+{
+	const size_t packages_count = nnp_hwinfo.packages_count;
+	/* Each package must get at least a full GEMM row block of images */
+#ifdef _WIN64
+	const bool bypass_fft16x16 = tile_size.width == 16 && nnp_hwinfo.simd_width == 8;
+	const size_t batch_subblock_max = fourier_transform ? (bypass_fft16x16 ? nnp_hwinfo.cxgemm_psimd.mr : nnp_hwinfo.cxgemm.mr) : nnp_hwinfo.sxgemm.mr;
+#else
+	const size_t batch_subblock_max = fourier_transform ? nnp_hwinfo.cxgemm.mr : nnp_hwinfo.sxgemm.mr;
+#endif
+	if (packages_count <= 1 || batch_size < packages_count * batch_subblock_max ||
+		workspace_buffer != NULL || workspace_size != NULL || saved_input_transform != NULL)
+	{
+		return compute_fast_convolution_output(
+			fourier_transform, batch_size, input_channels, output_channels,
+			tile_size, input_size, input_padding, kernel_size, output_size,
+			input, kernel, bias, residual, output, saved_input_transform,
+			workspace_buffer, workspace_size, &nnp_hwinfo.blocking,
+			input_transform_function, kernel_transform_function, output_transform_function,
+			activation, profile);
+	}
+
+	enum nnp_status status[NNP_MAX_PACKAGES];
+	struct package_convolution_output_context package_convolution_output_context =
+	{
+		.fourier_transform = fourier_transform,
+		.packages_count = packages_count,
+		.batch_size = batch_size,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.tile_size = tile_size,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.output_size = output_size,
+		.input = input,
+		.kernel = kernel,
+		.bias = bias,
+		.residual = residual,
+		.output = output,
+		.input_transform_function = input_transform_function,
+		.kernel_transform_function = kernel_transform_function,
+		.output_transform_function = output_transform_function,
+		.activation = activation,
+		.profile = profile,
+		.status = status
+	};
+	pthreadpool_compute_packages(
+		(pthreadpool_function_1d_t)compute_package_convolution_output,
+		&package_convolution_output_context,
+		packages_count);
+
+	for (size_t package = 0; package < packages_count; package++)
+	{
+		if (status[package] != nnp_status_success)
+			return status[package];
+	}
+	return nnp_status_success;
+}
+
+/*
+ * Strided convolution, as well as the direct and implicit GEMM algorithms, is computed image by image with the inference
+ * implementation, which supports output subsampling via implicit GEMM and strided Winograd output transforms.
+ * If the algorithm needs a kernel transform, it is computed once and reused for all images in the batch.
+ */
+static enum nnp_status compute_inference_convolution_output(
+	enum nnp_convolution_algorithm algorithm,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size output_size,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	const enum nnp_activation activation)
+{
+	enum nnp_status status = nnp_status_success;
+
+	if (algorithm == nnp_convolution_algorithm_auto)
+	{
+		struct nnp_convolution_info info;
+		status = nnp_convolution_inference_query(
+			algorithm, nnp_convolution_transform_strategy_compute,
+			input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			activation, nnp_convolution_pooling_none, &info);
+		if (status != nnp_status_success)
+			return status;
+
+		algorithm = info.algorithm;
+	}
+	else if (algorithm == nnp_convolution_algorithm_direct && kernel_size.height == 1 && kernel_size.width == 1 &&
+		(output_subsampling.height != 1 || output_subsampling.width != 1))
+	{
+		/* Strided 1x1 convolution is the same GEMM with a strided gather of the input */
+		algorithm = nnp_convolution_algorithm_implicit_gemm;
+	}
+
+	const bool transform_kernel = (algorithm != nnp_convolution_algorithm_implicit_gemm && algorithm != nnp_convolution_algorithm_direct);
+	const enum nnp_convolution_transform_strategy transform_strategy =
+		transform_kernel ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute;
+
+	size_t kernel_transform_size = 0;
+	if (transform_kernel)
+	{
+		status = nnp_convolution_inference(
+			algorithm, nnp_convolution_transform_strategy_precompute,
+			input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			NULL, NULL, NULL, NULL, NULL, NULL, &kernel_transform_size,
+			activation, NULL, nnp_convolution_pooling_none, NULL);
+		if (status != nnp_status_success)
+			return status;
+
+		kernel_transform_size = round_up(kernel_transform_size, 64);
+	}
+
+	size_t inference_workspace_size = 0;
+	status = nnp_convolution_inference(
+		algorithm, transform_strategy,
+		input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &inference_workspace_size,
+		activation, NULL, nnp_convolution_pooling_none, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	const size_t memory_size = kernel_transform_size + inference_workspace_size;
+	void* memory_block = NULL;
+	if (workspace_buffer == NULL)
+	{
+		if (workspace_size == NULL)
+		{
+			/* Direct 1x1 convolution needs neither a transformed kernel nor a workspace */
+			if (memory_size != 0)
+			{
+				memory_block = allocate_memory(memory_size);
+				if (memory_block == NULL)
+					return nnp_status_out_of_memory;
+			}
+		}
+		else
+		{
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	}
+	else
+	{
+		if (*workspace_size < memory_size)
+			return nnp_status_insufficient_buffer;
+
+		memory_block = workspace_buffer;
+	}
+
+	void* kernel_transform = memory_block;
+	void* inference_workspace = (inference_workspace_size == 0 ? NULL : (char*)memory_block + kernel_transform_size);
+
+	if (transform_kernel)
+	{
+		size_t kernel_transform_buffer_size = kernel_transform_size;
+		status = nnp_convolution_inference(
+			algorithm, nnp_convolution_transform_strategy_precompute,
+			input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			NULL, kernel, NULL, NULL, NULL, kernel_transform, &kernel_transform_buffer_size,
+			activation, NULL, nnp_convolution_pooling_none, NULL);
+	}
+
+	const size_t input_elements = input_size.height * input_size.width * input_channels;
+	const size_t output_elements = output_size.height * output_size.width * output_channels;
+	for (size_t sample = 0; sample < batch_size && status == nnp_status_success; sample++)
+	{
+		size_t inference_buffer_size = inference_workspace_size;
+		status = nnp_convolution_inference(
+			algorithm, transform_strategy,
+			input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			input + sample * input_elements,
+			transform_kernel ? (const float*)kernel_transform : kernel,
+			bias,
+			residual == NULL ? NULL : residual + sample * output_elements,
+			output + sample * output_elements,
+			inference_workspace, inference_workspace == NULL ? NULL : &inference_buffer_size,
+			activation, NULL, nnp_convolution_pooling_none, NULL);
+	}
+
+	if (memory_block != workspace_buffer)
+		release_memory(memory_block, memory_size);
+
+	return status;
+}
+
 enum nnp_status nnp_convolution_output(
 	enum nnp_convolution_algorithm algorithm,
 	const size_t batch_size,
@@ -483,10 +870,14 @@ enum nnp_status nnp_convolution_output(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
+	void* input_transform,
+	size_t* input_transform_size,
 	void* workspace_buffer,
 	size_t* workspace_size,
 	const enum nnp_activation activation,
@@ -497,12 +888,12 @@ enum nnp_status nnp_convolution_output(
 
 	const struct nnp_size output_size = 
 	{ 
-		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1, 
-		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1 
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1, 
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1 
 	};
 	
 	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, (struct nnp_size) { .width = 1, .height = 1 }, activation, activation_parameters);
+	enum nnp_status status = validate_convolution_arguments(batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, activation, activation_parameters);
 	if (status != nnp_status_success) 
 		goto cleanup;
 
@@ -512,10 +903,34 @@ enum nnp_status nnp_convolution_output(
 		goto cleanup;
 	}
 
+	/* Saved input transforms follow the tiling of the unit-stride Fourier kernel gradient */
+	const bool save_input_transform = (input_transform_size != NULL);
+	if (save_input_transform && (output_subsampling.height != 1 || output_subsampling.width != 1))
+	{
+		status = nnp_status_unsupported_transform_strategy;
+		goto cleanup;
+	}
+
+	if (output_subsampling.height != 1 || output_subsampling.width != 1)
+	{
+		status = compute_inference_convolution_output(
+			algorithm, batch_size, input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling, output_size,
+			input, kernel, bias, residual, output, workspace_buffer, workspace_size, activation);
+		goto cleanup;
+	}
+
 	/* If requested, choose optimal convolution algorithm */
 	if (algorithm == nnp_convolution_algorithm_auto) 
 	{
-		if (max(kernel_size.width, kernel_size.height) > 8) 
+		if (kernel_size.height == 1 && kernel_size.width == 1 && !save_input_transform)
+			/* 1x1 convolution is a plain GEMM */
+			algorithm = nnp_convolution_algorithm_direct;
+		else if (max(kernel_size.width, kernel_size.height) > 16 && !save_input_transform) 
+			/* 32x32 transforms are not available on x86-64 */
+			algorithm = (nnp_hwinfo.transforms.fft32x32_with_offset_and_stream != NULL ?
+				nnp_convolution_algorithm_ft32x32 : nnp_convolution_algorithm_implicit_gemm);
+		else if (max(kernel_size.width, kernel_size.height) > 8) 
 			algorithm = nnp_convolution_algorithm_ft16x16;
 		else 
 		{
@@ -527,7 +942,7 @@ enum nnp_status nnp_convolution_output(
 			if (tile_count_8x8 <= 4 * tile_count_16x16) 
 			{
 				/* 8x8 tiles are more efficient */
-				if (kernel_size.height == 3 && kernel_size.width == 3) 
+				if (kernel_size.height == 3 && kernel_size.width == 3 && !save_input_transform) 
 					algorithm = nnp_convolution_algorithm_wt8x8;
 				else 
 					algorithm = nnp_convolution_algorithm_ft8x8;
@@ -537,6 +952,42 @@ enum nnp_status nnp_convolution_output(
 		}
 	}
 
+	if (save_input_transform)
+	{
+		if (algorithm != nnp_convolution_algorithm_ft8x8 && algorithm != nnp_convolution_algorithm_ft16x16)
+		{
+			status = nnp_status_unsupported_transform_strategy;
+			goto cleanup;
+		}
+
+		const size_t tile_size = (algorithm == nnp_convolution_algorithm_ft8x8 ? 8 : 16);
+		if (max(kernel_size.height, kernel_size.width) > tile_size)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+
+		const size_t tiles_count =
+			divide_round_up(output_size.height, doz(tile_size + 1, kernel_size.height)) *
+			divide_round_up(output_size.width, doz(tile_size + 1, kernel_size.width));
+		const size_t required_size = tiles_count * batch_size * input_channels * tile_size * tile_size * sizeof(float);
+		if (input_transform == NULL)
+		{
+			*input_transform_size = required_size;
+			status = nnp_status_success;
+			goto cleanup;
+		}
+
+		if (*input_transform_size < required_size)
+		{
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+	}
+
+	/* With a residual, the activation must follow the addition, so output transforms are chosen without it */
+	const enum nnp_activation transform_activation = (residual == NULL ? activation : nnp_activation_identity);
+
 	/* Choose tiling parameters and transform functions depending on convolution algorithm */
 	switch (algorithm) 
 	{
@@ -546,7 +997,7 @@ enum nnp_status nnp_convolution_output(
 			status = nnp_status_unsupported_algorithm;
 			goto cleanup;
 		}
-		status = compute_fast_convolution_output(false, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, output, workspace_buffer, workspace_size, nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream, nnp_hwinfo.transforms.kwt_f6x6_3x3, (activation == nnp_activation_relu ? nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu : nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias), profile);
+		status = compute_partitioned_convolution_output(false, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, residual, output, NULL, workspace_buffer, workspace_size, nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream, nnp_hwinfo.transforms.kwt_f6x6_3x3, (transform_activation == nnp_activation_relu ? nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu : nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias), activation, profile);
 		break;
 
 	case nnp_convolution_algorithm_ft8x8:
@@ -555,7 +1006,7 @@ enum nnp_status nnp_convolution_output(
 			status = nnp_status_unsupported_algorithm;
 			goto cleanup;
 		}
-		status = compute_fast_convolution_output(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, output, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, (activation == nnp_activation_relu ? nnp_hwinfo.transforms.ifft8x8_with_bias_with_relu : nnp_hwinfo.transforms.ifft8x8_with_bias), profile);
+		status = compute_partitioned_convolution_output(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 8, .height = 8 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, residual, output, (save_input_transform ? (float*)input_transform : NULL), workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, nnp_hwinfo.transforms.fft8x8_with_offset_and_stream, (transform_activation == nnp_activation_relu ? nnp_hwinfo.transforms.ifft8x8_with_bias_with_relu : nnp_hwinfo.transforms.ifft8x8_with_bias), activation, profile);
 		break;
 
 	case nnp_convolution_algorithm_ft16x16:
@@ -564,7 +1015,29 @@ enum nnp_status nnp_convolution_output(
 			status = nnp_status_unsupported_algorithm;
 			goto cleanup;
 		}
-		status = compute_fast_convolution_output(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, output, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, (activation == nnp_activation_relu ? nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu : nnp_hwinfo.transforms.ifft16x16_with_bias), profile);
+		status = compute_partitioned_convolution_output(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 16, .height = 16 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, residual, output, (save_input_transform ? (float*)input_transform : NULL), workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, nnp_hwinfo.transforms.fft16x16_with_offset_and_stream, (transform_activation == nnp_activation_relu ? nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu : nnp_hwinfo.transforms.ifft16x16_with_bias), activation, profile);
+		break;
+
+	case nnp_convolution_algorithm_ft32x32:
+		if (kernel_size.height > 32 || kernel_size.width > 32 || nnp_hwinfo.transforms.fft32x32_with_offset_and_stream == NULL)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+		status = compute_partitioned_convolution_output(true, batch_size, input_channels, output_channels, (struct nnp_size) { .width = 32, .height = 32 }, input_size, input_padding, kernel_size, output_size, input, kernel, bias, residual, output, NULL, workspace_buffer, workspace_size, nnp_hwinfo.transforms.fft32x32_with_offset_and_stream, nnp_hwinfo.transforms.fft32x32_with_offset_and_stream, (transform_activation == nnp_activation_relu ? nnp_hwinfo.transforms.ifft32x32_with_bias_with_relu : nnp_hwinfo.transforms.ifft32x32_with_bias), activation, profile);
+		break;
+
+	case nnp_convolution_algorithm_direct:
+		if (kernel_size.height != 1 || kernel_size.width != 1)
+		{
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		}
+		status = compute_inference_convolution_output(algorithm, batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, output_size, input, kernel, bias, residual, output, workspace_buffer, workspace_size, activation);
+		break;
+
+	case nnp_convolution_algorithm_implicit_gemm:
+		status = compute_inference_convolution_output(algorithm, batch_size, input_channels, output_channels, input_size, input_padding, kernel_size, output_subsampling, output_size, input, kernel, bias, residual, output, workspace_buffer, workspace_size, activation);
 		break;
 
 	default:
@@ -2,15 +2,19 @@
 #include <nnpack/utils.h>
 #include <nnpack/hwinfo.h>
 #include <nnpack/validation.h>
+#include <nnpack/system.h>
 #include <nnpack/macros.h>
+#include <nnpack/activations.h>
 
 
 struct NNP_CACHE_ALIGN fully_connected_inference_context 
 {
 	const size_t input_channels;
 	const float* input;
-	const float* kernel;
+	const void* kernel;
+	const float* bias;
 	float* output;
+	const enum nnp_activation activation;
 };
 
 static void compute_fully_connected_inference_f32(
@@ -20,11 +24,153 @@ static void compute_fully_connected_inference_f32(
 {
 	const size_t input_channels      = context->input_channels;
 	const float* input               = context->input;
-	const float* kernel              = context->kernel;
+	const float* kernel              = (const float*) context->kernel;
+	const float* bias                = context->bias;
 	float* output                    = context->output;
 	const nnp_sdotxf_function sdotxf = nnp_hwinfo.sdotxf.functions[output_channels_subblock_size - 1];
 
 	sdotxf(input, &kernel[output_channels_subblock_start * input_channels],	input_channels, &output[output_channels_subblock_start], input_channels);
+	add_bias_with_activation(&output[output_channels_subblock_start], bias == NULL ? NULL : &bias[output_channels_subblock_start],
+		1, output_channels_subblock_size, output_channels_subblock_size, context->activation);
+}
+
+static void compute_fully_connected_inference_f16f32(
+	const struct fully_connected_inference_context* context,
+	const size_t output_channels_subblock_start,
+	const size_t output_channels_subblock_size)
+{
+	const size_t input_channels        = context->input_channels;
+	const float* input                 = context->input;
+	const uint16_t* kernel             = (const uint16_t*) context->kernel;
+	const float* bias                  = context->bias;
+	float* output                      = context->output;
+	const nnp_shdotxf_function shdotxf = nnp_hwinfo.shdotxf.functions[output_channels_subblock_size - 1];
+
+	shdotxf(input, &kernel[output_channels_subblock_start * input_channels], input_channels, &output[output_channels_subblock_start], input_channels);
+	add_bias_with_activation(&output[output_channels_subblock_start], bias == NULL ? NULL : &bias[output_channels_subblock_start],
+		1, output_channels_subblock_size, output_channels_subblock_size, context->activation);
+}
+
+/* Smallest number of input channels worth a separate task when the reduction is split across threads */
+#define SPLIT_INPUT_CHANNELS_BLOCK_MIN 256
+/* Partial sums of the split reduction live on the stack, so their number is bounded (4 KB) */
+#define SPLIT_PARTIAL_OUTPUT_MAX 1024
+
+struct NNP_CACHE_ALIGN split_fully_connected_inference_context
+{
+	const size_t input_channels;
+	const size_t output_channels;
+	const size_t input_channels_block_max;
+	const float* input;
+	const void* kernel;
+	float* partial_output;
+};
+
+static void compute_split_fully_connected_inference_f32(
+	const struct split_fully_connected_inference_context* context,
+	const size_t input_channels_block_start,
+	const size_t output_channels_subblock_start,
+	const size_t input_channels_block_size,
+	const size_t output_channels_subblock_size)
+{
+	const size_t input_channels           = context->input_channels;
+	const size_t output_channels          = context->output_channels;
+	const size_t input_channels_block_max = context->input_channels_block_max;
+	const float* input                    = context->input;
+	const float* kernel                   = (const float*) context->kernel;
+	float* partial_output                 = context->partial_output;
+	const nnp_sdotxf_function sdotxf      = nnp_hwinfo.sdotxf.functions[output_channels_subblock_size - 1];
+
+	const size_t input_channels_block = input_channels_block_start / input_channels_block_max;
+	sdotxf(&input[input_channels_block_start],
+		&kernel[output_channels_subblock_start * input_channels + input_channels_block_start], input_channels,
+		&partial_output[input_channels_block * output_channels + output_channels_subblock_start], input_channels_block_size);
+}
+
+static void compute_split_fully_connected_inference_f16f32(
+	const struct split_fully_connected_inference_context* context,
+	const size_t input_channels_block_start,
+	const size_t output_channels_subblock_start,
+	const size_t input_channels_block_size,
+	const size_t output_channels_subblock_size)
+{
+	const size_t input_channels           = context->input_channels;
+	const size_t output_channels          = context->output_channels;
+	const size_t input_channels_block_max = context->input_channels_block_max;
+	const float* input                    = context->input;
+	const uint16_t* kernel                = (const uint16_t*) context->kernel;
+	float* partial_output                 = context->partial_output;
+	const nnp_shdotxf_function shdotxf    = nnp_hwinfo.shdotxf.functions[output_channels_subblock_size - 1];
+
+	const size_t input_channels_block = input_channels_block_start / input_channels_block_max;
+	shdotxf(&input[input_channels_block_start],
+		&kernel[output_channels_subblock_start * input_channels + input_channels_block_start], input_channels,
+		&partial_output[input_channels_block * output_channels + output_channels_subblock_start], input_channels_block_size);
+}
+
+/*
+ * Returns the number of blocks to split input channels into, so that every thread gets a task when there are fewer
+ * subblocks of output channels than threads. Returns 1 when the output channels alone provide enough parallelism.
+ */
+static size_t get_input_channels_blocks(
+	const size_t input_channels,
+	const size_t output_channels,
+	const size_t output_channels_subblock_max,
+	size_t* input_channels_block_max)
+{
+	const size_t threads_count = pthreadpool_get_threads_count();
+	const size_t output_channels_subblocks = divide_round_up(output_channels, output_channels_subblock_max);
+	if (output_channels_subblocks >= threads_count)
+		return 1;
+
+	const size_t input_channels_blocks = min(min(divide_round_up(threads_count, output_channels_subblocks), input_channels / SPLIT_INPUT_CHANNELS_BLOCK_MIN),
+		SPLIT_PARTIAL_OUTPUT_MAX / output_channels);
+	if (input_channels_blocks <= 1)
+		return 1;
+
+	*input_channels_block_max = round_up(divide_round_up(input_channels, input_channels_blocks), 16);
+	return divide_round_up(input_channels, *input_channels_block_max);
+}
+
+/* Computes partial dot products for each block of input channels in parallel, then reduces them into the output */
+static void compute_split_fully_connected_inference(
+	pthreadpool_function_2d_tiled_t compute_function,
+	const size_t input_channels,
+	const size_t input_channels_blocks,
+	const size_t input_channels_block_max,
+	const size_t output_channels,
+	const size_t output_channels_subblock_max,
+	const float* input,
+	const void* kernel,
+	const float* bias,
+	float* output,
+	const enum nnp_activation activation)
+{
+	NNP_CACHE_ALIGN float partial_output[SPLIT_PARTIAL_OUTPUT_MAX];
+
+	struct split_fully_connected_inference_context split_fully_connected_inference_context =
+	{
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input_channels_block_max = input_channels_block_max,
+		.input = input,
+		.kernel = kernel,
+		.partial_output = partial_output
+	};
+	pthreadpool_compute_2d_tiled(
+		compute_function,
+		&split_fully_connected_inference_context,
+		input_channels, output_channels,
+		input_channels_block_max, output_channels_subblock_max);
+
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+	{
+		float sum = 0.0f;
+		for (size_t input_channels_block = 0; input_channels_block < input_channels_blocks; input_channels_block++)
+			sum += partial_output[input_channels_block * output_channels + output_channel];
+		output[output_channel] = sum;
+	}
+	add_bias_with_activation(output, bias, 1, output_channels, output_channels, activation);
 }
 
 enum nnp_status nnp_fully_connected_inference(
@@ -32,21 +178,41 @@ enum nnp_status nnp_fully_connected_inference(
 	const size_t output_channels,
 	const float* input,
 	const float* kernel,
-	float* output)
+	const float* bias,
+	float* output,
+	const enum nnp_activation activation,
+	const void* activation_parameters)
 {
 	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels);
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation, activation_parameters);
 	if (status != nnp_status_success)
 		return status;
+
+	if (activation_parameters != NULL)
+		return nnp_status_unsupported_activation_parameters;
 	
 	/* Do the computation */
 	const size_t output_channels_subblock_max = nnp_hwinfo.sdotxf.fusion;
+	size_t input_channels_block_max = input_channels;
+	const size_t input_channels_blocks = get_input_channels_blocks(input_channels, output_channels, output_channels_subblock_max, &input_channels_block_max);
+	if (input_channels_blocks > 1)
+	{
+		compute_split_fully_connected_inference(
+			(pthreadpool_function_2d_tiled_t)compute_split_fully_connected_inference_f32,
+			input_channels, input_channels_blocks, input_channels_block_max,
+			output_channels, output_channels_subblock_max,
+			input, kernel, bias, output, activation);
+		return nnp_status_success;
+	}
+
 	struct fully_connected_inference_context fully_connected_inference_context = 
 	{
 		.input_channels = input_channels,
 		.input = input,
 		.kernel = kernel,
-		.output = output
+		.bias = bias,
+		.output = output,
+		.activation = activation
 	};
 	pthreadpool_compute_1d_tiled(
 		(pthreadpool_function_1d_tiled_t)compute_fully_connected_inference_f32,
@@ -54,4 +220,53 @@ enum nnp_status nnp_fully_connected_inference(
 		output_channels, output_channels_subblock_max);
 
 	return nnp_status_success;
-}
\ No newline at end of file
+}
+
+enum nnp_status nnp_fully_connected_inference_f16f32(
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* input,
+	const void* kernel,
+	const float* bias,
+	float* output,
+	const enum nnp_activation activation,
+	const void* activation_parameters)
+{
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, activation, activation_parameters);
+	if (status != nnp_status_success)
+		return status;
+
+	if (activation_parameters != NULL)
+		return nnp_status_unsupported_activation_parameters;
+
+	/* Do the computation */
+	const size_t output_channels_subblock_max = nnp_hwinfo.shdotxf.fusion;
+	size_t input_channels_block_max = input_channels;
+	const size_t input_channels_blocks = get_input_channels_blocks(input_channels, output_channels, output_channels_subblock_max, &input_channels_block_max);
+	if (input_channels_blocks > 1)
+	{
+		compute_split_fully_connected_inference(
+			(pthreadpool_function_2d_tiled_t)compute_split_fully_connected_inference_f16f32,
+			input_channels, input_channels_blocks, input_channels_block_max,
+			output_channels, output_channels_subblock_max,
+			input, kernel, bias, output, activation);
+		return nnp_status_success;
+	}
+
+	struct fully_connected_inference_context fully_connected_inference_context =
+	{
+		.input_channels = input_channels,
+		.input = input,
+		.kernel = kernel,
+		.bias = bias,
+		.output = output,
+		.activation = activation
+	};
+	pthreadpool_compute_1d_tiled(
+		(pthreadpool_function_1d_tiled_t)compute_fully_connected_inference_f16f32,
+		&fully_connected_inference_context,
+		output_channels, output_channels_subblock_max);
+
+	return nnp_status_success;
+}
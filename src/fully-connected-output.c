@@ -4,12 +4,15 @@
 #include <nnpack/validation.h>
 #include <nnpack/system.h>
 #include <nnpack/macros.h>
+#include <nnpack/activations.h>
 
 struct NNP_CACHE_ALIGN input_packing_context 
 {
 	const float* matrix;
 	float* packed_matrix;
 	const size_t input_channels;
+	const size_t matrix_row_stride;
+	const size_t matrix_column_stride;
 	const size_t outer_subblock_max;
 };
 
@@ -20,10 +23,12 @@ static void pack_input_matrix(
 	const size_t outer_block_size,
 	const size_t input_channels_block_size)
 {
-	const float* matrix             = context->matrix;
-	float* packed_matrix            = context->packed_matrix;
-	const size_t input_channels     = context->input_channels;
-	const size_t outer_subblock_max = context->outer_subblock_max;
+	const float* matrix               = context->matrix;
+	float* packed_matrix              = context->packed_matrix;
+	const size_t input_channels       = context->input_channels;
+	const size_t matrix_row_stride    = context->matrix_row_stride;
+	const size_t matrix_column_stride = context->matrix_column_stride;
+	const size_t outer_subblock_max   = context->outer_subblock_max;
 
 	for (size_t outer_subblock_start = 0; outer_subblock_start < outer_block_size; outer_subblock_start += outer_subblock_max) 
 	{
@@ -33,7 +38,7 @@ static void pack_input_matrix(
 			const size_t input_channel = input_channels_block_start + input_channels_block_offset;
 			for (size_t outer_subblock_offset = 0; outer_subblock_offset < outer_subblock_size; outer_subblock_offset++) 
 			{
-				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * input_channels + input_channel;
+				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * matrix_row_stride + input_channel * matrix_column_stride;
 				const size_t packed_index = outer_block_start * input_channels + input_channels_block_start * outer_block_size + outer_subblock_start * input_channels_block_size + input_channels_block_offset * outer_subblock_size + outer_subblock_offset;
 				packed_matrix[packed_index] = matrix[index];
 			}
@@ -47,7 +52,8 @@ struct NNP_CACHE_ALIGN kernel_packing_context
 	float* packed_matrix;
 
 	const size_t simd_width;
-	const size_t input_channels;
+	const size_t matrix_row_stride;
+	const size_t matrix_column_stride;
 	const size_t outer_subblock_max;
 	const size_t input_channels_block_start;
 	const size_t input_channels_block_size;
@@ -60,7 +66,8 @@ static void pack_kernel_matrix(
 {
 	const float* matrix                     = context->matrix;
 	float* packed_matrix                    = context->packed_matrix;
-	const size_t input_channels             = context->input_channels;
+	const size_t matrix_row_stride          = context->matrix_row_stride;
+	const size_t matrix_column_stride       = context->matrix_column_stride;
 	const size_t outer_subblock_max         = context->outer_subblock_max;
 	const size_t input_channels_block_start = context->input_channels_block_start;
 	const size_t input_channels_block_size  = context->input_channels_block_size;
@@ -75,7 +82,7 @@ static void pack_kernel_matrix(
 			const size_t input_channel = input_channels_block_start + input_channels_block_offset;
 			for (size_t outer_subblock_offset = 0; outer_subblock_offset < outer_subblock_size; outer_subblock_offset++) 
 			{
-				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * input_channels + input_channel;
+				const size_t index = (outer_block_start + outer_subblock_start + outer_subblock_offset) * matrix_row_stride + input_channel * matrix_column_stride;
 				const size_t packed_index = (outer_block_start + outer_subblock_start) * input_channels_block_size + input_channels_block_offset * outer_subblock_stride + outer_subblock_offset;
 				packed_matrix[packed_index] = matrix[index];
 			}
@@ -87,6 +94,7 @@ struct NNP_CACHE_ALIGN matrix_multiplication_context
 {
 	const float* input;
 	const float* kernel;
+	const float* bias;
 	float* output;
 	const size_t input_channels;
 	const size_t output_channels;
@@ -99,6 +107,7 @@ struct NNP_CACHE_ALIGN matrix_multiplication_context
 	const size_t simd_width;
 	nnp_fast_sgemm_function fast_sgemm_function;
 	nnp_full_sgemm_function full_sgemm_function;
+	const enum nnp_activation activation;
 };
 
 static void compute_matrix_multiplication(
@@ -110,6 +119,7 @@ static void compute_matrix_multiplication(
 {
 	const float* input                       = context->input;
 	const float* kernel                      = context->kernel;
+	const float* bias                        = context->bias;
 	float* output                            = context->output;
 	const size_t input_channels              = context->input_channels;
 	const size_t output_channels             = context->output_channels;
@@ -122,6 +132,10 @@ static void compute_matrix_multiplication(
 	const size_t simd_width                  = context->simd_width;
 	const nnp_fast_sgemm_function fast_sgemm = context->fast_sgemm_function;
 	const nnp_full_sgemm_function full_sgemm = context->full_sgemm_function;
+	const enum nnp_activation activation     = context->activation;
+
+	/* Bias and activation are applied by the pass over the last block of input channels, while the output is in cache */
+	const bool last_input_channels_block     = (input_channels_block_start + input_channels_block_size == input_channels);
 
 	for (size_t output_channels_subblock_start = 0; output_channels_subblock_start < output_channels_block_size; output_channels_subblock_start += output_channels_subblock_max) 
 	{
@@ -145,10 +159,111 @@ static void compute_matrix_multiplication(
 				&output[(batch_block_start + batch_subblock_start) * output_channels + (output_channels_block_start + output_channels_subblock_start)],
 				output_channels);
 		}
+
+		if (last_input_channels_block)
+		{
+			const size_t output_channel = output_channels_block_start + output_channels_subblock_start;
+			add_bias_with_activation(
+				&output[(batch_block_start + batch_subblock_start) * output_channels + output_channel],
+				bias == NULL ? NULL : &bias[output_channel],
+				batch_subblock_size, output_channels_subblock_size, output_channels, activation);
+		}
 	}
 }
 
+/* Upper bound on the number of batch rows one sdotxf call handles in the small-batch path */
+#define SMALL_BATCH_SUBBLOCK_MAX 8
+
+struct NNP_CACHE_ALIGN small_batch_context
+{
+	const float* input;
+	const float* kernel;
+	const float* bias;
+	float* output;
+	const size_t batch_size;
+	const size_t input_channels;
+	const size_t output_channels;
+	const size_t batch_subblock_max;
+	const nnp_sdotxf_function* sdotxf_functions;
+	const enum nnp_activation activation;
+};
+
+static void compute_small_batch_fully_connected_output(
+	const struct small_batch_context* context,
+	const size_t output_channels_block_start,
+	const size_t output_channels_block_size)
+{
+	const float* input                          = context->input;
+	const float* kernel                         = context->kernel;
+	const float* bias                           = context->bias;
+	float* output                               = context->output;
+	const size_t batch_size                     = context->batch_size;
+	const size_t input_channels                 = context->input_channels;
+	const size_t output_channels                = context->output_channels;
+	const size_t batch_subblock_max             = context->batch_subblock_max;
+	const nnp_sdotxf_function* sdotxf_functions = context->sdotxf_functions;
+	const enum nnp_activation activation        = context->activation;
+
+	float batch_sums[SMALL_BATCH_SUBBLOCK_MAX];
+	for (size_t output_channel = output_channels_block_start; output_channel < output_channels_block_start + output_channels_block_size; output_channel++)
+	{
+		/* The kernel row stays in L1 while it is dotted against every batch subblock */
+		const float* kernel_row = &kernel[output_channel * input_channels];
+		for (size_t batch_subblock_start = 0; batch_subblock_start < batch_size; batch_subblock_start += batch_subblock_max)
+		{
+			const size_t batch_subblock_size = min(batch_size - batch_subblock_start, batch_subblock_max);
+			sdotxf_functions[batch_subblock_size - 1](
+				kernel_row, &input[batch_subblock_start * input_channels], input_channels,
+				batch_sums, input_channels);
+			for (size_t batch_subblock_offset = 0; batch_subblock_offset < batch_subblock_size; batch_subblock_offset++)
+			{
+				output[(batch_subblock_start + batch_subblock_offset) * output_channels + output_channel] = batch_sums[batch_subblock_offset];
+			}
+		}
+		add_bias_with_activation(&output[output_channel], bias == NULL ? NULL : &bias[output_channel],
+			batch_size, 1, output_channels, activation);
+	}
+}
+
+/* Input channels are blocked so that a row panel of the packed input and a column panel of the packed kernel fit in L1 */
+static size_t get_input_channels_block_max(void)
+{
+	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / sizeof(float);
+	return cache_elements_l1 / (nnp_hwinfo.sgemm.mr + nnp_hwinfo.sgemm.nr);
+}
+
+/* Packs one block of input channels of the kernel, as consumed by compute_matrix_multiplication */
+static void pack_kernel_block(
+	const size_t simd_width,
+	const size_t kernel_row_stride,
+	const size_t kernel_column_stride,
+	const size_t input_channels_block_start,
+	const size_t input_channels_block_size,
+	const size_t output_channels,
+	const size_t output_channels_block_max,
+	const size_t output_channels_subblock_max,
+	const float* kernel,
+	float* packed_kernel)
+{
+	struct kernel_packing_context kernel_packing_context = 
+	{
+		.matrix = kernel,
+		.packed_matrix = packed_kernel,
+		.simd_width = simd_width,
+		.matrix_row_stride = kernel_row_stride,
+		.matrix_column_stride = kernel_column_stride,
+		.outer_subblock_max = output_channels_subblock_max,
+		.input_channels_block_start = input_channels_block_start,
+		.input_channels_block_size = input_channels_block_size
+	};
+	pthreadpool_compute_1d_tiled(
+		(pthreadpool_function_1d_tiled_t)pack_kernel_matrix,
+		&kernel_packing_context,
+		output_channels, output_channels_block_max);
+}
+
 static void compute_fully_connected_output(
+	const bool kernel_packed,
 	const size_t simd_width,
 	const size_t batch_size,
 	const size_t batch_block_max,
@@ -159,10 +274,16 @@ static void compute_fully_connected_output(
 	const size_t output_channels_block_max,
 	const size_t output_channels_subblock_max,
 	const float* input,	
+	const size_t input_row_stride,
+	const size_t input_column_stride,
 	const float* kernel, 
+	const size_t kernel_row_stride,
+	const size_t kernel_column_stride,
+	const float* bias,
 	float* output,
 	float* packed_input, 
 	float* packed_kernel,
+	enum nnp_activation activation,
 	struct nnp_profile* profile)
 {
 	NNP_INPUT_TRANSFORM_START(profile)
@@ -171,6 +292,8 @@ static void compute_fully_connected_output(
 		.matrix = input,
 		.packed_matrix = packed_input,
 		.input_channels = input_channels,
+		.matrix_row_stride = input_row_stride,
+		.matrix_column_stride = input_column_stride,
 		.outer_subblock_max = batch_subblock_max
 	};
 	pthreadpool_compute_2d_tiled(
@@ -184,6 +307,7 @@ static void compute_fully_connected_output(
 	{
 		.input = packed_input,
 		.kernel = packed_kernel,
+		.bias = bias,
 		.output = output,
 		.input_channels = input_channels,
 		.output_channels = output_channels,
@@ -191,28 +315,29 @@ static void compute_fully_connected_output(
 		.batch_subblock_max = batch_subblock_max,
 		.simd_width = simd_width,
 		.fast_sgemm_function = nnp_hwinfo.sgemm.only_mr_x_nr,
-		.full_sgemm_function = nnp_hwinfo.sgemm.upto_mr_x_nr
+		.full_sgemm_function = nnp_hwinfo.sgemm.upto_mr_x_nr,
+		.activation = activation
 	};
 	for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) 
 	{
 		const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
 
-		NNP_KERNEL_TRANSFORM_START(profile)
-		struct kernel_packing_context kernel_packing_context = 
+		if (kernel_packed)
 		{
-			.matrix = kernel,
-			.packed_matrix = packed_kernel,
-			.simd_width = simd_width,
-			.input_channels = input_channels,
-			.outer_subblock_max = output_channels_subblock_max,
-			.input_channels_block_start = input_channels_block_start,
-			.input_channels_block_size = input_channels_block_size
-		};
-		pthreadpool_compute_1d_tiled(
-			(pthreadpool_function_1d_tiled_t)pack_kernel_matrix,
-			&kernel_packing_context,
-			output_channels, output_channels_block_max);
-		NNP_KERNEL_TRANSFORM_END(profile)
+			/* Blocks of a kernel from nnp_fully_connected_pack_kernel follow each other */
+			matrix_multiplication_context.kernel = &kernel[round_up(output_channels, output_channels_subblock_max) * input_channels_block_start];
+		}
+		else
+		{
+			NNP_KERNEL_TRANSFORM_START(profile)
+			pack_kernel_block(
+				simd_width,
+				kernel_row_stride, kernel_column_stride,
+				input_channels_block_start, input_channels_block_size,
+				output_channels, output_channels_block_max, output_channels_subblock_max,
+				kernel, packed_kernel);
+			NNP_KERNEL_TRANSFORM_END(profile)
+		}
 
 		NNP_BLOCK_MULTIPLICATION_START(profile)
 		matrix_multiplication_context.input_channels_block_start = input_channels_block_start;
@@ -233,23 +358,29 @@ static void compute_fully_connected_output(
 	}
 }
 
-enum nnp_status nnp_fully_connected_output(
+/*
+ * Multiplies a batch_size x input_channels input matrix by the transpose of an output_channels x input_channels kernel
+ * matrix with packing and sgemm. Both matrices are addressed through row and column strides, so the gradient passes can
+ * feed transposed operands without copying them.
+ */
+static enum nnp_status compute_sgemm_fully_connected_output(
+	const bool kernel_packed,
 	const size_t batch_size,
 	const size_t input_channels,
 	const size_t output_channels,
 	const float* input,
+	const size_t input_row_stride,
+	const size_t input_column_stride,
 	const float* kernel,
+	const size_t kernel_row_stride,
+	const size_t kernel_column_stride,
+	const float* bias,
 	float* output,
+	const enum nnp_activation activation,
 	struct nnp_profile* profile)
 {
-	NNP_TOTAL_START(profile)
+	enum nnp_status status = nnp_status_success;
 
-	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels);
-	if (status != nnp_status_success)
-		return status;
-	
-	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / sizeof(float);
 	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / sizeof(float);
 	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / sizeof(float);
 
@@ -257,21 +388,23 @@ enum nnp_status nnp_fully_connected_output(
 	const size_t batch_subblock_max = nnp_hwinfo.sgemm.mr;
 	const size_t output_channels_subblock_max = nnp_hwinfo.sgemm.nr;
 
-	const size_t input_channels_block_max = cache_elements_l1 / (batch_subblock_max + output_channels_subblock_max);
+	const size_t input_channels_block_max = get_input_channels_block_max();
 	const size_t batch_block_max = round_down(cache_elements_l3 / input_channels_block_max, batch_subblock_max);
 	const size_t output_channels_block_max = round_down(cache_elements_l2 / input_channels_block_max, output_channels_subblock_max);
 
 	/* Calculate memory footprint and allocate memory */
 	const size_t packed_input_size = round_up(round_up(batch_size, batch_subblock_max) * input_channels * sizeof(float), 64);
-	const size_t packed_kernel_size = round_up(round_up(output_channels, output_channels_subblock_max) * input_channels_block_max * sizeof(float), 64);
+	const size_t packed_kernel_size = kernel_packed ? 0 :
+		round_up(round_up(output_channels, output_channels_subblock_max) * input_channels_block_max * sizeof(float), 64);
 	
 	void* memory_block_input = NULL;
 	void* memory_block_kernel = NULL;
 
 	memory_block_input = allocate_memory(packed_input_size);
-	memory_block_kernel = allocate_memory(packed_kernel_size);
+	if (packed_kernel_size != 0)
+		memory_block_kernel = allocate_memory(packed_kernel_size);
 
-	if (memory_block_input == NULL || memory_block_kernel == NULL)
+	if (memory_block_input == NULL || (packed_kernel_size != 0 && memory_block_kernel == NULL))
 	{
 		status = nnp_status_out_of_memory;
 		goto cleanup;
@@ -282,16 +415,210 @@ enum nnp_status nnp_fully_connected_output(
 
 	/* Do the computation */
 	compute_fully_connected_output(
+		kernel_packed,
 		simd_width,
 		batch_size, batch_block_max, batch_subblock_max,
 		input_channels, input_channels_block_max,
 		output_channels, output_channels_block_max, output_channels_subblock_max,
-		input, kernel, output,
-		packed_input, packed_kernel, profile);
+		input, input_row_stride, input_column_stride,
+		kernel, kernel_row_stride, kernel_column_stride,
+		bias, output,
+		packed_input, packed_kernel, activation, profile);
 
 cleanup:
 	release_memory(memory_block_input, packed_input_size);
 	release_memory(memory_block_kernel, packed_kernel_size);
+	return status;
+}
+
+enum nnp_status nnp_fully_connected_output(
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	const enum nnp_activation activation,
+	const void* activation_parameters,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, activation, activation_parameters);
+	if (status != nnp_status_success)
+		return status;
+
+	if (activation_parameters != NULL)
+		return nnp_status_unsupported_activation_parameters;
+
+	switch (transform_strategy)
+	{
+		case nnp_convolution_transform_strategy_compute:
+		case nnp_convolution_transform_strategy_reuse:
+			break;
+		case nnp_convolution_transform_strategy_precompute:
+			/* Kernels are packed ahead of time with nnp_fully_connected_pack_kernel */
+			return nnp_status_unsupported_transform_strategy;
+		default:
+			return nnp_status_invalid_transform_strategy;
+	}
+	const bool kernel_packed = (transform_strategy == nnp_convolution_transform_strategy_reuse);
+	
+	/*
+	 * For small batches packing the kernel costs more than the multiplication saves. Instead, stream each kernel row once
+	 * and use the fused dot product kernels to multiply it by several input vectors at a time.
+	 */
+	const size_t small_batch_subblock_max = min(nnp_hwinfo.sdotxf.fusion, SMALL_BATCH_SUBBLOCK_MAX);
+	if (!kernel_packed && batch_size <= 2 * small_batch_subblock_max)
+	{
+		NNP_BLOCK_MULTIPLICATION_START(profile)
+		struct small_batch_context small_batch_context =
+		{
+			.input = input,
+			.kernel = kernel,
+			.bias = bias,
+			.output = output,
+			.batch_size = batch_size,
+			.input_channels = input_channels,
+			.output_channels = output_channels,
+			.batch_subblock_max = small_batch_subblock_max,
+			.sdotxf_functions = nnp_hwinfo.sdotxf.functions,
+			.activation = activation
+		};
+		pthreadpool_compute_1d_tiled(
+			(pthreadpool_function_1d_tiled_t)compute_small_batch_fully_connected_output,
+			&small_batch_context,
+			output_channels, nnp_hwinfo.sdotxf.fusion);
+		NNP_BLOCK_MULTIPLICATION_END(profile)
+
+		NNP_TOTAL_END(profile)
+		return nnp_status_success;
+	}
+
+	status = compute_sgemm_fully_connected_output(
+		kernel_packed,
+		batch_size, input_channels, output_channels,
+		input, input_channels, 1,
+		kernel, input_channels, 1,
+		bias, output, activation, profile);
+
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_status nnp_fully_connected_input_gradient(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* grad_output,
+	const float* kernel,
+	float* grad_input,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, nnp_activation_identity, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	/* grad_input = grad_output x kernel, with the kernel read as an input_channels x output_channels matrix */
+	status = compute_sgemm_fully_connected_output(
+		false,
+		batch_size, output_channels, input_channels,
+		grad_output, output_channels, 1,
+		kernel, 1, input_channels,
+		NULL, grad_input, nnp_activation_identity, profile);
+
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_status nnp_fully_connected_kernel_gradient(
+	const size_t batch_size,
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* input,
+	const float* grad_output,
+	float* grad_kernel,
+	float* grad_bias,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_fully_connected_arguments(batch_size, input_channels, output_channels, nnp_activation_identity, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	/* grad_kernel = transpose(grad_output) x input: the mini-batch becomes the reduction dimension */
+	status = compute_sgemm_fully_connected_output(
+		false,
+		output_channels, batch_size, input_channels,
+		grad_output, 1, output_channels,
+		input, 1, input_channels,
+		NULL, grad_kernel, nnp_activation_identity, profile);
+	if (status != nnp_status_success)
+		goto cleanup;
+
+	if (grad_bias != NULL)
+	{
+		for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+			grad_bias[output_channel] = 0.0f;
+		for (size_t sample = 0; sample < batch_size; sample++)
+		{
+			for (size_t output_channel = 0; output_channel < output_channels; output_channel++)
+				grad_bias[output_channel] += grad_output[sample * output_channels + output_channel];
+		}
+	}
+
+cleanup:
 	NNP_TOTAL_END(profile)
 	return status;
 }
+
+enum nnp_status nnp_fully_connected_pack_kernel(
+	const size_t input_channels,
+	const size_t output_channels,
+	const float* kernel,
+	void* packed_kernel,
+	size_t* packed_kernel_size)
+{
+	enum nnp_status status = validate_fully_connected_arguments(1, input_channels, output_channels, nnp_activation_identity, NULL);
+	if (status != nnp_status_success)
+		return status;
+
+	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / sizeof(float);
+
+	const size_t simd_width = nnp_hwinfo.simd_width;
+	const size_t output_channels_subblock_max = nnp_hwinfo.sgemm.nr;
+
+	const size_t input_channels_block_max = get_input_channels_block_max();
+	const size_t output_channels_block_max = round_down(cache_elements_l2 / input_channels_block_max, output_channels_subblock_max);
+
+	const size_t packed_output_channels = round_up(output_channels, output_channels_subblock_max);
+	const size_t required_size = packed_output_channels * input_channels * sizeof(float);
+	if (packed_kernel == NULL)
+	{
+		*packed_kernel_size = required_size;
+		return nnp_status_success;
+	}
+	if (*packed_kernel_size < required_size)
+		return nnp_status_insufficient_buffer;
+
+	for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max)
+	{
+		const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+		pack_kernel_block(
+			simd_width,
+			input_channels, 1,
+			input_channels_block_start, input_channels_block_size,
+			output_channels, output_channels_block_max, output_channels_subblock_max,
+			kernel, (float*)packed_kernel + packed_output_channels * input_channels_block_start);
+	}
+
+	return nnp_status_success;
+}
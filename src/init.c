@@ -58,6 +58,40 @@ static void init_x86_hwinfo(void) {
 			}
 		}
 	}
+	nnp_hwinfo.isa = (struct isa_info) {
+		.has_avx = cpuinfo_has_x86_avx(),
+		.has_fma3 = cpuinfo_has_x86_fma3(),
+		.has_avx2 = cpuinfo_has_x86_avx2(),
+		.has_f16c = cpuinfo_has_x86_f16c(),
+	};
+}
+#endif
+
+#if (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && !defined(__ANDROID__) && !defined(_MSC_VER)
+static void init_x86_packages(void) {
+	uint32_t packages_count = cpuinfo_get_packages_count();
+	if (packages_count > NNP_MAX_PACKAGES) {
+		packages_count = NNP_MAX_PACKAGES;
+	}
+	for (uint32_t i = 0; i < packages_count; i++) {
+		const struct cpuinfo_package* package = cpuinfo_get_package(i);
+		nnp_hwinfo.packages[i] = (struct package_info) {
+			.processor_start = package->processor_start,
+			.processor_count = package->processor_count,
+			.blocking = nnp_hwinfo.blocking,
+		};
+		/* cpuinfo_get_l3_cache(0) describes the first package only; take each package's own L3 */
+		const struct cpuinfo_processor* processor = cpuinfo_get_processor(package->processor_start);
+		if (processor != NULL && processor->cache.l3 != NULL) {
+			nnp_hwinfo.packages[i].blocking.l3 = processor->cache.l3->size;
+			if (processor->cache.l3->flags & CPUINFO_CACHE_INCLUSIVE) {
+				nnp_hwinfo.packages[i].blocking.l3 -= nnp_hwinfo.cache.l2.size;
+			}
+		}
+	}
+	if (packages_count != 0) {
+		nnp_hwinfo.packages_count = packages_count;
+	}
 }
 #endif
 
@@ -230,6 +264,18 @@ static void init_hwinfo(void) {
 		}
 	}
 	nnp_hwinfo.blocking.l4 = nnp_hwinfo.cache.l4.size;
+
+	/* Processor packages for NUMA-aware partitioning: a single package unless cpuinfo reports more */
+	nnp_hwinfo.packages_count = 1;
+	nnp_hwinfo.packages[0] = (struct package_info) {
+		.processor_start = 0,
+		.processor_count = 0,
+		.blocking = nnp_hwinfo.blocking,
+	};
+	/* Not with MSVC: there pthreadpool runs packages one after another without binding, so partitioning would only serialize work */
+#if (CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64) && !defined(__ANDROID__) && !defined(_MSC_VER)
+	init_x86_packages();
+#endif
 	if (nnp_hwinfo.cache.l1.size && nnp_hwinfo.cache.l2.size && nnp_hwinfo.cache.l3.size) {
 #if NNP_BACKEND_X86_64
 		if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3()) {
@@ -298,6 +344,16 @@ static void init_hwinfo(void) {
 				.only_mr_x_nr = nnp_sgemm_only_4x24__fma3,
 				.upto_mr_x_nr = nnp_sgemm_upto_4x24__fma3,
 			};
+			nnp_hwinfo.sgemm_indirect = (struct sgemm_indirect) {
+				.mr = 4,
+				.nr = 16,
+				.only_mr_x_nr = nnp_sgemm_indirect_only_4x16__fma3,
+			};
+			nnp_hwinfo.q8gemm = (struct q8gemm) {
+				.mr = 4,
+				.nr = 16,
+				.only_mr_x_nr = nnp_q8gemm_only_4x16__avx2,
+			};
 #ifdef _WIN64
 			nnp_hwinfo.sgemm_psimd = (struct sgemm) {
 				.mr = 4,
@@ -362,6 +418,16 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 			};
 #endif			
+			if (cpuinfo_has_x86_f16c()) {
+				/* Winograd kernel transforms are stored in half precision and widened inside the tuple GEMM */
+				nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16 = (nnp_transform_2d_with_offset)nnp_kwt8x8_3x3_fp16__avx2;
+				nnp_hwinfo.sxgemm_fp16b = (struct sxgemm) {
+					.mr = 3,
+					.nr = 4,
+					.only_mr_x_nr = (nnp_fast_tuple_gemm_function)nnp_s8gemm_fp16b_only_3x4__fma3,
+					.upto_mr_x_nr = (nnp_full_tuple_gemm_function)nnp_s8gemm_fp16b_upto_3x4__fma3,
+				};
+			}
 			nnp_hwinfo.supported = true;
 		}
 #elif NNP_BACKEND_PSIMD
@@ -380,6 +446,9 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 		nnp_hwinfo.transforms.ifft16x16_with_bias = (nnp_transform_2d_with_bias)nnp_ifft16x16_with_bias__psimd;
 		nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu = (nnp_transform_2d_with_bias)nnp_ifft16x16_with_bias_with_relu__psimd;
+		nnp_hwinfo.transforms.fft32x32_with_offset_and_stream = (nnp_transform_2d_with_offset)nnp_fft32x32_with_offset__psimd;
+		nnp_hwinfo.transforms.ifft32x32_with_bias = (nnp_transform_2d_with_bias)nnp_ifft32x32_with_bias__psimd;
+		nnp_hwinfo.transforms.ifft32x32_with_bias_with_relu = (nnp_transform_2d_with_bias)nnp_ifft32x32_with_bias_with_relu__psimd;
 		nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_store = (nnp_transform_2d_with_offset)nnp_iwt8x8_3x3_with_offset__psimd;
 		nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream = (nnp_transform_2d_with_offset)nnp_iwt8x8_3x3_with_offset__psimd;
 		nnp_hwinfo.transforms.kwt_f6x6_3x3 = (nnp_transform_2d_with_offset)nnp_kwt8x8_3x3__psimd;
@@ -416,6 +485,16 @@ static void init_hwinfo(void) {
 				.only_mr_x_nr = nnp_sgemm_only_4x8__psimd,
 				.upto_mr_x_nr = nnp_sgemm_upto_4x8__psimd,
 		};
+		nnp_hwinfo.sgemm_indirect = (struct sgemm_indirect) {
+			.mr = 4,
+			.nr = 4,
+			.only_mr_x_nr = nnp_sgemm_indirect_only_4x4__scalar,
+		};
+		nnp_hwinfo.q8gemm = (struct q8gemm) {
+			.mr = 4,
+			.nr = 4,
+			.only_mr_x_nr = nnp_q8gemm_only_4x4__scalar,
+		};
 		nnp_hwinfo.sxgemm = (struct sxgemm) {
 			.mr = 3,
 				.nr = 4,
@@ -459,6 +538,9 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 		nnp_hwinfo.transforms.ifft16x16_with_bias = (nnp_transform_2d_with_bias)nnp_ifft16x16_with_bias__psimd;
 		nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu = (nnp_transform_2d_with_bias)nnp_ifft16x16_with_bias_with_relu__psimd;
+		nnp_hwinfo.transforms.fft32x32_with_offset_and_stream = (nnp_transform_2d_with_offset)nnp_fft32x32_with_offset__psimd;
+		nnp_hwinfo.transforms.ifft32x32_with_bias = (nnp_transform_2d_with_bias)nnp_ifft32x32_with_bias__psimd;
+		nnp_hwinfo.transforms.ifft32x32_with_bias_with_relu = (nnp_transform_2d_with_bias)nnp_ifft32x32_with_bias_with_relu__psimd;
 		nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_store = (nnp_transform_2d_with_offset)nnp_iwt8x8_3x3_with_offset__neon;
 		nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream = (nnp_transform_2d_with_offset)nnp_iwt8x8_3x3_with_offset__neon;
 		nnp_hwinfo.transforms.kwt_f6x6_3x3 = (nnp_transform_2d_with_offset)nnp_kwt8x8_3x3__neon;
@@ -507,6 +589,16 @@ static void init_hwinfo(void) {
 #endif
 			.upto_mr_x_nr = nnp_sgemm_upto_6x8__neon,
 		};
+		nnp_hwinfo.sgemm_indirect = (struct sgemm_indirect) {
+			.mr = 4,
+			.nr = 4,
+			.only_mr_x_nr = nnp_sgemm_indirect_only_4x4__scalar,
+		};
+		nnp_hwinfo.q8gemm = (struct q8gemm) {
+			.mr = 4,
+			.nr = 4,
+			.only_mr_x_nr = nnp_q8gemm_only_4x4__scalar,
+		};
 		nnp_hwinfo.sxgemm = (struct sxgemm) {
 			.mr = 3,
 			.nr = 3,
@@ -585,6 +677,9 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 		nnp_hwinfo.transforms.ifft16x16_with_bias = (nnp_transform_2d_with_bias)nnp_ifft16x16_with_bias__scalar;
 		nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu = (nnp_transform_2d_with_bias)nnp_ifft16x16_with_bias_with_relu__scalar;
+		nnp_hwinfo.transforms.fft32x32_with_offset_and_stream = (nnp_transform_2d_with_offset)nnp_fft32x32_with_offset__scalar;
+		nnp_hwinfo.transforms.ifft32x32_with_bias = (nnp_transform_2d_with_bias)nnp_ifft32x32_with_bias__scalar;
+		nnp_hwinfo.transforms.ifft32x32_with_bias_with_relu = (nnp_transform_2d_with_bias)nnp_ifft32x32_with_bias_with_relu__scalar;
 		nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_store = (nnp_transform_2d_with_offset)nnp_iwt8x8_3x3_with_offset__scalar;
 		nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream = (nnp_transform_2d_with_offset)nnp_iwt8x8_3x3_with_offset__scalar;
 		nnp_hwinfo.transforms.kwt_f6x6_3x3 = (nnp_transform_2d_with_offset)nnp_kwt8x8_3x3__scalar;
@@ -621,6 +716,16 @@ static void init_hwinfo(void) {
 				.only_mr_x_nr = nnp_sgemm_only_4x3__scalar,
 				.upto_mr_x_nr = nnp_sgemm_upto_4x3__scalar,
 		};
+		nnp_hwinfo.sgemm_indirect = (struct sgemm_indirect) {
+			.mr = 4,
+			.nr = 4,
+			.only_mr_x_nr = nnp_sgemm_indirect_only_4x4__scalar,
+		};
+		nnp_hwinfo.q8gemm = (struct q8gemm) {
+			.mr = 4,
+			.nr = 4,
+			.only_mr_x_nr = nnp_q8gemm_only_4x4__scalar,
+		};
 		nnp_hwinfo.sxgemm = (struct sxgemm) {
 			.mr = 4,
 				.nr = 3,
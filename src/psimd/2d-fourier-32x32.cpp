@@ -0,0 +1,80 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <scalar/fft/fft32x32.h>
+
+#include <nnpack/utils.h>
+#include <nnpack/activations.h>
+
+#ifdef __cplusplus 
+extern "C" {
+#endif
+
+#define BLOCK_SIZE 32
+/* Tuples hold 4 complex numbers, as in the psimd and NEON tuple GEMM micro-kernels */
+#define TUPLE_WIDTH 4
+
+
+void nnp_fft32x32_with_offset__psimd(
+	const float* data,
+	float* transform,
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	float slot_real[SCALAR_FFT32X32_SLOTS], slot_imag[SCALAR_FFT32X32_SLOTS];
+	scalar_fft32x32_forward(data, data_stride, row_count, column_count, row_offset, column_offset, slot_real, slot_imag);
+	scalar_fft32x32_store_tuples(slot_real, slot_imag, transform, transform_stride, TUPLE_WIDTH);
+}
+
+void nnp_ifft32x32_with_bias__psimd(
+	const float* transform,
+	float* data,
+	const float* bias,
+	size_t transform_stride, size_t data_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	float slot_real[SCALAR_FFT32X32_SLOTS], slot_imag[SCALAR_FFT32X32_SLOTS];
+	scalar_fft32x32_load_tuples(transform, transform_stride, TUPLE_WIDTH, slot_real, slot_imag);
+	slot_real[0] += (*bias) * (float) (BLOCK_SIZE * BLOCK_SIZE);
+
+	float block[BLOCK_SIZE][BLOCK_SIZE];
+	scalar_fft32x32_inverse(slot_real, slot_imag, block);
+
+	for (uint32_t row = 0; row < row_count; row++) {
+		for (uint32_t column = 0; column < column_count; column++) {
+			data[row * data_stride + column] = block[row][column];
+		}
+	}
+}
+
+void nnp_ifft32x32_with_bias_with_relu__psimd(
+	const float* transform,
+	float* data,
+	const float* bias,
+	size_t transform_stride, size_t data_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	float slot_real[SCALAR_FFT32X32_SLOTS], slot_imag[SCALAR_FFT32X32_SLOTS];
+	scalar_fft32x32_load_tuples(transform, transform_stride, TUPLE_WIDTH, slot_real, slot_imag);
+	slot_real[0] += (*bias) * (float) (BLOCK_SIZE * BLOCK_SIZE);
+
+	float block[BLOCK_SIZE][BLOCK_SIZE];
+	scalar_fft32x32_inverse(slot_real, slot_imag, block);
+
+	for (uint32_t row = 0; row < row_count; row++) {
+		for (uint32_t column = 0; column < column_count; column++) {
+			data[row * data_stride + column] = relu(block[row][column], 0.0f);
+		}
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
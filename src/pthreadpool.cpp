@@ -11,6 +11,31 @@
 	#include <future>
 	#include <thread>
 
+	#if defined(__linux__)
+		#include <pthread.h>
+		#include <sched.h>
+	#endif
+
+	/* Number of logical processors the calling thread may run on. Threads it spawns inherit its affinity. */
+	static size_t available_threads()
+	{
+	#if defined(__linux__)
+		cpu_set_t cpu_set;
+		if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0 && CPU_COUNT(&cpu_set) > 0)
+			return static_cast<size_t>(CPU_COUNT(&cpu_set));
+	#endif
+		const unsigned int hardware_threads = std::thread::hardware_concurrency();
+		return hardware_threads > 0 ? hardware_threads : 1;
+	}
+
+	/* Set by pthreadpool_set_threads_count; 0 means one worker per available logical processor */
+	static size_t threads_count_override = 0;
+
+	static size_t workers_count()
+	{
+		return threads_count_override != 0 ? threads_count_override : available_threads();
+	}
+
 	struct blocked_range 
 	{
 	public:
@@ -38,7 +63,7 @@
 	void parallel_for(const size_t& begin, const size_t& end, const Func &f) 
 	{
 		assert(end >= begin);
-		const size_t nthreads = std::thread::hardware_concurrency();
+		const size_t nthreads = workers_count();
 		size_t blockSize = (end - begin) / nthreads;
 		if (blockSize * nthreads < end - begin) blockSize++;
 
@@ -101,13 +126,81 @@
 	}
 #endif
 
+#include <cpuinfo.h>
+
 #include <nnpack/pthreadpool.h>
+#include <nnpack/hwinfo.h>
 #include <nnpack/utils.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+	size_t pthreadpool_get_threads_count(void)
+	{
+#if defined(_MSC_VER)
+		return (size_t)omp_get_max_threads();
+#else
+		return workers_count();
+#endif
+	}
+
+	void pthreadpool_set_threads_count(const size_t threads_count)
+	{
+#if defined(_MSC_VER)
+		omp_set_num_threads(threads_count != 0 ? (int)threads_count : omp_get_num_procs());
+#else
+		threads_count_override = threads_count;
+#endif
+	}
+
+#if defined(__linux__)
+	static void bind_thread_to_package(const size_t package)
+	{
+		const struct package_info* package_info = &nnp_hwinfo.packages[package];
+
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		for (uint32_t i = 0; i < package_info->processor_count; i++)
+		{
+			const struct cpuinfo_processor* processor = cpuinfo_get_processor(package_info->processor_start + i);
+			if (processor != NULL && processor->linux_id >= 0 && processor->linux_id < CPU_SETSIZE)
+				CPU_SET(processor->linux_id, &cpu_set);
+		}
+
+		/* Binding is a locality hint: on failure the thread keeps running where it is allowed to */
+		if (CPU_COUNT(&cpu_set) != 0)
+			pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+	}
+#endif
+
+	void pthreadpool_compute_packages(
+		pthreadpool_function_1d_t function,
+		void* argument,
+		const size_t packages_count)
+	{
+#if defined(_MSC_VER)
+		/* OpenMP threads persist across calls and are not re-bound, so packages are processed one after another */
+		for (size_t package = 0; package < packages_count; package++)
+			function(argument, package);
+#else
+		std::vector<std::future<void>> futures;
+		for (size_t package = 0; package < packages_count; package++)
+		{
+			futures.push_back(std::async(std::launch::async, [=]
+			{
+#if defined(__linux__)
+				bind_thread_to_package(package);
+#endif
+				function(argument, package);
+			}));
+		}
+
+		for (auto& future : futures)
+			future.wait();
+#endif
+	}
+
 	void pthreadpool_compute_1d(
 		pthreadpool_function_1d_t function,
 		void* argument,
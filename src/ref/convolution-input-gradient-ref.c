@@ -10,6 +10,7 @@ struct convolution_input_gradient_context
 	const struct nnp_padding input_padding;
 	const struct nnp_size kernel_size;
 	const struct nnp_size output_size;
+	const struct nnp_size output_subsampling;
 	const float* grad_output_pointer;
 	const float* kernel_pointer;
 	float* grad_input_pointer;
@@ -25,7 +26,8 @@ static void compute_convolution_input_gradient(
 	const struct nnp_size input_size       = context->input_size;
 	const struct nnp_padding input_padding = context->input_padding;
 	const struct nnp_size kernel_size      = context->kernel_size;
-	const struct nnp_size output_size      = context->output_size;
+	const struct nnp_size output_size        = context->output_size;
+	const struct nnp_size output_subsampling = context->output_subsampling;
 
 	const float* grad_output = context->grad_output_pointer;
 	const float* kernel = context->kernel_pointer;
@@ -39,12 +41,14 @@ static void compute_convolution_input_gradient(
 			for (size_t output_channel = 0; output_channel < output_channels; output_channel++) 
 				for (size_t i = 0; i < kernel_size.height; i++) 
 				{
-					const size_t s = y - i + input_padding.top;
-					if (s < output_size.height) 
+					const size_t s_full = y - i + input_padding.top;
+					const size_t s = s_full / output_subsampling.height;
+					if (s_full % output_subsampling.height == 0 && s < output_size.height) 
 						for (size_t j = 0; j < kernel_size.width; j++) 
 						{
-							const size_t t = x - j + input_padding.left;
-							if (t < output_size.width) 
+							const size_t t_full = x - j + input_padding.left;
+							const size_t t = t_full / output_subsampling.width;
+							if (t_full % output_subsampling.width == 0 && t < output_size.width) 
 								v += grad_output[(sample * output_channels * output_size.width * output_size.height) + (output_channel * output_size.width * output_size.height) + (s * output_size.width) + t] * kernel[(output_channel * input_channels * kernel_size.width * kernel_size.height) + (input_channel * kernel_size.width * kernel_size.height) + (i * kernel_size.width) +j];
 						}
 				}
@@ -61,14 +65,15 @@ void nnp_convolution_input_gradient__reference(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* grad_output_pointer,
 	const float* kernel_pointer,
 	float* grad_input_pointer)
 {
 	const struct nnp_size output_size = 
 	{ 
-		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
-		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
 	};
 
 	struct convolution_input_gradient_context convolution_input_gradient_context = 
@@ -79,6 +84,7 @@ void nnp_convolution_input_gradient__reference(
 		.input_padding = input_padding,
 		.kernel_size = kernel_size,
 		.output_size = output_size,
+		.output_subsampling = output_subsampling,
 		.grad_output_pointer = grad_output_pointer,
 		.kernel_pointer = kernel_pointer,
 		.grad_input_pointer = grad_input_pointer
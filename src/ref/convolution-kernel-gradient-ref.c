@@ -10,6 +10,7 @@ struct convolution_kernel_gradient_context
 	const struct nnp_padding input_padding;
 	const struct nnp_size kernel_size;
 	const struct nnp_size output_size;
+	const struct nnp_size output_subsampling;
 	const float* input_pointer;
 	const float* grad_output_pointer;
 	float* grad_kernel_pointer;
@@ -26,7 +27,8 @@ static void compute_convolution_kernel_gradient(
 	const struct nnp_size input_size       = context->input_size;
 	const struct nnp_padding input_padding = context->input_padding;
 	const struct nnp_size kernel_size      = context->kernel_size;
-	const struct nnp_size output_size      = context->output_size;
+	const struct nnp_size output_size        = context->output_size;
+	const struct nnp_size output_subsampling = context->output_subsampling;
 
 	const float* input = context->input_pointer;
 	const float* grad_output = context->grad_output_pointer;
@@ -39,11 +41,11 @@ static void compute_convolution_kernel_gradient(
 			for (size_t sample = 0; sample < batch_size; sample++) 
 				for (size_t i = 0; i < output_size.height; i++) 
 				{
-					const size_t s = y + i - input_padding.top;
+					const size_t s = y + i * output_subsampling.height - input_padding.top;
 					if (s < input_size.height) 
 						for (size_t j = 0; j < output_size.width; j++) 
 						{
-							const size_t t = x + j - input_padding.left;
+							const size_t t = x + j * output_subsampling.width - input_padding.left;
 							if (t < input_size.width) 
 								grad_kernel_yx += input[(sample * input_channels * input_size.width * input_size.height) + (input_channel  * input_size.width * input_size.height) + (s * input_size.width) + t] * grad_output[(sample * output_channels * output_size.width * output_size.height) + (output_channel  * output_size.width * output_size.height) + (i * output_size.width) + j];
 						}
@@ -60,14 +62,15 @@ void nnp_convolution_kernel_gradient__reference(
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* grad_output,
 	float* grad_kernel)
 {
 	const struct nnp_size output_size = 
 	{
-		.width = input_padding.left + input_size.width + input_padding.right - kernel_size.width + 1,
-		.height = input_padding.top + input_size.height + input_padding.bottom - kernel_size.height + 1
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
 	};
 
 	struct convolution_kernel_gradient_context convolution_kernel_gradient_context = 
@@ -79,6 +82,7 @@ void nnp_convolution_kernel_gradient__reference(
 		.input_padding = input_padding,
 		.kernel_size = kernel_size,
 		.output_size = output_size,
+		.output_subsampling = output_subsampling,
 		.input_pointer = input,
 		.grad_output_pointer = grad_output,
 		.grad_kernel_pointer = grad_kernel,
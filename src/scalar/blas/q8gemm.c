@@ -0,0 +1,40 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/macros.h>
+
+
+/*
+ * A and B are packed as pairs of int16 elements along the reduction dimension (k counts pairs),
+ * and zero-padded to full 4x4 tiles.
+ */
+void nnp_q8gemm_only_4x4__scalar(size_t k, size_t update, const int16_t* a, const int16_t* b, int32_t* c, size_t row_stride_c) {
+	int32_t acc[4][4] = { { 0 } };
+	do {
+		for (size_t m = 0; m < 4; m++) {
+			const int32_t a0 = (int32_t) a[m * 2];
+			const int32_t a1 = (int32_t) a[m * 2 + 1];
+			for (size_t n = 0; n < 4; n++) {
+				acc[m][n] += a0 * (int32_t) b[n * 2] + a1 * (int32_t) b[n * 2 + 1];
+			}
+		}
+		a += 4 * 2;
+		b += 4 * 2;
+	} while (--k);
+
+	if (update) {
+		for (size_t m = 0; m < 4; m++) {
+			for (size_t n = 0; n < 4; n++) {
+				c[n] += acc[m][n];
+			}
+			c += row_stride_c;
+		}
+	} else {
+		for (size_t m = 0; m < 4; m++) {
+			for (size_t n = 0; n < 4; n++) {
+				c[n] = acc[m][n];
+			}
+			c += row_stride_c;
+		}
+	}
+}
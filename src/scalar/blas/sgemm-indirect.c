@@ -0,0 +1,51 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/macros.h>
+
+
+/*
+ * Indirect GEMM: B is not packed, but read from the input image through an indirection buffer.
+ * indirection[e * 4 + n] is the offset of the input pixel for kernel element e and output pixel n within a channel,
+ * or a negative value if the pixel is in padding and reads as zero.
+ * The reduction runs over k channels of kernel_elements elements each; b advances by channel_stride per channel.
+ */
+void nnp_sgemm_indirect_only_4x4__scalar(size_t k, size_t update, const float* a, const float* b, const int32_t* indirection, size_t kernel_elements, size_t channel_stride, float* c, size_t row_stride_c) {
+	float acc[4][4] = { { 0.0f } };
+	do {
+		const int32_t* indirection_e = indirection;
+		for (size_t e = 0; e < kernel_elements; e++) {
+			float b_n[4];
+			for (size_t n = 0; n < 4; n++) {
+				const int32_t offset = indirection_e[n];
+				b_n[n] = (offset >= 0 ? b[offset] : 0.0f);
+			}
+			indirection_e += 4;
+
+			for (size_t m = 0; m < 4; m++) {
+				const float a_m = a[m];
+				for (size_t n = 0; n < 4; n++) {
+					acc[m][n] += a_m * b_n[n];
+				}
+			}
+			a += 4;
+		}
+		b += channel_stride;
+	} while (--k);
+
+	if (update) {
+		for (size_t m = 0; m < 4; m++) {
+			for (size_t n = 0; n < 4; n++) {
+				c[n] += acc[m][n];
+			}
+			c += row_stride_c;
+		}
+	} else {
+		for (size_t m = 0; m < 4; m++) {
+			for (size_t n = 0; n < 4; n++) {
+				c[n] = acc[m][n];
+			}
+			c += row_stride_c;
+		}
+	}
+}
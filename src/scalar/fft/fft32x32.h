@@ -0,0 +1,229 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+ * 2D real-to-complex FFT on 32x32 blocks.
+ *
+ * The transform is computed on whole rows of the block at once, so the inner loops run over 16 or 17 independent
+ * sequences and vectorize on any backend. Its result is 512 complex slots:
+ *   slot 0:         (X[0][0], X[0][16]), both real
+ *   slot 1:         (X[16][0], X[16][16]), both real
+ *   slots 2-16:     X[0][1..15]
+ *   slots 17-31:    X[16][1..15]
+ *   slots 32k1+k2:  X[k1][k2] for k1 = 1..15, k2 = 0..31
+ * The remaining frequencies follow from Hermitian symmetry. Slots are grouped into tuples of tuple_width real parts
+ * followed by tuple_width imaginary parts, so that the two real pairs occupy the first two lanes of the first tuple,
+ * which is the layout the s4cX/s2 tuple GEMM micro-kernels expect.
+ */
+
+#define SCALAR_FFT32X32_SLOTS 512
+
+static const float scalar_fft32_cos[16] = {
+	 1.000000000f,  0.980785280f,  0.923879533f,  0.831469612f,  0.707106781f,  0.555570233f,  0.382683432f,  0.195090322f,
+	 0.000000000f, -0.195090322f, -0.382683432f, -0.555570233f, -0.707106781f, -0.831469612f, -0.923879533f, -0.980785280f,
+};
+
+static const float scalar_fft32_sin[16] = {
+	0.000000000f, 0.195090322f, 0.382683432f, 0.555570233f, 0.707106781f, 0.831469612f, 0.923879533f, 0.980785280f,
+	1.000000000f, 0.980785280f, 0.923879533f, 0.831469612f, 0.707106781f, 0.555570233f, 0.382683432f, 0.195090322f,
+};
+
+static const uint8_t scalar_fft32_bitreverse[32] = {
+	0, 16,  8, 24, 4, 20, 12, 28, 2, 18, 10, 26, 6, 22, 14, 30,
+	1, 17,  9, 25, 5, 21, 13, 29, 3, 19, 11, 27, 7, 23, 15, 31,
+};
+
+/*
+ * In-place radix-2 FFT of length 32 along the first index of lanes independent sequences:
+ * element n of sequence l is (real[n * stride + l], imag[n * stride + l]).
+ * sign is -1.0f for the forward and +1.0f for the (unnormalized) inverse transform.
+ */
+static inline void scalar_fft32_soa_lanes(float real[], float imag[], size_t stride, size_t lanes, float sign) {
+	for (uint32_t n = 0; n < 32; n++) {
+		const uint32_t m = scalar_fft32_bitreverse[n];
+		if (m > n) {
+			float* real_n = real + n * stride;
+			float* imag_n = imag + n * stride;
+			float* real_m = real + m * stride;
+			float* imag_m = imag + m * stride;
+			for (size_t l = 0; l < lanes; l++) {
+				const float real_t = real_n[l];
+				const float imag_t = imag_n[l];
+				real_n[l] = real_m[l];
+				imag_n[l] = imag_m[l];
+				real_m[l] = real_t;
+				imag_m[l] = imag_t;
+			}
+		}
+	}
+
+	for (uint32_t half = 1; half < 32; half *= 2) {
+		const uint32_t twiddle_step = 16 / half;
+		for (uint32_t start = 0; start < 32; start += 2 * half) {
+			for (uint32_t j = 0; j < half; j++) {
+				const float w_real = scalar_fft32_cos[j * twiddle_step];
+				const float w_imag = sign * scalar_fft32_sin[j * twiddle_step];
+				float* real_a = real + (start + j) * stride;
+				float* imag_a = imag + (start + j) * stride;
+				float* real_b = real + (start + j + half) * stride;
+				float* imag_b = imag + (start + j + half) * stride;
+				for (size_t l = 0; l < lanes; l++) {
+					const float real_t = real_b[l] * w_real - imag_b[l] * w_imag;
+					const float imag_t = real_b[l] * w_imag + imag_b[l] * w_real;
+					real_b[l] = real_a[l] - real_t;
+					imag_b[l] = imag_a[l] - imag_t;
+					real_a[l] += real_t;
+					imag_a[l] += imag_t;
+				}
+			}
+		}
+	}
+}
+
+static inline void scalar_fft32x32_forward(
+	const float* data, size_t data_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset,
+	float slot_real[SCALAR_FFT32X32_SLOTS], float slot_imag[SCALAR_FFT32X32_SLOTS])
+{
+	/* Columns c and c + 16 are transformed together as the real and imaginary parts of one complex sequence */
+	float z_real[32][16] = { { 0.0f } };
+	float z_imag[32][16] = { { 0.0f } };
+	for (uint32_t row = 0; row < row_count; row++) {
+		for (uint32_t column = column_offset; column < column_offset + column_count; column++) {
+			const float value = data[row * data_stride + (column - column_offset)];
+			if (column < 16) {
+				z_real[row_offset + row][column] = value;
+			} else {
+				z_imag[row_offset + row][column - 16] = value;
+			}
+		}
+	}
+	scalar_fft32_soa_lanes(&z_real[0][0], &z_imag[0][0], 16, 16, -1.0f);
+
+	/* Separate the column spectra for k1 = 0..16 and transpose them, so the row FFTs run over k1 as lanes */
+	float f_real[32][17];
+	float f_imag[32][17];
+	for (uint32_t k = 0; k <= 16; k++) {
+		const uint32_t k_neg = (32 - k) % 32;
+		for (uint32_t c = 0; c < 16; c++) {
+			f_real[c][k]      = 0.5f * (z_real[k][c] + z_real[k_neg][c]);
+			f_imag[c][k]      = 0.5f * (z_imag[k][c] - z_imag[k_neg][c]);
+			f_real[c + 16][k] = 0.5f * (z_imag[k][c] + z_imag[k_neg][c]);
+			f_imag[c + 16][k] = 0.5f * (z_real[k_neg][c] - z_real[k][c]);
+		}
+	}
+	scalar_fft32_soa_lanes(&f_real[0][0], &f_imag[0][0], 17, 17, -1.0f);
+
+	/* f[k2][k1] now holds X[k1][k2] */
+	slot_real[0] = f_real[0][0];
+	slot_imag[0] = f_real[16][0];
+	slot_real[1] = f_real[0][16];
+	slot_imag[1] = f_real[16][16];
+	for (uint32_t k2 = 1; k2 < 16; k2++) {
+		slot_real[1 + k2] = f_real[k2][0];
+		slot_imag[1 + k2] = f_imag[k2][0];
+		slot_real[16 + k2] = f_real[k2][16];
+		slot_imag[16 + k2] = f_imag[k2][16];
+	}
+	for (uint32_t k1 = 1; k1 < 16; k1++) {
+		for (uint32_t k2 = 0; k2 < 32; k2++) {
+			slot_real[32 * k1 + k2] = f_real[k2][k1];
+			slot_imag[32 * k1 + k2] = f_imag[k2][k1];
+		}
+	}
+}
+
+/* Inverse of scalar_fft32x32_forward, including the 1/1024 normalization */
+static inline void scalar_fft32x32_inverse(
+	const float slot_real[SCALAR_FFT32X32_SLOTS], const float slot_imag[SCALAR_FFT32X32_SLOTS],
+	float block[32][32])
+{
+	/* f[k2][k1] = X[k1][k2] for k1 = 0..16; rows k1 = 0 and k1 = 16 are extended by Hermitian symmetry */
+	float f_real[32][17];
+	float f_imag[32][17];
+	f_real[0][0] = slot_real[0];
+	f_imag[0][0] = 0.0f;
+	f_real[16][0] = slot_imag[0];
+	f_imag[16][0] = 0.0f;
+	f_real[0][16] = slot_real[1];
+	f_imag[0][16] = 0.0f;
+	f_real[16][16] = slot_imag[1];
+	f_imag[16][16] = 0.0f;
+	for (uint32_t k2 = 1; k2 < 16; k2++) {
+		f_real[k2][0] = slot_real[1 + k2];
+		f_imag[k2][0] = slot_imag[1 + k2];
+		f_real[32 - k2][0] = slot_real[1 + k2];
+		f_imag[32 - k2][0] = -slot_imag[1 + k2];
+		f_real[k2][16] = slot_real[16 + k2];
+		f_imag[k2][16] = slot_imag[16 + k2];
+		f_real[32 - k2][16] = slot_real[16 + k2];
+		f_imag[32 - k2][16] = -slot_imag[16 + k2];
+	}
+	for (uint32_t k1 = 1; k1 < 16; k1++) {
+		for (uint32_t k2 = 0; k2 < 32; k2++) {
+			f_real[k2][k1] = slot_real[32 * k1 + k2];
+			f_imag[k2][k1] = slot_imag[32 * k1 + k2];
+		}
+	}
+	scalar_fft32_soa_lanes(&f_real[0][0], &f_imag[0][0], 17, 17, +1.0f);
+
+	/*
+	 * f[c][k1] now holds the column spectrum Z_c[k1] for k1 = 0..16.
+	 * Columns c and c + 16 are real, so they are recovered together from the inverse FFT of Z_c + i Z_(c+16).
+	 */
+	float z_real[32][16];
+	float z_imag[32][16];
+	for (uint32_t k = 0; k <= 16; k++) {
+		for (uint32_t c = 0; c < 16; c++) {
+			const float real_lo = f_real[c][k];
+			const float imag_lo = f_imag[c][k];
+			const float real_hi = f_real[c + 16][k];
+			const float imag_hi = f_imag[c + 16][k];
+			z_real[k][c] = real_lo - imag_hi;
+			z_imag[k][c] = imag_lo + real_hi;
+			if (k != 0 && k != 16) {
+				z_real[32 - k][c] = real_lo + imag_hi;
+				z_imag[32 - k][c] = real_hi - imag_lo;
+			}
+		}
+	}
+	scalar_fft32_soa_lanes(&z_real[0][0], &z_imag[0][0], 16, 16, +1.0f);
+
+	const float scale = 1.0f / 1024.0f;
+	for (uint32_t row = 0; row < 32; row++) {
+		for (uint32_t c = 0; c < 16; c++) {
+			block[row][c] = z_real[row][c] * scale;
+			block[row][c + 16] = z_imag[row][c] * scale;
+		}
+	}
+}
+
+static inline void scalar_fft32x32_store_tuples(
+	const float slot_real[SCALAR_FFT32X32_SLOTS], const float slot_imag[SCALAR_FFT32X32_SLOTS],
+	float* transform, size_t transform_stride, uint32_t tuple_width)
+{
+	for (uint32_t slot = 0; slot < SCALAR_FFT32X32_SLOTS; slot += tuple_width) {
+		for (uint32_t lane = 0; lane < tuple_width; lane++) {
+			transform[lane] = slot_real[slot + lane];
+			transform[tuple_width + lane] = slot_imag[slot + lane];
+		}
+		transform += transform_stride;
+	}
+}
+
+static inline void scalar_fft32x32_load_tuples(
+	const float* transform, size_t transform_stride, uint32_t tuple_width,
+	float slot_real[SCALAR_FFT32X32_SLOTS], float slot_imag[SCALAR_FFT32X32_SLOTS])
+{
+	for (uint32_t slot = 0; slot < SCALAR_FFT32X32_SLOTS; slot += tuple_width) {
+		for (uint32_t lane = 0; lane < tuple_width; lane++) {
+			slot_real[slot + lane] = transform[lane];
+			slot_imag[slot + lane] = transform[tuple_width + lane];
+		}
+		transform += transform_stride;
+	}
+}
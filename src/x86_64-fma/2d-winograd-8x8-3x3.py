@@ -61,7 +61,8 @@ for post_operation in ["store", "stream"]:
 
 
 for reverse_kernel in [False, True]:
-    for post_operation in ["store", "stream"]:
+    # "fp16" stores the transformed kernel in half precision for nnp_s8gemm_fp16b_*
+    for post_operation in ["store", "stream"] + ([] if reverse_kernel else ["fp16"]):
         arg_g_pointer = Argument(ptr(const_float_), name="d_pointer")
         arg_wg_pointer = Argument(ptr(float_), name="wd_pointer")
         arg_g_stride = Argument(size_t, name="d_stride")
@@ -72,9 +73,13 @@ for reverse_kernel in [False, True]:
         arg_column_offset = Argument(uint32_t, name="column_offset")
 
         kwt_arguments = (arg_g_pointer, arg_wg_pointer, arg_g_stride, arg_wg_stride, arg_row_count, arg_column_count, arg_row_offset, arg_column_offset)
-        with Function("nnp_kwt8x8_3{reverse}x3{reverse}_and_{post_operation}__avx2".format(
-                reverse="R" if reverse_kernel else "", post_operation=post_operation),
-            kwt_arguments, target=uarch.default + isa.fma3 + isa.avx2):
+        if post_operation == "fp16":
+            kwt_name, kwt_isa = "nnp_kwt8x8_3x3_fp16__avx2", isa.fma3 + isa.avx2 + isa.f16c
+        else:
+            kwt_name = "nnp_kwt8x8_3{reverse}x3{reverse}_and_{post_operation}__avx2".format(
+                reverse="R" if reverse_kernel else "", post_operation=post_operation)
+            kwt_isa = isa.fma3 + isa.avx2
+        with Function(kwt_name, kwt_arguments, target=uarch.default + kwt_isa):
 
             reg_g = GeneralPurposeRegister64()
             LOAD.ARGUMENT(reg_g, arg_g_pointer)
@@ -138,9 +143,13 @@ for reverse_kernel in [False, True]:
             VMULPS(ymm_wg_rows[6], ymm_wg_rows[6], ymm_row56_scale)
 
             # Write output with stride
-            VSTOREPS = {"store": VMOVAPS, "stream": VMOVNTPS}[post_operation]
             for ymm_wg_row in ymm_wg_rows:
-                VSTOREPS([reg_wg], ymm_wg_row)
+                if post_operation == "fp16":
+                    # Round to nearest-even
+                    VCVTPS2PH([reg_wg], ymm_wg_row, 0)
+                else:
+                    VSTOREPS = {"store": VMOVAPS, "stream": VMOVNTPS}[post_operation]
+                    VSTOREPS([reg_wg], ymm_wg_row)
                 if ymm_wg_row is not ymm_wg_rows[-1]:
                     ADD(reg_wg, reg_stride_wg)
 
@@ -0,0 +1,87 @@
+from __future__ import absolute_import
+from __future__ import division
+
+# Quantized GEMM micro-kernel: C[mr][nr] (int32) = sum over k of A[k][mr] * B[k][nr]
+# A (kernel) and B (input) are packed as pairs of int16 along the reduction dimension, so that VPMADDWD computes
+# a[2k] * b[2k] + a[2k+1] * b[2k+1] in one 32-bit lane. Operands are widened to int16 (and the input zero point is
+# subtracted) during packing, which keeps all products exact, unlike VPMADDUBSW which saturates to int16.
+# Both operands are zero-padded to full mr x nr tiles, so only the full-tile variant is needed.
+mr, nr = 4, 16
+
+arg_k = Argument(size_t, "k")
+arg_update = Argument(size_t, "update")
+arg_a = Argument(ptr(const_int16_t), "a")
+arg_b = Argument(ptr(const_int16_t), "b")
+arg_c = Argument(ptr(int32_t), "c")
+arg_row_stride = Argument(size_t, "row_stride_c")
+with Function("nnp_q8gemm_only_{mr}x{nr}__avx2".format(mr=mr, nr=nr),
+	(arg_k, arg_update, arg_a, arg_b, arg_c, arg_row_stride),
+	target=uarch.default + isa.avx2):
+
+	reg_k = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_k, arg_k)
+
+	reg_update = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_update, arg_update)
+
+	reg_a = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_a, arg_a)
+
+	reg_b = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_b, arg_b)
+
+	reg_c = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_c, arg_c)
+
+	reg_row_stride = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_row_stride, arg_row_stride)
+	SHL(reg_row_stride, 2)
+
+	# Each YMM register holds 8 int32 accumulators (or 8 pairs of int16 inputs)
+	n_registers = nr // 8
+	ymm_c = [[YMMRegister() for n in range(n_registers)] for m in range(mr)]
+	VZEROALL()
+
+	ymm_a_m = YMMRegister()
+	ymm_b = [YMMRegister() for n in range(n_registers)]
+	ymm_product = YMMRegister()
+	with Loop() as loop:
+		for n in range(n_registers):
+			VMOVDQU(ymm_b[n], [reg_b + n * YMMRegister.size])
+		SUB(reg_b, -n_registers * YMMRegister.size)
+
+		for m in range(mr):
+			# Broadcast a pair of int16 elements of A
+			VPBROADCASTD(ymm_a_m, [reg_a + m * 4])
+			for n in range(n_registers):
+				VPMADDWD(ymm_product, ymm_a_m, ymm_b[n])
+				VPADDD(ymm_c[m][n], ymm_c[m][n], ymm_product)
+		SUB(reg_a, -mr * 4)
+
+		DEC(reg_k)
+		JNZ(loop.begin)
+
+	store_c = Block()
+
+	# Check if we need to update C or overwrite it
+	TEST(reg_update, reg_update)
+	JZ(store_c.begin)
+
+	with Block() as update_c:
+		for m in range(mr):
+			for n in range(n_registers):
+				VPADDD(ymm_c[m][n], ymm_c[m][n], [reg_c + n * YMMRegister.size])
+				VMOVDQU([reg_c + n * YMMRegister.size], ymm_c[m][n])
+			if m + 1 != mr:
+				ADD(reg_c, reg_row_stride)
+
+	RETURN()
+
+	with store_c:
+		for m in range(mr):
+			for n in range(n_registers):
+				VMOVDQU([reg_c + n * YMMRegister.size], ymm_c[m][n])
+			if m + 1 != mr:
+				ADD(reg_c, reg_row_stride)
+
+	RETURN()
@@ -0,0 +1,110 @@
+from __future__ import absolute_import
+from __future__ import division
+
+# Indirect GEMM micro-kernel: B is read from the input image through an indirection buffer of int32 pixel offsets.
+# indirection[e * nr + n] is the offset of the input pixel for kernel element e and output pixel n within a channel,
+# or a negative value for pixels in padding. Padding lanes are masked off in VGATHERDPS and read as zero, so no zero
+# row needs to be materialized. The reduction runs over k channels of kernel_elements elements each.
+simd_width = YMMRegister.size // float_.size
+mr = 4
+nr = 2 * simd_width
+
+arg_k = Argument(size_t, "k")
+arg_update = Argument(size_t, "update")
+arg_a = Argument(ptr(const_float_), "a")
+arg_b = Argument(ptr(const_float_), "b")
+arg_indirection = Argument(ptr(const_int32_t), "indirection")
+arg_kernel_elements = Argument(size_t, "kernel_elements")
+arg_channel_stride = Argument(size_t, "channel_stride")
+arg_c = Argument(ptr(float_), "c")
+arg_row_stride = Argument(size_t, "row_stride_c")
+with Function("nnp_sgemm_indirect_only_{mr}x{nr}__fma3".format(mr=mr, nr=nr),
+	(arg_k, arg_update, arg_a, arg_b, arg_indirection, arg_kernel_elements, arg_channel_stride, arg_c, arg_row_stride),
+	target=uarch.default + isa.fma3 + isa.avx2):
+
+	reg_k = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_k, arg_k)
+
+	reg_a = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_a, arg_a)
+
+	reg_b = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_b, arg_b)
+
+	reg_channel_stride = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_channel_stride, arg_channel_stride)
+	SHL(reg_channel_stride, 2)
+
+	ymm_c = [[YMMRegister() for n in range(0, nr, simd_width)] for m in range(mr)]
+	VZEROALL()
+
+	# All-ones: lanes with offset > -1 are gathered
+	ymm_minus_one = YMMRegister()
+	VPCMPEQD(ymm_minus_one, ymm_minus_one, ymm_minus_one)
+
+	ymm_index = YMMRegister()
+	ymm_mask = YMMRegister()
+	ymm_b = [YMMRegister() for n in range(0, nr, simd_width)]
+	ymm_a_m = YMMRegister()
+	with Loop() as channel_loop:
+		reg_indirection = GeneralPurposeRegister64()
+		LOAD.ARGUMENT(reg_indirection, arg_indirection)
+
+		reg_e = GeneralPurposeRegister64()
+		LOAD.ARGUMENT(reg_e, arg_kernel_elements)
+
+		with Loop() as element_loop:
+			for n in range(nr // simd_width):
+				VMOVDQU(ymm_index, [reg_indirection + n * YMMRegister.size])
+				VPCMPGTD(ymm_mask, ymm_index, ymm_minus_one)
+				VXORPS(ymm_b[n], ymm_b[n], ymm_b[n])
+				VGATHERDPS(ymm_b[n], [reg_b + ymm_index * float_.size], ymm_mask)
+			ADD(reg_indirection, nr * int32_t.size)
+
+			for m in range(mr):
+				VBROADCASTSS(ymm_a_m, [reg_a + m * float_.size])
+				for n in range(nr // simd_width):
+					VFMADD231PS(ymm_c[m][n], ymm_a_m, ymm_b[n])
+			ADD(reg_a, mr * float_.size)
+
+			DEC(reg_e)
+			JNZ(element_loop.begin)
+
+		ADD(reg_b, reg_channel_stride)
+		DEC(reg_k)
+		JNZ(channel_loop.begin)
+
+	reg_c = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_c, arg_c)
+
+	reg_row_stride = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_row_stride, arg_row_stride)
+	SHL(reg_row_stride, 2)
+
+	reg_update = GeneralPurposeRegister64()
+	LOAD.ARGUMENT(reg_update, arg_update)
+
+	store_c = Block()
+
+	# Check if we need to update C or overwrite it
+	TEST(reg_update, reg_update)
+	JZ(store_c.begin)
+
+	with Block() as load_and_store_c:
+		for m in range(mr):
+			for n in range(nr // simd_width):
+				VADDPS(ymm_c[m][n], ymm_c[m][n], [reg_c + n * YMMRegister.size])
+				VMOVUPS([reg_c + n * YMMRegister.size], ymm_c[m][n])
+			if m + 1 != mr:
+				ADD(reg_c, reg_row_stride)
+
+		RETURN()
+
+	with store_c:
+		for m in range(mr):
+			for n in range(nr // simd_width):
+				VMOVUPS([reg_c + n * YMMRegister.size], ymm_c[m][n])
+			if m + 1 != mr:
+				ADD(reg_c, reg_row_stride)
+
+		RETURN()
@@ -22,6 +22,8 @@ rem "%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -
 "%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -mcpu=%proc_arch% -o "%output_dir%"\2d-winograd-8x8-3x3.obj "%source_dir%"\2d-winograd-8x8-3x3.py
 
 "%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -mcpu=%proc_arch% -o "%output_dir%"\s8gemm.obj "%source_dir%"\blas\s8gemm.py
+"%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -mcpu=%proc_arch% -o "%output_dir%"\q8gemm.obj "%source_dir%"\blas\q8gemm.py
+"%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -mcpu=%proc_arch% -o "%output_dir%"\sgemm-indirect.obj "%source_dir%"\blas\sgemm-indirect.py
 "%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -mcpu=%proc_arch% -o "%output_dir%"\c8gemm.obj "%source_dir%"\blas\c8gemm.py
 "%python_dir%"python.exe -m peachpy.x86_64 -mabi=ms -mimage-format=ms-coff -mcpu=%proc_arch% -o "%output_dir%"\s4c6gemm.obj "%source_dir%"\blas\s4c6gemm.py
 
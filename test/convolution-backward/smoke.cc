@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/convolution.h>
+
+/*
+ * Test that implementation works for a single tile of transformation
+ */
+
+TEST(FT8x8, single_tile) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, single_tile) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft16x16);
+}
+
+/*
+ * Test that the implementation handles multi-tile inputs
+ */
+
+TEST(FT8x8, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, multi_tile) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft16x16);
+}
+
+/*
+ * Test that the implementation handles implicit padding
+ */
+
+TEST(FT8x8, implicit_padding) {
+	ConvolutionTester()
+		.inputSize(11, 13)
+		.inputPadding(1, 2, 2, 1)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, implicit_padding) {
+	ConvolutionTester()
+		.inputSize(23, 25)
+		.inputPadding(2, 1, 1, 2)
+		.kernelSize(5, 5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft16x16);
+}
+
+/*
+ * Test that the implementation can handle small non-unit number of channels and batch
+ */
+
+TEST(FT8x8, few_channels) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, few_channels) {
+	ConvolutionTester()
+		.inputSize(19, 19)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft16x16);
+}
+
+/*
+ * Test that the implementation handles many channels and batches larger than cache blocks
+ */
+
+TEST(FT8x8, many_channels) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(37)
+		.inputChannels(19)
+		.outputChannels(23)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(AUTO, non_square_kernel) {
+	ConvolutionTester()
+		.inputSize(17, 20)
+		.inputPadding(1, 0, 2, 3)
+		.kernelSize(3, 5)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(4)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testBackward(nnp_convolution_algorithm_auto);
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	//setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
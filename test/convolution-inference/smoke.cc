@@ -178,6 +178,51 @@ TEST(WT8x8_FP16_PRECOMPUTE, single_tile_with_relu) {
 		.testInference(nnp_convolution_algorithm_wt8x8_fp16, nnp_activation_relu, true);
 }
 
+TEST(IMPLICIT_GEMM_PRECOMPUTE, with_padding) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity, true);
+}
+
+TEST(IMPLICIT_GEMM_PRECOMPUTE, with_output_subsampling_relu) {
+	ConvolutionTester()
+		.inputSize(17, 17)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(9)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu, true);
+}
+
+TEST(IMPLICIT_GEMM_PRECOMPUTE, many_channels) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(150)
+		.outputChannels(37)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity, true);
+}
+
+TEST(IMPLICIT_GEMM_PRECOMPUTE, high_resolution) {
+	ConvolutionTester()
+		.inputSize(50, 50)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(120)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity, true);
+}
+
 /*
  * Test that the implementation handles extraction of input subtile
  */
@@ -1780,6 +1825,826 @@ TEST(DIRECT_1x1, odd_image_size_with_relu) {
 	}
 }
 
+/*
+ * Test that the implementation adds the residual before the activation
+ */
+
+TEST(FT8x8, residual) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT8x8, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, residual) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+}
+
+TEST(WT8x8, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_PRECOMPUTE, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+}
+
+TEST(IMPLICIT_GEMM, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1, residual) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.inputChannels(nnp_hwinfo.conv1x1.mr)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_identity);
+}
+
+TEST(DIRECT_1x1, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.inputChannels(nnp_hwinfo.conv1x1.mr)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 5)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+/*
+ * Test that the implementation fuses 2x2 max-pooling into the output transform
+ */
+
+TEST(FT8x8, max_pooling) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT8x8, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(30, 30)
+		.kernelSize(4, 4)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+}
+
+TEST(WT8x8, max_pooling) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+}
+
+TEST(WT8x8, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, max_pooling_with_residual_relu) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.residual(true)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_PRECOMPUTE, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+}
+
+TEST(IMPLICIT_GEMM, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(1, 1)
+		.inputChannels(nnp_hwinfo.conv1x1.mr)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+/*
+ * Test that batch normalization is folded into pre-computed kernel transforms
+ */
+
+TEST(FT8x8_PRECOMPUTE, batch_norm) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.batchNorm(true)
+		.iterations(100)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity, true);
+}
+
+TEST(FT16x16_PRECOMPUTE, batch_norm_with_relu) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.inputChannels(3)
+		.outputChannels(5)
+		.batchNorm(true)
+		.iterations(100)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu, true);
+}
+
+TEST(WT8x8_PRECOMPUTE, batch_norm) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.batchNorm(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+}
+
+TEST(WT8x8_PRECOMPUTE, batch_norm_with_residual_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.batchNorm(true)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+}
+
+/*
+ * Test that pre-computed kernel transforms survive a round-trip through a mapped kernel file
+ */
+
+TEST(FT8x8_PRECOMPUTE, kernel_file) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.kernelFile(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity, true);
+}
+
+TEST(FT16x16_PRECOMPUTE, kernel_file) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.inputChannels(3)
+		.outputChannels(5)
+		.kernelFile(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity, true);
+}
+
+TEST(WT8x8_PRECOMPUTE, kernel_file_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.kernelFile(true)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+}
+
+TEST(WT8x8_FP16_PRECOMPUTE, kernel_file) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.kernelFile(true)
+		.iterations(10)
+		.errorLimit(3.0e-2)
+		.testInference(nnp_convolution_algorithm_wt8x8_fp16, nnp_activation_identity, true);
+}
+
+/*
+ * Test fp16 kernel transform storage with many channels, where kernel transform bandwidth dominates
+ */
+
+TEST(WT8x8_FP16, large_channels) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(64)
+		.outputChannels(48)
+		.iterations(10)
+		.errorLimit(3.0e-2)
+		.testInference(nnp_convolution_algorithm_wt8x8_fp16, nnp_activation_relu);
+}
+
+TEST(WT8x8_FP16_PRECOMPUTE, large_channels) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(64)
+		.outputChannels(48)
+		.iterations(10)
+		.errorLimit(3.0e-2)
+		.testInference(nnp_convolution_algorithm_wt8x8_fp16, nnp_activation_relu, true);
+}
+
+/*
+ * Test FFT 32x32 tiles for large kernels
+ */
+
+#if !NNP_BACKEND_X86_64
+TEST(FT32x32, single_tile) {
+	ConvolutionTester()
+		.inputSize(32, 32)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_identity);
+}
+
+TEST(FT32x32, single_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(32, 32)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_relu);
+}
+
+TEST(FT32x32, multi_tile) {
+	ConvolutionTester()
+		.inputSize(61, 61)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_identity);
+}
+
+TEST(FT32x32, large_kernel) {
+	ConvolutionTester()
+		.inputSize(56, 56)
+		.inputPadding(5, 5, 5, 5)
+		.kernelSize(11, 11)
+		.inputChannels(3)
+		.outputChannels(8)
+		.iterations(10)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_relu);
+}
+
+TEST(FT32x32, non_square_kernel) {
+	ConvolutionTester()
+		.inputSize(40, 40)
+		.inputPadding(2, 9, 2, 8)
+		.kernelSize(5, 17)
+		.iterations(10)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_identity);
+}
+
+TEST(FT32x32, max_pooling_with_relu) {
+	ConvolutionTester()
+		.inputSize(62, 62)
+		.kernelSize(3, 3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_relu);
+}
+
+TEST(FT32x32_PRECOMPUTE, large_kernel) {
+	ConvolutionTester()
+		.inputSize(56, 56)
+		.inputPadding(5, 5, 5, 5)
+		.kernelSize(11, 11)
+		.inputChannels(3)
+		.outputChannels(8)
+		.iterations(10)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft32x32, nnp_activation_identity, true);
+}
+#endif /* !NNP_BACKEND_X86_64 */
+
+/*
+ * Test implicit GEMM, which reads input through an indirection buffer where an indirect micro-kernel is available
+ */
+
+TEST(IMPLICIT_GEMM, single_channel) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_padding) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 2, 2, 1)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_output_subsampling) {
+	ConvolutionTester()
+		.inputSize(17, 17)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(9)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, 5x5_kernel) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputPadding(2, 2, 2, 2)
+		.kernelSize(5, 5)
+		.inputChannels(4)
+		.outputChannels(6)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, many_channels) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(150)
+		.outputChannels(37)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, high_resolution) {
+	ConvolutionTester()
+		.inputSize(50, 50)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(120)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, high_resolution_with_few_channels) {
+	ConvolutionTester()
+		.inputSize(50, 50)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+/*
+ * Test automatic algorithm selection
+ */
+
+TEST(AUTO, few_channels) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(4)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	tester.testInferenceSelection(nnp_convolution_algorithm_implicit_gemm);
+	tester.testInference(nnp_convolution_algorithm_auto);
+}
+
+TEST(AUTO, many_channels) {
+	ConvolutionTester tester;
+	tester.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(64)
+		.outputChannels(48)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	tester.testInferenceSelection(nnp_convolution_algorithm_wt8x8);
+	tester.testInference(nnp_convolution_algorithm_auto, nnp_activation_relu);
+}
+
+TEST(AUTO, large_kernel) {
+	ConvolutionTester tester;
+	tester.inputSize(24, 24)
+		.inputPadding(5, 5, 5, 5)
+		.kernelSize(11, 11)
+		.inputChannels(4)
+		.outputChannels(8)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	tester.testInferenceSelection(nnp_convolution_algorithm_ft16x16);
+	tester.testInference(nnp_convolution_algorithm_auto);
+}
+
+TEST(AUTO, with_output_subsampling) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(9)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	tester.testInferenceSelection(nnp_convolution_algorithm_implicit_gemm);
+	tester.testInference(nnp_convolution_algorithm_auto);
+}
+
+TEST(AUTO, pointwise) {
+	ConvolutionTester tester;
+	tester.inputSize(28, 28)
+		.kernelSize(1, 1)
+		.inputChannels(64)
+		.outputChannels(48)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	tester.testInferenceSelection(nnp_convolution_algorithm_direct);
+	tester.testInference(nnp_convolution_algorithm_auto);
+}
+
+TEST(AUTO, pointwise_with_precompute) {
+	ConvolutionTester tester;
+	tester.inputSize(28, 28)
+		.kernelSize(1, 1)
+		.inputChannels(64)
+		.outputChannels(48)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	tester.testInferenceSelection(nnp_convolution_algorithm_implicit_gemm, true);
+	tester.testInference(nnp_convolution_algorithm_auto, nnp_activation_identity, true);
+}
+
+/*
+ * Test algorithm introspection
+ */
+
+TEST(QUERY, auto_3x3) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(64)
+		.outputChannels(48)
+		.testInferenceQuery(nnp_convolution_algorithm_auto);
+}
+
+TEST(QUERY, ft8x8) {
+	ConvolutionTester()
+		.inputSize(27, 29)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(5)
+		.outputChannels(7)
+		.testInferenceQuery(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(QUERY, ft16x16_precompute) {
+	ConvolutionTester()
+		.inputSize(32, 32)
+		.kernelSize(5, 5)
+		.inputChannels(8)
+		.outputChannels(4)
+		.testInferenceQuery(nnp_convolution_algorithm_ft16x16, true);
+}
+
+TEST(QUERY, wt8x8_with_pooling) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.testInferenceQuery(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(QUERY, wt8x8_fp16) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(6)
+		.testInferenceQuery(nnp_convolution_algorithm_wt8x8_fp16);
+}
+
+TEST(QUERY, wt8x8_high_resolution) {
+	ConvolutionTester()
+		.inputSize(112, 112)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(32)
+		.outputChannels(32)
+		.testInferenceQuery(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(QUERY, implicit_gemm) {
+	ConvolutionTester()
+		.inputSize(17, 17)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(9)
+		.testInferenceQuery(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(QUERY, direct_1x1) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(16)
+		.outputChannels(8)
+		.testInferenceQuery(nnp_convolution_algorithm_direct);
+}
+
+/*
+ * Test high-resolution layers, where transforms are fused per block of tiles
+ */
+
+TEST(FT8x8, high_resolution) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(10)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16, high_resolution) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(10)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(WT8x8, high_resolution) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_PRECOMPUTE, high_resolution) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+}
+
+TEST(WT8x8, high_resolution_with_residual_and_max_pooling) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.residual(true)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, high_resolution_with_many_output_channels) {
+	ConvolutionTester()
+		.inputSize(48, 48)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(4)
+		.outputChannels(150)
+		.residual(true)
+		.pooling(nnp_convolution_pooling_max_2x2)
+		.iterations(3)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16, high_resolution_with_many_output_channels) {
+	ConvolutionTester()
+		.inputSize(60, 60)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(2)
+		.outputChannels(70)
+		.iterations(3)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(WT8x8_PRECOMPUTE, high_resolution_with_many_output_channels_and_2_threads) {
+	ConvolutionTester()
+		.inputSize(48, 48)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(4)
+		.outputChannels(150)
+		.threads(2)
+		.iterations(3)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+}
+
+TEST(WT8x8, high_resolution_with_2_threads) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.threads(2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(FT8x8, high_resolution_with_64_threads) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.threads(64)
+		.iterations(10)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(WT8x8_PRECOMPUTE, high_resolution_with_64_threads) {
+	ConvolutionTester()
+		.inputSize(96, 96)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.threads(64)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+}
+
+/*
+ * Test INT8 quantized convolution against an exact integer reference
+ */
+
+TEST(IMPLICIT_GEMM_Q8, single_channel) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.testInferenceQ8(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM_Q8, multi_channel_with_padding) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(100)
+		.testInferenceQ8(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM_Q8, output_subsampling_with_relu) {
+	ConvolutionTester()
+		.inputSize(17, 17)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(9)
+		.iterations(100)
+		.testInferenceQ8(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1_Q8, multi_channel) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(17)
+		.outputChannels(15)
+		.iterations(100)
+		.testInferenceQ8(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT_1x1_Q8, multi_channel_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(17)
+		.outputChannels(15)
+		.iterations(100)
+		.testInferenceQ8(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -298,6 +298,231 @@ TEST(WT8x8, non_square_image) {
 		.testInputGradient(nnp_convolution_algorithm_wt8x8);
 }
 
+/*
+ * Test that the implementation can handle output subsampling (stride)
+ */
+
+TEST(FT8x8, with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, with_subsample3x2) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 31)
+		.kernelSize(5, 5)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(3, 2)
+		.iterations(100)
+		.errorLimit(1.0e-4f)
+		.testInputGradient(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(WT8x8, with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-3f)
+		.testInputGradient(nnp_convolution_algorithm_wt8x8);
+}
+
+/*
+ * Test that the implementation can back-propagate through ReLU activation
+ */
+
+TEST(FT8x8, relu) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16, relu) {
+	ConvolutionTester tester;
+	tester.inputSize(31, 31)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-4f)
+		.testInputGradient(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+}
+
+TEST(WT8x8, relu) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-3f)
+		.testInputGradient(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(FT8x8, with_subsample2x2_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(16)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+/*
+ * Test that GEMM-based algorithms handle the backward pass
+ */
+
+TEST(DIRECT, 1x1) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_direct);
+}
+
+TEST(IMPLICIT_GEMM, implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.inputPadding(2, 1, 0, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample2x2_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(16)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample2x2_multiple_pixel_blocks) {
+	ConvolutionTester tester;
+	tester.inputSize(63, 61)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(16)
+		.outputChannels(8)
+		.outputSubsampling(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample2x2_multiple_channel_blocks) {
+	ConvolutionTester tester;
+	tester.inputSize(9, 9)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(2)
+		.outputChannels(1200)
+		.outputSubsampling(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(DIRECT, 1x1_with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_direct);
+}
+
+TEST(IMPLICIT_GEMM, relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(16)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(AUTO, 1x1_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(16)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_auto, nnp_activation_relu);
+}
+
+TEST(AUTO, with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testInputGradient(nnp_convolution_algorithm_auto);
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
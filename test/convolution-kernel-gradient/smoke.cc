@@ -298,6 +298,246 @@ TEST(WT8x8, DISABLED_non_square_image) {
 		.testKernelGradient(nnp_convolution_algorithm_wt8x8);
 }
 
+/*
+ * Test that the implementation can accumulate into existing kernel gradient
+ */
+
+TEST(FT8x8, accumulate) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.accumulate(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, accumulate) {
+	ConvolutionTester tester;
+	tester.inputSize(31, 31)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.accumulate(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft16x16);
+}
+
+/*
+ * Test that the implementation can compute bias gradient in the same pass
+ */
+
+TEST(FT8x8, bias_gradient) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.batchSize(3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, bias_gradient) {
+	ConvolutionTester tester;
+	tester.inputSize(31, 31)
+		.batchSize(3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(FT8x8, bias_gradient_accumulate) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.computeBiasGradient(true)
+		.accumulate(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft8x8);
+}
+
+/*
+ * Test that the implementation can handle output subsampling (stride)
+ */
+
+TEST(FT8x8, with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, with_subsample3x2) {
+	ConvolutionTester tester;
+	tester.inputSize(31, 29)
+		.kernelSize(5, 5)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(3, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft16x16);
+}
+
+/*
+ * Test that the implementation can reuse the input transform saved by the forward pass
+ */
+
+TEST(FT8x8, reuse_input_transform) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.inputPadding(1, 2, 1, 0)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(3)
+		.reuseInputTransform(true)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16, reuse_input_transform) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 23)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(3)
+		.reuseInputTransform(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(AUTO, reuse_input_transform) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.batchSize(2)
+		.inputChannels(5)
+		.outputChannels(3)
+		.reuseInputTransform(true)
+		.accumulate(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_auto);
+}
+
+/*
+ * Test that GEMM-based algorithms handle the backward pass
+ */
+
+TEST(DIRECT, 1x1) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(3)
+		.inputChannels(7)
+		.outputChannels(5)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT, 1x1_with_subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_direct);
+}
+
+TEST(IMPLICIT_GEMM, implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.inputPadding(2, 1, 0, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, accumulate) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.accumulate(true)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample3x2) {
+	ConvolutionTester tester;
+	tester.inputSize(31, 29)
+		.kernelSize(5, 5)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(3, 2)
+		.computeBiasGradient(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, multiple_pixel_blocks) {
+	ConvolutionTester tester;
+	tester.inputSize(47, 45)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(16)
+		.outputChannels(8)
+		.computeBiasGradient(true)
+		.iterations(5)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(AUTO, 1x1) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient(nnp_convolution_algorithm_auto);
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -40,6 +40,24 @@ TEST(FT16x16, single_tile_with_relu) {
 		.testOutput(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
 }
 
+#if !NNP_BACKEND_X86_64
+TEST(FT32x32, single_tile) {
+	ConvolutionTester()
+		.inputSize(32, 32)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft32x32);
+}
+
+TEST(FT32x32, single_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(32, 32)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft32x32, nnp_activation_relu);
+}
+#endif /* !NNP_BACKEND_X86_64 */
+
 TEST(WT8x8, single_tile) {
 	ConvolutionTester()
 		.inputSize(8, 8)
@@ -565,6 +583,222 @@ TEST(WT8x8, non_square_image_with_relu) {
 		.testOutput(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
 }
 
+/*
+ * Test that the implementation adds the residual before the activation
+ */
+
+TEST(FT8x8, residual) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(2)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT8x8, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(2)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.batchSize(2)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+}
+
+TEST(WT8x8, residual) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(2)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-3f)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(WT8x8, residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(2)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-3f)
+		.testOutput(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample2x2) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, with_subsample2x2_residual_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.residual(true)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(AUTO, with_subsample3x2) {
+	ConvolutionTester()
+		.inputSize(17, 15)
+		.kernelSize(5, 5)
+		.batchSize(2)
+		.inputChannels(4)
+		.outputChannels(6)
+		.outputSubsampling(3, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_auto);
+}
+
+#if NNP_BACKEND_ARM
+TEST(WT8x8, with_subsample2x2) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-3f)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+}
+#endif
+
+/*
+ * Test that the implementation handles batches large enough to be partitioned across processor packages
+ */
+
+TEST(FT8x8, large_batch) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(19)
+		.inputChannels(5)
+		.outputChannels(7)
+		.residual(true)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, large_batch) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(19)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(10)
+		.errorLimit(1.0e-3f)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(FT8x8, large_batch_with_three_packages) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(19)
+		.inputChannels(5)
+		.outputChannels(7)
+		.residual(true)
+		.packages(3)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, large_batch_with_two_packages) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(19)
+		.inputChannels(5)
+		.outputChannels(7)
+		.packages(2)
+		.iterations(10)
+		.errorLimit(1.0e-3f)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+}
+
+/*
+ * Test that GEMM-based algorithms handle training layers
+ */
+
+TEST(DIRECT, 1x1) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT, 1x1_with_subsample2x2) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_direct);
+}
+
+TEST(IMPLICIT_GEMM, implicit_padding) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(AUTO, 1x1) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(7)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_convolution_algorithm_auto);
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
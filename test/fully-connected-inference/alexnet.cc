@@ -15,6 +15,26 @@ TEST(F32, fc6) {
 		.testInferenceF32();
 }
 
+TEST(F32, fc6_with_bias_relu) {
+	AlexNet::fc6()
+		.bias(true)
+		.errorLimit(2.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc6) {
+	AlexNet::fc6()
+		.errorLimit(2.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc6_with_bias_relu) {
+	AlexNet::fc6()
+		.bias(true)
+		.errorLimit(2.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
 /*
  * AlexNet fc7 layer
  */
@@ -25,6 +45,26 @@ TEST(F32, fc7) {
 		.testInferenceF32();
 }
 
+TEST(F32, fc7_with_bias_relu) {
+	AlexNet::fc7()
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc7) {
+	AlexNet::fc7()
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc7_with_bias_relu) {
+	AlexNet::fc7()
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
 /*
  * AlexNet fc8 layer
  */
@@ -35,6 +75,70 @@ TEST(F32, fc8) {
 		.testInferenceF32();
 }
 
+TEST(F16F32, fc8) {
+	AlexNet::fc8()
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
+/*
+ * Classifier with few outputs on top of AlexNet fc7 features (input channels are split across 8 threads)
+ */
+
+TEST(F32, fc7_few_outputs) {
+	AlexNet::fc7()
+		.outputChannels(10)
+		.threads(8)
+		.errorLimit(1.0e-5f)
+		.testInferenceF32();
+}
+
+TEST(F32, fc7_few_outputs_with_bias_relu) {
+	AlexNet::fc7()
+		.outputChannels(10)
+		.threads(8)
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc7_few_outputs) {
+	AlexNet::fc7()
+		.outputChannels(10)
+		.threads(8)
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc7_few_outputs_with_bias_relu) {
+	AlexNet::fc7()
+		.outputChannels(10)
+		.threads(8)
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
+/*
+ * Many threads over a few hundred outputs: the split is limited by the size of the partial sums buffer
+ */
+
+TEST(F32, fc7_many_threads) {
+	AlexNet::fc7()
+		.outputChannels(250)
+		.threads(256)
+		.errorLimit(1.0e-5f)
+		.testInferenceF32();
+}
+
+TEST(F16F32, fc7_many_threads) {
+	AlexNet::fc7()
+		.outputChannels(250)
+		.threads(256)
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
 
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
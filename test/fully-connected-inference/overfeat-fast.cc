@@ -15,6 +15,26 @@ TEST(F32, fc6) {
 		.testInferenceF32();
 }
 
+TEST(F32, fc6_with_bias_relu) {
+	OverFeat_Fast::fc6()
+		.bias(true)
+		.errorLimit(2.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc6) {
+	OverFeat_Fast::fc6()
+		.errorLimit(2.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc6_with_bias_relu) {
+	OverFeat_Fast::fc6()
+		.bias(true)
+		.errorLimit(2.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
 /*
  * OverFeat (Fast model) fc7 layer
  */
@@ -25,6 +45,26 @@ TEST(F32, fc7) {
 		.testInferenceF32();
 }
 
+TEST(F32, fc7_with_bias_relu) {
+	OverFeat_Fast::fc7()
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc7) {
+	OverFeat_Fast::fc7()
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc7_with_bias_relu) {
+	OverFeat_Fast::fc7()
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
 /*
  * OverFeat (Fast model) fc8 layer
  */
@@ -35,6 +75,12 @@ TEST(F32, fc8) {
 		.testInferenceF32();
 }
 
+TEST(F16F32, fc8) {
+	OverFeat_Fast::fc8()
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
 
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
@@ -15,6 +15,26 @@ TEST(F32, fc6) {
 		.testInferenceF32();
 }
 
+TEST(F32, fc6_with_bias_relu) {
+	VGG_A::fc6()
+		.bias(true)
+		.errorLimit(2.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc6) {
+	VGG_A::fc6()
+		.errorLimit(2.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc6_with_bias_relu) {
+	VGG_A::fc6()
+		.bias(true)
+		.errorLimit(2.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
 /*
  * VGG model A fc7 layer
  */
@@ -25,6 +45,26 @@ TEST(F32, fc7) {
 		.testInferenceF32();
 }
 
+TEST(F32, fc7_with_bias_relu) {
+	VGG_A::fc7()
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF32(nnp_activation_relu);
+}
+
+TEST(F16F32, fc7) {
+	VGG_A::fc7()
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
+TEST(F16F32, fc7_with_bias_relu) {
+	VGG_A::fc7()
+		.bias(true)
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32(nnp_activation_relu);
+}
+
 /*
  * VGG model A fc8 layer
  */
@@ -35,6 +75,12 @@ TEST(F32, fc8) {
 		.testInferenceF32();
 }
 
+TEST(F16F32, fc8) {
+	VGG_A::fc8()
+		.errorLimit(1.0e-5f)
+		.testInferenceF16F32();
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
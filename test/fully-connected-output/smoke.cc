@@ -159,6 +159,217 @@ TEST(MRxNR_4x24, many_output_channels) {
 		.testOutput();
 }
 
+/*
+ * Test that implementation works for output channels remainder subblocks when the batch is handled by sgemm
+ * (batches up to 16 use the small-batch path instead)
+ */
+
+TEST(MRxNR_4x24, large_batch_output_channels_remainder_subblock) {
+	for (size_t outputChannels = 3 * 24 + 1; outputChannels < 4 * 24; outputChannels += 1) {
+		FullyConnectedTester()
+			.batchSize(20)
+			.outputChannels(outputChannels)
+			.iterations(10)
+			.errorLimit(1.0e-5f)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that implementation works when a batch handled by sgemm is not divisible by subblock
+ */
+
+TEST(MRxNR_4x24, large_batch_remainder_subblock) {
+	for (size_t batchSize = 17; batchSize < 20; batchSize += 1) {
+		FullyConnectedTester()
+			.batchSize(batchSize)
+			.inputChannels(1024)
+			.outputChannels(24)
+			.iterations(10)
+			.errorLimit(1.0e-5f)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that the small-batch path works for every batch size it handles, including partial sdotxf subblocks
+ */
+
+TEST(SMALL_BATCH, batch_sizes) {
+	for (size_t batchSize = 1; batchSize <= 16; batchSize += 1) {
+		FullyConnectedTester()
+			.batchSize(batchSize)
+			.inputChannels(1024)
+			.outputChannels(37)
+			.iterations(10)
+			.errorLimit(1.0e-5f)
+			.testOutput();
+	}
+}
+
+/*
+ * Test that the small-batch path works for many output channels (multiple tiles per thread)
+ */
+
+TEST(SMALL_BATCH, many_output_channels) {
+	FullyConnectedTester()
+		.batchSize(9)
+		.inputChannels(384)
+		.outputChannels(1200)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput();
+}
+
+/*
+ * Test that bias and ReLU are applied in the sgemm epilogue, including with multiple blocks of input channels
+ */
+
+TEST(MRxNR_4x24, bias_with_relu) {
+	FullyConnectedTester()
+		.batchSize(23)
+		.inputChannels(1024)
+		.outputChannels(77)
+		.bias(true)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_activation_relu);
+}
+
+TEST(MRxNR_4x24, relu) {
+	FullyConnectedTester()
+		.batchSize(23)
+		.inputChannels(1024)
+		.outputChannels(77)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_activation_relu);
+}
+
+/*
+ * Test that bias and ReLU are applied by the small-batch path
+ */
+
+TEST(SMALL_BATCH, bias) {
+	FullyConnectedTester()
+		.batchSize(11)
+		.inputChannels(384)
+		.outputChannels(37)
+		.bias(true)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput();
+}
+
+TEST(SMALL_BATCH, bias_with_relu) {
+	FullyConnectedTester()
+		.batchSize(11)
+		.inputChannels(384)
+		.outputChannels(37)
+		.bias(true)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_activation_relu);
+}
+
+/*
+ * Test that a kernel packed with nnp_fully_connected_pack_kernel is reused as is, for every batch size and for
+ * output channels and input channels remainders
+ */
+
+TEST(PRECOMPUTE, batch_sizes) {
+	for (size_t batchSize = 1; batchSize <= 24; batchSize += 1) {
+		FullyConnectedTester()
+			.batchSize(batchSize)
+			.inputChannels(1024)
+			.outputChannels(37)
+			.iterations(10)
+			.errorLimit(1.0e-5f)
+			.testOutput(nnp_activation_identity, true);
+	}
+}
+
+TEST(PRECOMPUTE, few_input_channels) {
+	FullyConnectedTester()
+		.batchSize(20)
+		.inputChannels(13)
+		.outputChannels(72)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_activation_identity, true);
+}
+
+TEST(PRECOMPUTE, bias_with_relu) {
+	FullyConnectedTester()
+		.batchSize(7)
+		.inputChannels(1024)
+		.outputChannels(1200)
+		.bias(true)
+		.iterations(3)
+		.errorLimit(1.0e-5f)
+		.testOutput(nnp_activation_relu, true);
+}
+
+/*
+ * Test that input gradient works for small and large batches, and for channel counts that are not multiples of blocks
+ */
+
+TEST(INPUT_GRADIENT, small_batch) {
+	FullyConnectedTester()
+		.batchSize(3)
+		.inputChannels(77)
+		.outputChannels(1024)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testInputGradient();
+}
+
+TEST(INPUT_GRADIENT, large_batch) {
+	FullyConnectedTester()
+		.batchSize(67)
+		.inputChannels(130)
+		.outputChannels(511)
+		.iterations(3)
+		.errorLimit(1.0e-5f)
+		.testInputGradient();
+}
+
+/*
+ * Test that kernel gradient works when the mini-batch (the reduction dimension) spans several cache blocks
+ */
+
+TEST(KERNEL_GRADIENT, small_batch) {
+	FullyConnectedTester()
+		.batchSize(5)
+		.inputChannels(77)
+		.outputChannels(29)
+		.bias(true)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient();
+}
+
+TEST(KERNEL_GRADIENT, large_batch) {
+	FullyConnectedTester()
+		.batchSize(1100)
+		.inputChannels(130)
+		.outputChannels(51)
+		.bias(true)
+		.iterations(3)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient();
+}
+
+TEST(KERNEL_GRADIENT, without_bias) {
+	FullyConnectedTester()
+		.batchSize(64)
+		.inputChannels(24)
+		.outputChannels(24)
+		.iterations(10)
+		.errorLimit(1.0e-5f)
+		.testKernelGradient();
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstdio>
 
 #include <cmath>
 #include <cfloat>
@@ -10,8 +11,10 @@
 #include <chrono>
 #include <functional>
 #include <algorithm>
+#include <numeric>
 
 #include <nnpack.h>
+#include <nnpack/hwinfo.h>
 #include <nnpack/reference.h>
 #include <nnpack/AlignedAllocator.h>
 
@@ -23,6 +26,15 @@ public:
 		iterations_(1),
 		errorLimit_(1.0e-5f),
 		multithreading_(false),
+		threads_(0),
+		packages_(0),
+		residual_(false),
+		accumulate_(false),
+		computeBiasGradient_(false),
+		reuseInputTransform_(false),
+		pooling_(nnp_convolution_pooling_none),
+		batchNorm_(false),
+		kernelFile_(false),
 		batchSize_(1),
 		inputChannels_(1),
 		outputChannels_(1)
@@ -39,6 +51,15 @@ public:
 		iterations_(tester.iterations_),
 		errorLimit_(tester.errorLimit_),
 		multithreading_(tester.multithreading_),
+		threads_(tester.threads_),
+		packages_(tester.packages_),
+		residual_(tester.residual_),
+		accumulate_(tester.accumulate_),
+		computeBiasGradient_(tester.computeBiasGradient_),
+		reuseInputTransform_(tester.reuseInputTransform_),
+		pooling_(tester.pooling_),
+		batchNorm_(tester.batchNorm_),
+		kernelFile_(tester.kernelFile_),
 		batchSize_(tester.batchSize_),
 		inputChannels_(tester.inputChannels_),
 		outputChannels_(tester.outputChannels_),
@@ -85,6 +106,87 @@ public:
 		return this->multithreading_;
 	}
 
+	inline ConvolutionTester& threads(size_t threads) {
+		this->threads_ = threads;
+		return *this;
+	}
+
+	inline size_t threads() const {
+		return this->threads_;
+	}
+
+	inline ConvolutionTester& packages(size_t packages) {
+		this->packages_ = packages;
+		return *this;
+	}
+
+	inline size_t packages() const {
+		return this->packages_;
+	}
+
+	inline ConvolutionTester& residual(bool residual) {
+		this->residual_ = residual;
+		return *this;
+	}
+
+	inline bool residual() const {
+		return this->residual_;
+	}
+
+	inline ConvolutionTester& accumulate(bool accumulate) {
+		this->accumulate_ = accumulate;
+		return *this;
+	}
+
+	inline bool accumulate() const {
+		return this->accumulate_;
+	}
+
+	inline ConvolutionTester& computeBiasGradient(bool computeBiasGradient) {
+		this->computeBiasGradient_ = computeBiasGradient;
+		return *this;
+	}
+
+	inline bool computeBiasGradient() const {
+		return this->computeBiasGradient_;
+	}
+
+	inline ConvolutionTester& reuseInputTransform(bool reuseInputTransform) {
+		this->reuseInputTransform_ = reuseInputTransform;
+		return *this;
+	}
+
+	inline bool reuseInputTransform() const {
+		return this->reuseInputTransform_;
+	}
+
+	inline ConvolutionTester& pooling(enum nnp_convolution_pooling pooling) {
+		this->pooling_ = pooling;
+		return *this;
+	}
+
+	inline enum nnp_convolution_pooling pooling() const {
+		return this->pooling_;
+	}
+
+	inline ConvolutionTester& batchNorm(bool batchNorm) {
+		this->batchNorm_ = batchNorm;
+		return *this;
+	}
+
+	inline bool batchNorm() const {
+		return this->batchNorm_;
+	}
+
+	inline ConvolutionTester& kernelFile(bool kernelFile) {
+		this->kernelFile_ = kernelFile;
+		return *this;
+	}
+
+	inline bool kernelFile() const {
+		return this->kernelFile_;
+	}
+
 	inline ConvolutionTester& batchSize(size_t batchSize) {
 		this->batchSize_ = batchSize;
 		return *this;
@@ -163,6 +265,21 @@ public:
 		return (this->inputPadding_.left + this->inputSize_.width + this->inputPadding_.right - this->kernelSize_.width) / this->outputSubsampling_.width + 1;
 	}
 
+	inline struct nnp_size pooledSize() const {
+		struct nnp_size pooledSize;
+		pooledSize.height = this->pooledHeight();
+		pooledSize.width = this->pooledWidth();
+		return pooledSize;
+	}
+
+	inline size_t pooledHeight() const {
+		return this->pooling_ == nnp_convolution_pooling_none ? this->outputHeight() : (this->outputHeight() + 1) / 2;
+	}
+
+	inline size_t pooledWidth() const {
+		return this->pooling_ == nnp_convolution_pooling_none ? this->outputWidth() : (this->outputWidth() + 1) / 2;
+	}
+
 	inline ConvolutionTester& outputSubsampling(size_t height, size_t width) {
 		this->outputSubsampling_.height = height;
 		this->outputSubsampling_.width = width;
@@ -194,6 +311,8 @@ public:
 
 		std::vector<float> bias(outputChannels());
 
+		std::vector<float> residualInput(residual() ? batchSize() * outputChannels() * outputHeight() * outputWidth() : 0);
+
 		std::vector<float> output(batchSize() * outputChannels() * outputHeight() * outputWidth());
 		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
 
@@ -201,18 +320,23 @@ public:
 		enum nnp_status status = nnp_convolution_output(
 			algorithm,
 			batchSize(), inputChannels(), outputChannels(),
-			inputSize(), inputPadding(), kernelSize(),
-			nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
 			activation, nullptr,
 			nullptr);
 		ASSERT_EQ(nnp_status_success, status);
 
 		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+
+		/* Batches are split across packages only when the library allocates the workspace, so none is passed then */
+		const PackagesOverride packagesOverride(packages());
+
 		std::vector<float> maxErrors;
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(input.begin(), input.end(), std::ref(rng));
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
 			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::generate(residualInput.begin(), residualInput.end(), std::ref(rng));
 			std::fill(output.begin(), output.end(), nanf(""));
 			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
 
@@ -221,6 +345,8 @@ public:
 				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 				input.data(), kernel.data(), bias.data(), referenceOutput.data());
 
+			std::transform(residualInput.cbegin(), residualInput.cend(), referenceOutput.cbegin(), referenceOutput.begin(), std::plus<float>());
+
 			switch (activation) {
 				case nnp_activation_identity:
 					break;
@@ -236,10 +362,12 @@ public:
 			enum nnp_status status = nnp_convolution_output(
 				algorithm,
 				batchSize(), inputChannels(), outputChannels(),
-				inputSize(), inputPadding(), kernelSize(),
-				input.data(), kernel.data(), bias.data(), output.data(),
-				scratchSize == 0 ? nullptr : scratchBuffer.data(),
-				scratchSize == 0 ? nullptr : &scratchSize,
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(),
+				residual() ? residualInput.data() : nullptr,
+				output.data(), nullptr, nullptr,
+				scratchSize == 0 || packages() != 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 || packages() != 0 ? nullptr : &scratchSize,
 				activation, nullptr,
 				nullptr);
 			ASSERT_EQ(nnp_status_success, status);
@@ -255,20 +383,24 @@ public:
 		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
 		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
 
+		auto outputRng = std::bind(std::uniform_real_distribution<float>(-1.0f, 1.0f), std::mt19937(seed));
+
 		std::vector<float> outputGradient(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> output(activation == nnp_activation_identity ? 0 : batchSize() * outputChannels() * outputHeight() * outputWidth());
 		std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
 
 		std::vector<float> inputGradient(batchSize() * inputChannels() * inputHeight() * inputWidth());
 
+		std::vector<float> referenceOutputGradient(batchSize() * outputChannels() * outputHeight() * outputWidth());
 		std::vector<float> referenceInputGradient(batchSize() * inputChannels() * inputHeight() * inputWidth());
 
 		size_t scratchSize = 0;
 		enum nnp_status status = nnp_convolution_input_gradient(
 			algorithm,
 			batchSize(), inputChannels(), outputChannels(),
-			inputSize(), inputPadding(), kernelSize(),
-			nullptr, nullptr, nullptr, nullptr, &scratchSize,
-			nnp_activation_identity, nullptr,
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			activation, nullptr,
 			nullptr);
 		ASSERT_EQ(nnp_status_success, status);
 
@@ -276,23 +408,37 @@ public:
 		std::vector<float> maxErrors;
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(outputGradient.begin(), outputGradient.end(), std::ref(rng));
+			std::generate(output.begin(), output.end(), std::ref(outputRng));
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
 			std::fill(inputGradient.begin(), inputGradient.end(), nanf(""));
 			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
 
+			switch (activation) {
+				case nnp_activation_identity:
+					referenceOutputGradient = outputGradient;
+					break;
+				case nnp_activation_relu:
+					nnp_relu_input_gradient__reference(
+						batchSize(), outputChannels() * outputHeight() * outputWidth(),
+						outputGradient.data(), output.data(), referenceOutputGradient.data(), 0.0f);
+					break;
+				default:
+					FAIL() << "Unexpected activation value: " << activation;
+			}
+
 			nnp_convolution_input_gradient__reference(
 				batchSize(), inputChannels(), outputChannels(),
-				inputSize(), inputPadding(), kernelSize(),
-				outputGradient.data(), kernel.data(), referenceInputGradient.data());
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				referenceOutputGradient.data(), kernel.data(), referenceInputGradient.data());
 
 			enum nnp_status status = nnp_convolution_input_gradient(
 				algorithm,
 				batchSize(), inputChannels(), outputChannels(),
-				inputSize(), inputPadding(), kernelSize(),
-				outputGradient.data(), kernel.data(), inputGradient.data(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				outputGradient.data(), output.data(), kernel.data(), inputGradient.data(),
 				scratchSize == 0 ? nullptr : scratchBuffer.data(),
 				scratchSize == 0 ? nullptr : &scratchSize,
-				nnp_activation_identity, NULL,
+				activation, NULL,
 				nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
@@ -301,6 +447,20 @@ public:
 			maxErrors.push_back(maxError);
 		}
 		EXPECT_LT(median(maxErrors), errorLimit());
+
+		if (activation == nnp_activation_relu) {
+			/* ReLU gradient can not be computed without the forward output */
+			status = nnp_convolution_input_gradient(
+				algorithm,
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				outputGradient.data(), nullptr, kernel.data(), inputGradient.data(),
+				scratchSize == 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 ? nullptr : &scratchSize,
+				activation, nullptr,
+				nullptr);
+			EXPECT_EQ(nnp_status_invalid_activation, status);
+		}
 	}
 
 	void testKernelGradient(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity) const {
@@ -311,14 +471,130 @@ public:
 		std::vector<float> outputGradient(batchSize() * outputChannels() * outputHeight() * outputWidth());
 		std::vector<float> kernelGradient(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
 
+		std::vector<float> biasGradient(outputChannels());
+
 		std::vector<float> referenceKernelGradient(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+		std::vector<float> referenceBiasGradient(outputChannels());
 		
+		/* With reuseInputTransform, the forward pass saves the input transform and the kernel gradient reads it */
+		const enum nnp_convolution_transform_strategy inputTransformStrategy = reuseInputTransform() ?
+			nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute;
+		std::vector<float> kernel(reuseInputTransform() ? outputChannels() * inputChannels() * kernelHeight() * kernelWidth() : 0);
+		std::vector<float> bias(reuseInputTransform() ? outputChannels() : 0);
+		std::vector<float> output(reuseInputTransform() ? batchSize() * outputChannels() * outputHeight() * outputWidth() : 0);
+		size_t inputTransformSize = 0;
+		if (reuseInputTransform()) {
+			enum nnp_status status = nnp_convolution_output(
+				algorithm,
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &inputTransformSize, nullptr, nullptr,
+				nnp_activation_identity, nullptr,
+				nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+		}
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> inputTransform(inputTransformSize);
+
 		size_t scratchSize = 0;
 		enum nnp_status status = nnp_convolution_kernel_gradient(
+			algorithm, inputTransformStrategy,
+			batchSize(), inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, accumulate(), nullptr, &scratchSize,
+			nnp_activation_identity, nullptr,
+			nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(outputGradient.begin(), outputGradient.end(), std::ref(rng));
+			if (accumulate()) {
+				std::generate(kernelGradient.begin(), kernelGradient.end(), std::ref(rng));
+				std::generate(biasGradient.begin(), biasGradient.end(), std::ref(rng));
+			} else {
+				std::fill(kernelGradient.begin(), kernelGradient.end(), nanf(""));
+				std::fill(biasGradient.begin(), biasGradient.end(), nanf(""));
+			}
+			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
+
+			if (reuseInputTransform()) {
+				std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+				std::generate(bias.begin(), bias.end(), std::ref(rng));
+				std::fill(inputTransform.begin(), inputTransform.end(), 0xA5);
+				enum nnp_status status = nnp_convolution_output(
+					algorithm,
+					batchSize(), inputChannels(), outputChannels(),
+					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+					input.data(), kernel.data(), bias.data(), nullptr, output.data(),
+					inputTransform.data(), &inputTransformSize, nullptr, nullptr,
+					nnp_activation_identity, nullptr,
+					nullptr);
+				ASSERT_EQ(nnp_status_success, status);
+			}
+
+			nnp_convolution_kernel_gradient__reference(
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), outputGradient.data(), referenceKernelGradient.data());
+			if (accumulate()) {
+				std::transform(referenceKernelGradient.cbegin(), referenceKernelGradient.cend(), kernelGradient.cbegin(),
+					referenceKernelGradient.begin(), std::plus<float>());
+			}
+			for (size_t outputChannel = 0; outputChannel < outputChannels(); outputChannel++) {
+				double sum = accumulate() ? biasGradient[outputChannel] : 0.0;
+				for (size_t sample = 0; sample < batchSize(); sample++) {
+					const float* outputGradientChannel = &outputGradient[(sample * outputChannels() + outputChannel) * outputHeight() * outputWidth()];
+					sum = std::accumulate(outputGradientChannel, outputGradientChannel + outputHeight() * outputWidth(), sum);
+				}
+				referenceBiasGradient[outputChannel] = float(sum);
+			}
+
+			enum nnp_status status = nnp_convolution_kernel_gradient(
+				algorithm, inputTransformStrategy,
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				reuseInputTransform() ? reinterpret_cast<const float*>(inputTransform.data()) : input.data(),
+				outputGradient.data(), kernelGradient.data(),
+				computeBiasGradient() ? biasGradient.data() : nullptr, accumulate(),
+				scratchSize == 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 ? nullptr : &scratchSize,
+				nnp_activation_identity, NULL,
+				NULL);
+			ASSERT_EQ(nnp_status_success, status);
+
+			float maxError = std::inner_product(referenceKernelGradient.cbegin(), referenceKernelGradient.cend(), kernelGradient.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			if (computeBiasGradient()) {
+				maxError = std::inner_product(referenceBiasGradient.cbegin(), referenceBiasGradient.cend(), biasGradient.cbegin(), maxError,
+					[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			}
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	void testBackward(enum nnp_convolution_algorithm algorithm) const {
+		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> outputGradient(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+
+		std::vector<float> inputGradient(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernelGradient(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+
+		std::vector<float> referenceInputGradient(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> referenceKernelGradient(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+
+		size_t scratchSize = 0;
+		enum nnp_status status = nnp_convolution_backward(
 			algorithm,
 			batchSize(), inputChannels(), outputChannels(),
 			inputSize(), inputPadding(), kernelSize(),
-			nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
 			nnp_activation_identity, nullptr,
 			nullptr);
 		ASSERT_EQ(nnp_status_success, status);
@@ -328,34 +604,48 @@ public:
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(input.begin(), input.end(), std::ref(rng));
 			std::generate(outputGradient.begin(), outputGradient.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::fill(inputGradient.begin(), inputGradient.end(), nanf(""));
 			std::fill(kernelGradient.begin(), kernelGradient.end(), nanf(""));
 			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
 
+			nnp_convolution_input_gradient__reference(
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				outputGradient.data(), kernel.data(), referenceInputGradient.data());
+
 			nnp_convolution_kernel_gradient__reference(
 				batchSize(), inputChannels(), outputChannels(),
-				inputSize(), inputPadding(), kernelSize(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 				input.data(), outputGradient.data(), referenceKernelGradient.data());
 
-			enum nnp_status status = nnp_convolution_kernel_gradient(
+			enum nnp_status status = nnp_convolution_backward(
 				algorithm,
 				batchSize(), inputChannels(), outputChannels(),
 				inputSize(), inputPadding(), kernelSize(),
-				input.data(), outputGradient.data(), kernelGradient.data(),
+				input.data(), outputGradient.data(), kernel.data(),
+				inputGradient.data(), kernelGradient.data(),
 				scratchSize == 0 ? nullptr : scratchBuffer.data(),
 				scratchSize == 0 ? nullptr : &scratchSize,
-				nnp_activation_identity, NULL,
-				NULL);
+				nnp_activation_identity, nullptr,
+				nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
-			const float maxError = std::inner_product(referenceKernelGradient.cbegin(), referenceKernelGradient.cend(), kernelGradient.cbegin(), 0.0f,
+			const float maxInputError = std::inner_product(referenceInputGradient.cbegin(), referenceInputGradient.cend(), inputGradient.cbegin(), 0.0f,
 				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
-			maxErrors.push_back(maxError);
+			const float maxKernelError = std::inner_product(referenceKernelGradient.cbegin(), referenceKernelGradient.cend(), kernelGradient.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			maxErrors.push_back(std::max(maxInputError, maxKernelError));
 		}
 		EXPECT_LT(median(maxErrors), errorLimit());
 	}
 
 	void testInference(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity, bool precompute = false) const {
 		ASSERT_EQ(1, batchSize());
+		/* Batch normalization is folded only into pre-computed kernel transforms */
+		ASSERT_TRUE(precompute || !batchNorm());
+		/* Only pre-computed kernel transforms are serialized */
+		ASSERT_TRUE(precompute || !kernelFile());
 
 		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
 		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1f, 1.0f), std::mt19937(seed));
@@ -365,8 +655,18 @@ public:
 
 		std::vector<float> bias(outputChannels());
 
-		std::vector<float> output(outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> mean(batchNorm() ? outputChannels() : 0);
+		std::vector<float> variance(batchNorm() ? outputChannels() : 0);
+		std::vector<float> gamma(batchNorm() ? outputChannels() : 0);
+		std::vector<float> beta(batchNorm() ? outputChannels() : 0);
+		std::vector<float> foldedBias(outputChannels());
+		const float epsilon = 1.0e-5f;
+
+		std::vector<float> residualInput(residual() ? outputChannels() * outputHeight() * outputWidth() : 0);
+
+		std::vector<float> output(outputChannels() * pooledHeight() * pooledWidth());
 		std::vector<float> referenceOutput(outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referencePooledOutput(outputChannels() * pooledHeight() * pooledWidth());
 
 		size_t scratchSize = 0;
 		enum nnp_status status = nnp_convolution_inference(
@@ -374,18 +674,27 @@ public:
 			precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
 			inputChannels(), outputChannels(),
 			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
-			nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
 			activation, nullptr,
+			pooling(),
 			nullptr);
 		ASSERT_EQ(nnp_status_success, status);
 
 		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
 
+		/* The workspace size was queried with the default thread count; computations may run with another one */
+		const ThreadsOverride threadsOverride(threads());
+
 		std::vector<float> maxErrors;
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(input.begin(), input.end(), std::ref(rng));
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
 			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::generate(mean.begin(), mean.end(), std::ref(rng));
+			std::generate(variance.begin(), variance.end(), [&rng]() -> float { return std::abs(rng()) + 0.5f; });
+			std::generate(gamma.begin(), gamma.end(), [&rng]() -> float { return std::abs(rng()) + 0.5f; });
+			std::generate(beta.begin(), beta.end(), std::ref(rng));
+			std::generate(residualInput.begin(), residualInput.end(), std::ref(rng));
 			std::fill(output.begin(), output.end(), nanf(""));
 			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
 
@@ -394,6 +703,18 @@ public:
 				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 				input.data(), kernel.data(), bias.data(), referenceOutput.data());
 
+			if (batchNorm()) {
+				for (size_t outputChannel = 0; outputChannel < outputChannels(); outputChannel++) {
+					const float scale = gamma[outputChannel] / std::sqrt(variance[outputChannel] + epsilon);
+					for (size_t index = 0; index < outputHeight() * outputWidth(); index++) {
+						float& value = referenceOutput[outputChannel * outputHeight() * outputWidth() + index];
+						value = (value - mean[outputChannel]) * scale + beta[outputChannel];
+					}
+				}
+			}
+
+			std::transform(residualInput.cbegin(), residualInput.cend(), referenceOutput.cbegin(), referenceOutput.begin(), std::plus<float>());
+
 			switch (activation) {
 				case nnp_activation_identity:
 					break;
@@ -407,6 +728,21 @@ public:
 			
 			}
 
+			switch (pooling()) {
+				case nnp_convolution_pooling_none:
+					referencePooledOutput = referenceOutput;
+					break;
+				case nnp_convolution_pooling_max_2x2:
+					nnp_max_pooling_output__reference(
+						1, outputChannels(),
+						outputSize(), nnp_padding{ 0, 0, 0, 0 },
+						nnp_size{ 2, 2 }, nnp_size{ 2, 2 },
+						referenceOutput.data(), referencePooledOutput.data());
+					break;
+				default:
+					FAIL() << "Unexpected pooling value: " << pooling();
+			}
+
 			std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> transformedKernel;
 
 			if (precompute) {
@@ -415,20 +751,59 @@ public:
 					algorithm, nnp_convolution_transform_strategy_precompute,
 					inputChannels(), outputChannels(),
 					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
-					nullptr, nullptr, nullptr, nullptr, nullptr, &transformedKernelSize,
+					nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &transformedKernelSize,
 					activation, nullptr,
+					nnp_convolution_pooling_none,
 					nullptr);
 				ASSERT_EQ(nnp_status_success, status);
 
 				transformedKernel.resize(transformedKernelSize);
 
-				status = nnp_convolution_inference(
-					algorithm, nnp_convolution_transform_strategy_precompute,
-					inputChannels(), outputChannels(),
-					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
-					nullptr, kernel.data(), nullptr, nullptr, transformedKernel.data(), &transformedKernelSize,
-					activation, nullptr,
-					nullptr);
+				if (batchNorm()) {
+					/* Rejected parameters and failed kernel transforms leave folded bias untouched */
+					std::fill(foldedBias.begin(), foldedBias.end(), std::nanf(""));
+					std::vector<float> invalidVariance(variance);
+					invalidVariance.back() = -epsilon;
+					status = nnp_convolution_inference_fold_batch_norm(
+						algorithm,
+						inputChannels(), outputChannels(),
+						inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+						kernel.data(), bias.data(),
+						mean.data(), invalidVariance.data(), gamma.data(), beta.data(), epsilon,
+						transformedKernel.data(), &transformedKernelSize, foldedBias.data(),
+						nullptr);
+					ASSERT_EQ(nnp_status_invalid_batch_norm_parameters, status);
+
+					size_t smallTransformedKernelSize = transformedKernelSize - 1;
+					status = nnp_convolution_inference_fold_batch_norm(
+						algorithm,
+						inputChannels(), outputChannels(),
+						inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+						kernel.data(), bias.data(),
+						mean.data(), variance.data(), gamma.data(), beta.data(), epsilon,
+						transformedKernel.data(), &smallTransformedKernelSize, foldedBias.data(),
+						nullptr);
+					ASSERT_EQ(nnp_status_insufficient_buffer, status);
+					ASSERT_TRUE(std::all_of(foldedBias.cbegin(), foldedBias.cend(), [](float x) { return std::isnan(x); }));
+
+					status = nnp_convolution_inference_fold_batch_norm(
+						algorithm,
+						inputChannels(), outputChannels(),
+						inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+						kernel.data(), bias.data(),
+						mean.data(), variance.data(), gamma.data(), beta.data(), epsilon,
+						transformedKernel.data(), &transformedKernelSize, foldedBias.data(),
+						nullptr);
+				} else {
+					status = nnp_convolution_inference(
+						algorithm, nnp_convolution_transform_strategy_precompute,
+						inputChannels(), outputChannels(),
+						inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+						nullptr, kernel.data(), nullptr, nullptr, nullptr, transformedKernel.data(), &transformedKernelSize,
+						activation, nullptr,
+						nnp_convolution_pooling_none,
+						nullptr);
+				}
 				ASSERT_EQ(nnp_status_success, status);
 			}
 
@@ -437,19 +812,53 @@ public:
 				kernelData = transformedKernel.data();
 			}
 
+			const char* kernelFilePath = "convolution-inference-kernel.bin";
+			const void* mappedKernel = nullptr;
+			size_t mappedKernelSize = 0;
+			if (kernelFile()) {
+				enum nnp_status status = nnp_convolution_inference_save_kernel(
+					kernelFilePath, algorithm,
+					inputChannels(), outputChannels(), kernelSize(), outputSubsampling(),
+					transformedKernel.data(), transformedKernel.size());
+				ASSERT_EQ(nnp_status_success, status);
+
+				status = nnp_convolution_inference_load_kernel(
+					kernelFilePath, algorithm,
+					inputChannels(), outputChannels() + 1, kernelSize(), outputSubsampling(),
+					&mappedKernel, &mappedKernelSize);
+				ASSERT_EQ(nnp_status_invalid_kernel_file, status);
+
+				status = nnp_convolution_inference_load_kernel(
+					kernelFilePath, algorithm,
+					inputChannels(), outputChannels(), kernelSize(), outputSubsampling(),
+					&mappedKernel, &mappedKernelSize);
+				ASSERT_EQ(nnp_status_success, status);
+				ASSERT_EQ(transformedKernel.size(), mappedKernelSize);
+				kernelData = mappedKernel;
+			}
+
 			enum nnp_status status = nnp_convolution_inference(
 				algorithm,
 				precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
 				inputChannels(), outputChannels(),
 				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
-				input.data(), static_cast<const float*>(kernelData), bias.data(), output.data(),
+				input.data(), static_cast<const float*>(kernelData),
+				batchNorm() ? foldedBias.data() : bias.data(),
+				residual() ? residualInput.data() : nullptr,
+				output.data(),
 				scratchSize == 0 ? nullptr : scratchBuffer.data(),
 				scratchSize == 0 ? nullptr : &scratchSize,
 				activation, nullptr,
+				pooling(),
 			    nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
-			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+			if (kernelFile()) {
+				ASSERT_EQ(nnp_status_success, nnp_convolution_inference_unload_kernel(mappedKernel, mappedKernelSize));
+				std::remove(kernelFilePath);
+			}
+
+			const float maxError = std::inner_product(referencePooledOutput.cbegin(), referencePooledOutput.cend(), output.cbegin(), 0.0f,
 				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
 			maxErrors.push_back(maxError);
 		}
@@ -457,7 +866,242 @@ public:
 		EXPECT_LT(median(maxErrors), errorLimit());
 	}
 
+	void testInferenceQuery(enum nnp_convolution_algorithm algorithm, bool precompute = false) const {
+		const nnp_convolution_transform_strategy transformStrategy =
+			precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute;
+
+		nnp_convolution_info info;
+		enum nnp_status status = nnp_convolution_inference_query(
+			algorithm, transformStrategy,
+			inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nnp_activation_identity, pooling(),
+			&info);
+		ASSERT_EQ(nnp_status_success, status);
+		ASSERT_NE(nnp_convolution_algorithm_auto, info.algorithm);
+		if (algorithm != nnp_convolution_algorithm_auto) {
+			ASSERT_EQ(algorithm, info.algorithm);
+		}
+
+		size_t scratchSize = 0;
+		status = nnp_convolution_inference(
+			info.algorithm, transformStrategy,
+			inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			nnp_activation_identity, nullptr,
+			pooling(),
+			nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+		EXPECT_EQ(scratchSize, info.workspace_size);
+
+		EXPECT_GT(info.input_channels_block_max, 0);
+		EXPECT_GT(info.tiles_block_max, 0);
+		EXPECT_GT(info.output_channels_block_max, 0);
+		EXPECT_GT(info.gemm_flops, 0.0);
+		EXPECT_GE(info.transform_flops, 0.0);
+		EXPECT_GT(info.memory_bytes, 0.0);
+
+		if (info.tiles_count != 0) {
+			ASSERT_GE(info.tile_size.height, kernelHeight());
+			ASSERT_GE(info.tile_size.width, kernelWidth());
+			size_t outputTileHeight = (info.tile_size.height - kernelHeight()) / outputSubsampling().height + 1;
+			size_t outputTileWidth = (info.tile_size.width - kernelWidth()) / outputSubsampling().width + 1;
+			if (pooling() != nnp_convolution_pooling_none) {
+				outputTileHeight &= ~size_t(1);
+				outputTileWidth &= ~size_t(1);
+			}
+			EXPECT_EQ(
+				((outputHeight() + outputTileHeight - 1) / outputTileHeight) * ((outputWidth() + outputTileWidth - 1) / outputTileWidth),
+				info.tiles_count);
+		}
+	}
+
+	void testInferenceSelection(enum nnp_convolution_algorithm expectedAlgorithm, bool precompute = false) const {
+		const nnp_convolution_transform_strategy transformStrategy =
+			precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute;
+
+		nnp_convolution_info info;
+		enum nnp_status status = nnp_convolution_inference_query(
+			nnp_convolution_algorithm_auto, transformStrategy,
+			inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nnp_activation_identity, pooling(),
+			&info);
+		ASSERT_EQ(nnp_status_success, status);
+		ASSERT_EQ(expectedAlgorithm, info.algorithm);
+
+		/* The selection must not depend on the workspace: a buffer too small for the selected algorithm is rejected */
+		size_t expectedWorkspaceSize = 0;
+		status = nnp_convolution_inference(
+			expectedAlgorithm, transformStrategy,
+			inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &expectedWorkspaceSize,
+			nnp_activation_identity, nullptr,
+			pooling(),
+			nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+		ASSERT_EQ(expectedWorkspaceSize, info.workspace_size);
+
+		if (expectedWorkspaceSize > 1) {
+			std::vector<float> input(inputChannels() * inputHeight() * inputWidth());
+			std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+			std::vector<float> bias(outputChannels());
+			std::vector<float> output(outputChannels() * pooledHeight() * pooledWidth());
+			std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(expectedWorkspaceSize);
+
+			size_t scratchSize = 1;
+			status = nnp_convolution_inference(
+				nnp_convolution_algorithm_auto, transformStrategy,
+				inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), nullptr, output.data(),
+				scratchBuffer.data(), &scratchSize,
+				nnp_activation_identity, nullptr,
+				pooling(),
+				nullptr);
+			ASSERT_EQ(nnp_status_insufficient_buffer, status);
+		}
+	}
+
+	void testInferenceQ8(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity) const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
+		std::mt19937 mt(seed);
+		auto inputRng = std::bind(std::uniform_int_distribution<int>(0, 255), std::ref(mt));
+		auto kernelRng = std::bind(std::uniform_int_distribution<int>(-127, 127), std::ref(mt));
+		auto biasRng = std::bind(std::uniform_int_distribution<int32_t>(-10000, 10000), std::ref(mt));
+
+		std::vector<uint8_t> input(inputChannels() * inputHeight() * inputWidth());
+		std::vector<int8_t> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+		std::vector<int32_t> bias(outputChannels());
+		std::vector<float> scale(outputChannels());
+
+		std::vector<uint8_t> output(outputChannels() * outputHeight() * outputWidth());
+		std::vector<uint8_t> referenceOutput(outputChannels() * outputHeight() * outputWidth());
+
+		const uint8_t inputZeroPoint = 127;
+		const uint8_t outputZeroPoint = 100;
+		const uint8_t outputMin = 10;
+		const uint8_t outputMax = 240;
+
+		size_t scratchSize = 0;
+		enum nnp_status status = nnp_convolution_inference_q8(
+			algorithm,
+			inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, inputZeroPoint, nullptr, nullptr, nullptr, outputZeroPoint, outputMin, outputMax,
+			nullptr, nullptr, &scratchSize,
+			activation, nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+
+		/* Scale accumulators so that the output roughly spans the quantized range */
+		const float reductionSize = float(inputChannels() * kernelHeight() * kernelWidth());
+		const float baseScale = 64.0f / (127.0f * 128.0f * std::sqrt(reductionSize));
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), [&inputRng]() -> uint8_t { return uint8_t(inputRng()); });
+			std::generate(kernel.begin(), kernel.end(), [&kernelRng]() -> int8_t { return int8_t(kernelRng()); });
+			std::generate(bias.begin(), bias.end(), std::ref(biasRng));
+			for (size_t outputChannel = 0; outputChannel < outputChannels(); outputChannel++) {
+				scale[outputChannel] = baseScale * (1.0f + 0.25f * float(outputChannel % 4));
+			}
+			std::fill(output.begin(), output.end(), 0xA5);
+			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
+
+			const int32_t clampMin = activation == nnp_activation_relu ? std::max<int32_t>(outputMin, outputZeroPoint) : outputMin;
+			for (size_t outputChannel = 0; outputChannel < outputChannels(); outputChannel++) {
+				for (size_t y = 0; y < outputHeight(); y++) {
+					for (size_t x = 0; x < outputWidth(); x++) {
+						int32_t accumulator = bias[outputChannel];
+						for (size_t inputChannel = 0; inputChannel < inputChannels(); inputChannel++) {
+							for (size_t i = 0; i < kernelHeight(); i++) {
+								const size_t s = y * outputSubsampling().height + i - inputPadding().top;
+								for (size_t j = 0; j < kernelWidth(); j++) {
+									const size_t t = x * outputSubsampling().width + j - inputPadding().left;
+									if (s < inputHeight() && t < inputWidth()) {
+										accumulator +=
+											(int32_t(input[(inputChannel * inputHeight() + s) * inputWidth() + t]) - int32_t(inputZeroPoint)) *
+											int32_t(kernel[((outputChannel * inputChannels() + inputChannel) * kernelHeight() + i) * kernelWidth() + j]);
+									}
+								}
+							}
+						}
+						const int32_t value = int32_t(std::lrint(double(accumulator) * double(scale[outputChannel]))) + int32_t(outputZeroPoint);
+						referenceOutput[(outputChannel * outputHeight() + y) * outputWidth() + x] =
+							uint8_t(std::min<int32_t>(std::max<int32_t>(value, clampMin), outputMax));
+					}
+				}
+			}
+
+			enum nnp_status status = nnp_convolution_inference_q8(
+				algorithm,
+				inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), inputZeroPoint, kernel.data(), bias.data(), scale.data(),
+				outputZeroPoint, outputMin, outputMax,
+				output.data(),
+				scratchSize == 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 ? nullptr : &scratchSize,
+				activation, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); },
+				[](uint8_t reference, uint8_t actual)->float { return std::abs(float(reference) - float(actual)); });
+			maxErrors.push_back(maxError);
+		}
+
+		/* Requantization is exact in double precision, so outputs must match bit for bit */
+		EXPECT_EQ(0.0f, *std::max_element(maxErrors.cbegin(), maxErrors.cend()));
+	}
+
 private:
+	/* Sets the thread pool size for its lifetime; 0 keeps the default */
+	class ThreadsOverride {
+	public:
+		explicit ThreadsOverride(size_t threads) {
+			pthreadpool_set_threads_count(threads);
+		}
+
+		~ThreadsOverride() {
+			pthreadpool_set_threads_count(0);
+		}
+	};
+
+	/* Pretends the machine has the given number of processor packages for its lifetime; 0 keeps the detected ones */
+	class PackagesOverride {
+	public:
+		explicit PackagesOverride(size_t packages) :
+			packagesCount_(nnp_hwinfo.packages_count)
+		{
+			std::copy(nnp_hwinfo.packages, nnp_hwinfo.packages + NNP_MAX_PACKAGES, this->packages_);
+			if (packages != 0) {
+				/* Copies of the first package, without processors to bind threads to */
+				nnp_hwinfo.packages_count = uint32_t(std::min<size_t>(packages, NNP_MAX_PACKAGES));
+				for (size_t package = 0; package < NNP_MAX_PACKAGES; package++) {
+					nnp_hwinfo.packages[package] = this->packages_[0];
+					nnp_hwinfo.packages[package].processor_start = 0;
+					nnp_hwinfo.packages[package].processor_count = 0;
+				}
+			}
+		}
+
+		~PackagesOverride() {
+			nnp_hwinfo.packages_count = this->packagesCount_;
+			std::copy(this->packages_, this->packages_ + NNP_MAX_PACKAGES, nnp_hwinfo.packages);
+		}
+
+	private:
+		uint32_t packagesCount_;
+		struct package_info packages_[NNP_MAX_PACKAGES];
+	};
+
 	inline static float relativeError(float reference, float actual) {
 		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
 	}
@@ -470,6 +1114,15 @@ private:
 	size_t iterations_;
 	float errorLimit_;
 	bool multithreading_;
+	size_t threads_;
+	size_t packages_;
+	bool residual_;
+	bool accumulate_;
+	bool computeBiasGradient_;
+	bool reuseInputTransform_;
+	enum nnp_convolution_pooling pooling_;
+	bool batchNorm_;
+	bool kernelFile_;
 
 	size_t batchSize_;
 	size_t inputChannels_;
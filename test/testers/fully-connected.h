@@ -22,6 +22,8 @@ public:
 		iterations_(1),
 		errorLimit_(1.0e-5f),
 		multithreading_(false),
+		threads_(0),
+		bias_(false),
 		batchSize_(1),
 		inputChannels_(1),
 		outputChannels_(1)
@@ -35,6 +37,8 @@ public:
 		iterations_(tester.iterations_),
 		errorLimit_(tester.errorLimit_),
 		multithreading_(tester.multithreading_),
+		threads_(tester.threads_),
+		bias_(tester.bias_),
 		batchSize_(tester.batchSize_),
 		inputChannels_(tester.inputChannels_),
 		outputChannels_(tester.outputChannels_)
@@ -77,6 +81,24 @@ public:
 		return this->multithreading_;
 	}
 
+	inline FullyConnectedTester& threads(size_t threads) {
+		this->threads_ = threads;
+		return *this;
+	}
+
+	inline size_t threads() const {
+		return this->threads_;
+	}
+
+	inline FullyConnectedTester& bias(bool bias) {
+		this->bias_ = bias;
+		return *this;
+	}
+
+	inline bool bias() const {
+		return this->bias_;
+	}
+
 	inline FullyConnectedTester& batchSize(size_t batchSize) {
 		this->batchSize_ = batchSize;
 		return *this;
@@ -104,28 +126,51 @@ public:
 		return this->outputChannels_;
 	}
 
-	void testOutput() const {
+	void testOutput(enum nnp_activation activation = nnp_activation_identity, bool precompute = false) const {
 		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
 		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
 
 		std::vector<float> input(batchSize() * inputChannels());
 		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> biasValues(bias() ? outputChannels() : 0);
 
 		std::vector<float> output(batchSize() * outputChannels());
 		std::vector<float> referenceOutput(batchSize() * outputChannels());
 
+		size_t packedKernelSize = 0;
+		if (precompute) {
+			enum nnp_status status = nnp_fully_connected_pack_kernel(
+				inputChannels(), outputChannels(),
+				nullptr, nullptr, &packedKernelSize);
+			ASSERT_EQ(nnp_status_success, status);
+		}
+		std::vector<float> packedKernel(packedKernelSize / sizeof(float));
+
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(input.begin(), input.end(), std::ref(rng));
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			generateBias(biasValues, rng);
 			std::fill(output.begin(), output.end(), std::nanf(""));
 
 			nnp_fully_connected_output_f32__reference(
 				batchSize(), inputChannels(), outputChannels(),
 				input.data(), kernel.data(), referenceOutput.data());
+			applyBiasAndActivation(referenceOutput, biasValues, activation);
+
+			if (precompute) {
+				std::fill(packedKernel.begin(), packedKernel.end(), std::nanf(""));
+				enum nnp_status status = nnp_fully_connected_pack_kernel(
+					inputChannels(), outputChannels(),
+					kernel.data(), packedKernel.data(), &packedKernelSize);
+				ASSERT_EQ(nnp_status_success, status);
+			}
 
 			enum nnp_status status = nnp_fully_connected_output(
+				precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
 				batchSize(), inputChannels(), outputChannels(),
-				input.data(), kernel.data(), output.data(), NULL);
+				input.data(), precompute ? packedKernel.data() : kernel.data(),
+				bias() ? biasValues.data() : nullptr, output.data(),
+				activation, nullptr, nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
 			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
@@ -134,7 +179,88 @@ public:
 		}
 	}
 
-	void testInferenceF32() const {
+	void testInputGradient() const {
+		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> gradOutput(batchSize() * outputChannels());
+		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> kernelTransposed(inputChannels() * outputChannels());
+
+		std::vector<float> gradInput(batchSize() * inputChannels());
+		std::vector<float> referenceGradInput(batchSize() * inputChannels());
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(gradOutput.begin(), gradOutput.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::fill(gradInput.begin(), gradInput.end(), std::nanf(""));
+
+			transpose(kernel, outputChannels(), inputChannels(), kernelTransposed);
+			nnp_fully_connected_output_f32__reference(
+				batchSize(), outputChannels(), inputChannels(),
+				gradOutput.data(), kernelTransposed.data(), referenceGradInput.data());
+
+			enum nnp_status status = nnp_fully_connected_input_gradient(
+				batchSize(), inputChannels(), outputChannels(),
+				gradOutput.data(), kernel.data(), gradInput.data(), nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceGradInput.cbegin(), referenceGradInput.cend(), gradInput.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testKernelGradient() const {
+		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels());
+		std::vector<float> inputTransposed(inputChannels() * batchSize());
+		std::vector<float> gradOutput(batchSize() * outputChannels());
+		std::vector<float> gradOutputTransposed(outputChannels() * batchSize());
+
+		std::vector<float> gradKernel(outputChannels() * inputChannels());
+		std::vector<float> referenceGradKernel(outputChannels() * inputChannels());
+		std::vector<float> gradBias(bias() ? outputChannels() : 0);
+		std::vector<float> referenceGradBias(bias() ? outputChannels() : 0);
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(gradOutput.begin(), gradOutput.end(), std::ref(rng));
+			std::fill(gradKernel.begin(), gradKernel.end(), std::nanf(""));
+			std::fill(gradBias.begin(), gradBias.end(), std::nanf(""));
+
+			transpose(input, batchSize(), inputChannels(), inputTransposed);
+			transpose(gradOutput, batchSize(), outputChannels(), gradOutputTransposed);
+			nnp_fully_connected_output_f32__reference(
+				outputChannels(), batchSize(), inputChannels(),
+				gradOutputTransposed.data(), inputTransposed.data(), referenceGradKernel.data());
+			for (size_t outputChannel = 0; outputChannel < referenceGradBias.size(); outputChannel++) {
+				double sum = 0.0;
+				for (size_t sample = 0; sample < batchSize(); sample++) {
+					sum += gradOutput[sample * outputChannels() + outputChannel];
+				}
+				referenceGradBias[outputChannel] = float(sum);
+			}
+
+			enum nnp_status status = nnp_fully_connected_kernel_gradient(
+				batchSize(), inputChannels(), outputChannels(),
+				input.data(), gradOutput.data(), gradKernel.data(),
+				bias() ? gradBias.data() : nullptr, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceGradKernel.cbegin(), referenceGradKernel.cend(), gradKernel.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+
+			const float maxBiasError = std::inner_product(referenceGradBias.cbegin(), referenceGradBias.cend(), gradBias.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxBiasError, errorLimit());
+		}
+	}
+
+	void testInferenceF32(enum nnp_activation activation = nnp_activation_identity) const {
 		ASSERT_EQ(1, batchSize());
 
 		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
@@ -142,22 +268,66 @@ public:
 
 		std::vector<float> input(inputChannels());
 		std::vector<float> kernel(outputChannels() * inputChannels());
+		std::vector<float> biasValues(bias() ? outputChannels() : 0);
 
 		std::vector<float> output(outputChannels());
 		std::vector<float> referenceOutput(outputChannels());
 
+		const ThreadsOverride threadsOverride(threads());
 		for (size_t iteration = 0; iteration < iterations(); iteration++) {
 			std::generate(input.begin(), input.end(), std::ref(rng));
 			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			generateBias(biasValues, rng);
 			std::fill(output.begin(), output.end(), std::nanf(""));
 
 			nnp_fully_connected_output_f32__reference(
 				1, inputChannels(), outputChannels(),
 				input.data(), kernel.data(), referenceOutput.data());
+			applyBiasAndActivation(referenceOutput, biasValues, activation);
 
 			enum nnp_status status = nnp_fully_connected_inference(
 				inputChannels(), outputChannels(),
-				input.data(), kernel.data(), output.data());
+				input.data(), kernel.data(), bias() ? biasValues.data() : nullptr, output.data(),
+				activation, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
+	void testInferenceF16F32(enum nnp_activation activation = nnp_activation_identity) const {
+		ASSERT_EQ(1, batchSize());
+
+		const uint_fast32_t seed = uint_fast32_t(std::chrono::system_clock::now().time_since_epoch().count());
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		std::vector<float> input(inputChannels());
+		std::vector<uint16_t> kernel(outputChannels() * inputChannels());
+		std::vector<float> kernelF32(outputChannels() * inputChannels());
+		std::vector<float> biasValues(bias() ? outputChannels() : 0);
+
+		std::vector<float> output(outputChannels());
+		std::vector<float> referenceOutput(outputChannels());
+
+		const ThreadsOverride threadsOverride(threads());
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), [&rng] { return fp16_alt_from_fp32_value(rng()); });
+			std::transform(kernel.cbegin(), kernel.cend(), kernelF32.begin(), fp16_alt_to_fp32_value);
+			generateBias(biasValues, rng);
+			std::fill(output.begin(), output.end(), std::nanf(""));
+
+			nnp_fully_connected_output_f32__reference(
+				1, inputChannels(), outputChannels(),
+				input.data(), kernelF32.data(), referenceOutput.data());
+			applyBiasAndActivation(referenceOutput, biasValues, activation);
+
+			enum nnp_status status = nnp_fully_connected_inference_f16f32(
+				inputChannels(), outputChannels(),
+				input.data(), kernel.data(), bias() ? biasValues.data() : nullptr, output.data(),
+				activation, nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
 			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
@@ -169,6 +339,48 @@ public:
 	
 
 private:
+	/* Sets the thread pool size for its lifetime; 0 keeps the default */
+	class ThreadsOverride {
+	public:
+		explicit ThreadsOverride(size_t threads) {
+			pthreadpool_set_threads_count(threads);
+		}
+
+		~ThreadsOverride() {
+			pthreadpool_set_threads_count(0);
+		}
+	};
+
+	/* Odd channels get a bias below -inputChannels(), so that their outputs are always negative before the activation */
+	template <class Generator>
+	void generateBias(std::vector<float>& biasValues, Generator& rng) const {
+		for (size_t outputChannel = 0; outputChannel < biasValues.size(); outputChannel++) {
+			biasValues[outputChannel] = outputChannel % 2 == 0 ? rng() : -(float(inputChannels()) + rng());
+		}
+	}
+
+	void applyBiasAndActivation(std::vector<float>& referenceOutput, const std::vector<float>& biasValues, enum nnp_activation activation) const {
+		const size_t batchSize = referenceOutput.size() / outputChannels();
+		if (!biasValues.empty()) {
+			for (size_t sample = 0; sample < batchSize; sample++) {
+				std::transform(biasValues.cbegin(), biasValues.cend(), referenceOutput.cbegin() + sample * outputChannels(),
+					referenceOutput.begin() + sample * outputChannels(), std::plus<float>());
+			}
+		}
+		if (activation == nnp_activation_relu) {
+			nnp_relu_output__reference(batchSize, outputChannels(),
+				referenceOutput.data(), referenceOutput.data(), 0.0f);
+		}
+	}
+
+	inline static void transpose(const std::vector<float>& matrix, size_t rows, size_t columns, std::vector<float>& transposedMatrix) {
+		for (size_t row = 0; row < rows; row++) {
+			for (size_t column = 0; column < columns; column++) {
+				transposedMatrix[column * rows + row] = matrix[row * columns + column];
+			}
+		}
+	}
+
 	inline static float relativeError(float reference, float actual) {
 		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
 	}
@@ -176,6 +388,8 @@ private:
 	size_t iterations_;
 	float errorLimit_;
 	bool multithreading_;
+	size_t threads_;
+	bool bias_;
 
 	size_t batchSize_;
 	size_t inputChannels_;